@@ -1,12 +1,37 @@
 const frameworks = ['caer', 'kaer', 'tarsier', 'yarp', 'yarp_vqueue'];
 const pipelines = ['mask', 'flow', 'denoised_flow', 'masked_denoised_flow', 'masked_denoised_flow_activity'];
-const experiments_and_repetitions = [['duration', 100], ['latencies', 10]];
-const streams = ['squares', 'street', 'car'];
+const experiments_and_repetitions = [['duration', 100], ['latencies', 10]]; // maximum number of kept trials per cell
+const minimum_repetitions = 5; // a cell (job + framework) is not stopped before this number of kept trials
+const warmup_repetitions = 1; // number of discarded trials at the beginning of each cell
+const target_relative_width = 0.02; // a cell stops once each statistic's confidence interval is narrower than this fraction of its median
+const bootstrap_resamples = 1000; // number of resamples used to estimate the confidence intervals
+const confidence = 0.95; // confidence level of the intervals
+const synthetic_rates = [1, 10, 100]; // event rates of the synthetic streams (Mev/s)
+const synthetic_resolutions = [[304, 240], [640, 480], [1280, 720]]; // sensor sizes of the synthetic streams
+const synthetic_duration = 1; // duration of the synthetic streams (s)
 
 const child_process = require('child_process');
 const fs = require('fs');
 console.log(new Date());
 
+/// synthetic_stream returns the name of the synthetic stream with the given rate and resolution,
+/// and generates the stream in the media directory if it does not exist.
+const synthetic_stream = (rate, width, height) => {
+    const name = `synthetic_${rate}mevs_${width}x${height}`;
+    if (!fs.existsSync(`${__dirname}/media/${name}.es`)) {
+        console.log(`generate ${name}`);
+        child_process.execSync(
+            `${__dirname}/common/build/release/generate --rate ${rate} --duration ${synthetic_duration} --width ${width} --height ${height} ${__dirname}/media/${name}.es`,
+            {stdio: 'inherit'});
+    }
+    return name;
+};
+
+// the flag 'synthetic' replaces the recordings with generated streams, to sweep the event rate and the resolution
+const streams = process.argv.slice(2).includes('synthetic')
+    ? [].concat(...synthetic_resolutions.map(([width, height]) => synthetic_rates.map(rate => synthetic_stream(rate, width, height))))
+    : ['squares', 'street', 'car'];
+
 /// job_to_hashes contains the expected hash values for each job (pipeline + experiment + stream).
 const job_to_hashes = new Map();
 
@@ -22,8 +47,52 @@ const run = task => child_process.execSync(
     `node --max-old-space-size=16384 ${__dirname}/frameworks/${task.framework}/run_task.js ${task.pipeline} ${task.experiment} media/${task.stream}.es`,
     {maxBuffer: 2 ** 30});
 
-// fill and shuffle a list of all tasks (job + framework, repeated).
-const tasks = [];
+/// experiment_to_statistics lists the statistics that must converge for each experiment.
+const experiment_to_statistics = {
+    duration: [['duration', result => result.duration]],
+    latencies: [['p50', result => result.latencies.p50], ['p99', result => result.latencies.p99]],
+};
+
+/// shuffle permutes an array in place (Fisher-Yates).
+const shuffle = array => {
+    for (let index = array.length - 1; index > 0; --index) {
+        const other_index = Math.floor(Math.random() * (index + 1));
+        [array[index], array[other_index]] = [array[other_index], array[index]];
+    }
+    return array;
+};
+
+/// median returns the median of the given values.
+const median = values => {
+    const sorted = values.slice().sort((a, b) => a - b);
+    const middle = Math.floor(sorted.length / 2);
+    return sorted.length % 2 === 1 ? sorted[middle] : (sorted[middle - 1] + sorted[middle]) / 2;
+};
+
+/// bootstrap returns the median of the values and a percentile bootstrap confidence interval on the median.
+const bootstrap = values => {
+    const medians = new Float64Array(bootstrap_resamples);
+    const resample = new Array(values.length);
+    for (let resample_index = 0; resample_index < bootstrap_resamples; ++resample_index) {
+        for (let index = 0; index < values.length; ++index) {
+            resample[index] = values[Math.floor(Math.random() * values.length)];
+        }
+        medians[resample_index] = median(resample);
+    }
+    medians.sort();
+    const tail = (1 - confidence) / 2;
+    return {
+        median: median(values),
+        low: medians[Math.floor(tail * (bootstrap_resamples - 1))],
+        high: medians[Math.ceil((1 - tail) * (bootstrap_resamples - 1))],
+    };
+};
+
+// the flag 'fixed' runs every cell exactly the maximum number of times, without warm-up, as in the original protocol
+const fixed = process.argv.slice(2).includes('fixed');
+
+// list the cells (job + framework), after checking that the frameworks agree on each job's hashes
+const cells = [];
 for (const pipeline of pipelines) {
     for (const [experiment, repetitions] of experiments_and_repetitions) {
         for (const stream of streams) {
@@ -47,23 +116,78 @@ for (const pipeline of pipelines) {
             }
             console.log(hashes_to_string(framework_to_hashes[0]));
             for (const framework of frameworks) {
-                for (let index = 0; index < repetitions; ++index) {
-                    tasks.push({name: `${job}::${framework}::${index}`, job, framework, pipeline, experiment, stream});
-                }
+                cells.push({
+                    name: `${job}::${framework}`,
+                    framework,
+                    pipeline,
+                    experiment,
+                    stream,
+                    warmups: fixed ? 0 : warmup_repetitions,
+                    minimum_repetitions: fixed ? repetitions : Math.min(minimum_repetitions, repetitions),
+                    maximum_repetitions: repetitions,
+                    trials: 0,
+                    values: experiment_to_statistics[experiment].map(() => []),
+                    intervals: null,
+                    converged: false,
+                });
             }
         }
     }
 }
-for (let index = tasks.length - 1; index > 0; --index) {
-    const other_index = Math.floor(Math.random() * (index + 1));
-    [tasks[index], tasks[other_index]] = [tasks[other_index], tasks[index]];
-}
 
-// run the tasks sequentially
-for (const [index, task] of tasks.entries()) {
-    console.log(`${index + 1} / ${tasks.length} ${task.name} ${new Date()}`);
-    fs.writeFileSync(`${__dirname}/results/${task.name}.json`, run(task));
-    global.gc();
+/// is_done returns true if the cell reached its maximum number of trials, or if its intervals are narrow enough.
+/// The intervals are recomputed from all the kept trials on every call past the minimum, so that a done cell
+/// never reports intervals from an earlier round.
+const is_done = cell => {
+    const kept = cell.trials - cell.warmups;
+    if (kept < cell.minimum_repetitions) {
+        return false;
+    }
+    cell.intervals = cell.values.map(bootstrap);
+    cell.converged = cell.intervals.every(
+        interval => interval.high - interval.low <= target_relative_width * Math.abs(interval.median));
+    return cell.converged || kept >= cell.maximum_repetitions;
+};
+
+// run one trial of every active cell per round, in a shuffled order, so that drifts (thermal, background load)
+// affect all the frameworks alike
+let active_cells = cells.slice();
+for (let round = 0; active_cells.length > 0; ++round) {
+    console.log(`round ${round + 1}, ${active_cells.length} / ${cells.length} active cells ${new Date()}`);
+    for (const cell of shuffle(active_cells.slice())) {
+        const output = run(cell);
+        const index = cell.trials - cell.warmups;
+        ++cell.trials;
+        if (index < 0) {
+            console.log(`    ${cell.name}::warmup`);
+        } else {
+            console.log(`    ${cell.name}::${index}`);
+            fs.writeFileSync(`${__dirname}/results/${cell.name}::${index}.json`, output);
+            const result = JSON.parse(output);
+            experiment_to_statistics[cell.experiment].forEach(([, result_to_value], statistic_index) => {
+                cell.values[statistic_index].push(result_to_value(result));
+            });
+        }
+        global.gc();
+    }
+    active_cells = active_cells.filter(cell => {
+        if (!is_done(cell)) {
+            return true;
+        }
+        const statistics = {};
+        experiment_to_statistics[cell.experiment].forEach(([name], statistic_index) => {
+            statistics[name] = cell.intervals[statistic_index];
+        });
+        console.log(`    ${cell.name} done after ${cell.trials - cell.warmups} trials${cell.converged ? '' : ' (not converged)'}`);
+        fs.writeFileSync(`${__dirname}/results/${cell.name}::statistics.json`, JSON.stringify({
+            trials: cell.trials - cell.warmups,
+            warmups: cell.warmups,
+            converged: cell.converged,
+            confidence,
+            statistics,
+        }));
+        return false;
+    });
 }
 
 console.log(new Date());
@@ -3,9 +3,29 @@
 #include "third_party/sepia/source/sepia.hpp"
 #include "third_party/tarsier/source/hash.hpp"
 #include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
 #include <iomanip>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <mutex>
 #include <numeric>
 #include <sstream>
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#endif
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace benchmark {
     ///  time_point_to_uint64 converts a time point to an integer timestamp (in ns).
@@ -24,6 +44,642 @@ namespace benchmark {
         while (std::chrono::high_resolution_clock::now() < time_point) {}
     }
 
+    /// speed_from_string parses a replay speed factor (the stream is replayed speed times faster than real time).
+    inline double speed_from_string(const std::string& value) {
+        const auto speed = std::stod(value);
+        if (!(speed > 0.0)) {
+            throw std::runtime_error("the speed factor must be strictly positive");
+        }
+        return speed;
+    }
+
+    /// dispatch_offset returns the delay (in ns) between the dispatch of the first packet and the dispatch of a packet
+    /// whose timestamp is delta_t us larger, when the stream is replayed speed times faster than real time.
+    inline std::chrono::nanoseconds dispatch_offset(uint64_t delta_t, double speed) {
+        if (speed == 1.0) {
+            return std::chrono::nanoseconds(delta_t * 1000);
+        }
+        return std::chrono::nanoseconds(static_cast<uint64_t>(static_cast<double>(delta_t) * 1000.0 / speed));
+    }
+
+    /// clock reads the time stamp counter and converts it to the time scale of now (in ns).
+    /// The counter is used only on x86 processors whose counter is invariant (constant rate, not stopped in sleep
+    /// states). The conversion factor is calibrated against now when the clock is constructed, which takes about
+    /// 50 ms. On other machines, clock::now calls benchmark::now.
+    class clock {
+        public:
+        clock() : _tsc(false), _ticks_0(0), _time_0(0), _ns_per_tick(0.0) {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+            unsigned int eax = 0;
+            unsigned int ebx = 0;
+            unsigned int ecx = 0;
+            unsigned int edx = 0;
+            if (__get_cpuid(0x80000000, &eax, &ebx, &ecx, &edx) && eax >= 0x80000007
+                && __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) && (edx & (1u << 8)) != 0) {
+                const auto begin = sample();
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                const auto end = sample();
+                if (end.first > begin.first && end.second > begin.second) {
+                    _tsc = true;
+                    _ticks_0 = begin.first;
+                    _time_0 = begin.second;
+                    _ns_per_tick = static_cast<double>(end.second - begin.second)
+                                   / static_cast<double>(end.first - begin.first);
+                }
+            }
+#endif
+        }
+        clock(const clock&) = delete;
+        clock(clock&&) = delete;
+        clock& operator=(const clock&) = delete;
+        clock& operator=(clock&&) = delete;
+        virtual ~clock() {}
+
+        /// now returns the current time (in ns).
+        uint64_t now() const {
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+            if (_tsc) {
+                return _time_0 + static_cast<uint64_t>(static_cast<double>(__rdtsc() - _ticks_0) * _ns_per_tick);
+            }
+#endif
+            return benchmark::now();
+        }
+
+        /// busy_sleep_until spins until now reaches the given time (in ns).
+        /// Readers schedule their packets with it, so that dispatch and arrival times share a time base.
+        void busy_sleep_until(uint64_t time) const {
+            while (now() < time) {}
+        }
+
+        /// tsc returns true if the clock reads the time stamp counter.
+        bool tsc() const {
+            return _tsc;
+        }
+
+        protected:
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+        /// sample reads the counter and now, and keeps the reading with the shortest interval between two counter
+        /// reads, which is the least likely to have been interrupted.
+        static std::pair<uint64_t, uint64_t> sample() {
+            std::pair<uint64_t, uint64_t> result(0, 0);
+            uint64_t minimum_interval = std::numeric_limits<uint64_t>::max();
+            for (std::size_t index = 0; index < 16; ++index) {
+                const auto begin = __rdtsc();
+                const auto time = benchmark::now();
+                const auto end = __rdtsc();
+                if (end - begin < minimum_interval) {
+                    minimum_interval = end - begin;
+                    result = std::make_pair(begin + (end - begin) / 2, time);
+                }
+            }
+            return result;
+        }
+#endif
+
+        bool _tsc;
+        uint64_t _ticks_0;
+        uint64_t _time_0;
+        double _ns_per_tick;
+    };
+
+    /// calibrated_clock returns a clock shared by the program, calibrated on the first call.
+    inline const clock& calibrated_clock() {
+        static const clock result;
+        return result;
+    }
+
+    /// latency_histogram counts latencies (in ns) in logarithmic buckets, similar to HdrHistogram.
+    /// Values smaller than 2^precision are counted exactly. Larger values are counted in buckets whose width is at
+    /// most 2^(1 - precision) times their lower bound (less than 1 % with the default precision).
+    class latency_histogram {
+        public:
+        latency_histogram(uint8_t precision = 8) :
+            _precision(precision),
+            _counts(static_cast<std::size_t>(66 - precision) << (precision - 1), 0),
+            _count(0),
+            _minimum(std::numeric_limits<uint64_t>::max()),
+            _maximum(0),
+            _last(0) {
+            if (precision < 2 || precision > 16) {
+                throw std::logic_error("precision must be in the range [2, 16]");
+            }
+        }
+
+        /// add counts a latency.
+        void add(uint64_t value) {
+            ++_counts[index(value)];
+            ++_count;
+            _minimum = std::min(_minimum, value);
+            _maximum = std::max(_maximum, value);
+            _last = value;
+        }
+
+        /// count returns the number of latencies.
+        uint64_t count() const {
+            return _count;
+        }
+
+        /// maximum returns the largest latency, or 0 if the histogram is empty.
+        uint64_t maximum() const {
+            return _maximum;
+        }
+
+        /// last returns the most recent latency, or 0 if the histogram is empty.
+        /// When events are added in arrival order, it measures the backlog left when the input ended.
+        uint64_t last() const {
+            return _last;
+        }
+
+        /// percentile returns the upper bound of the bucket that contains the given percentile (in the range [0, 100]),
+        /// capped by the largest latency.
+        uint64_t percentile(double percentile) const {
+            if (_count == 0) {
+                return 0;
+            }
+            const auto rank = std::max(
+                static_cast<uint64_t>(1),
+                static_cast<uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(_count))));
+            uint64_t cumulated_count = 0;
+            for (std::size_t bucket = 0; bucket < _counts.size(); ++bucket) {
+                cumulated_count += _counts[bucket];
+                if (cumulated_count >= rank) {
+                    return std::min(upper_bound(bucket), _maximum);
+                }
+            }
+            return _maximum;
+        }
+
+        /// to_json writes the number of latencies, their minimum, their median, their 99th and 99.9th percentiles, their
+        /// maximum and the last latency.
+        void to_json(std::ostream& output) const {
+            output << "{\"count\":" << _count << ",\"min\":" << (_count == 0 ? 0 : _minimum)
+                   << ",\"p50\":" << percentile(50.0) << ",\"p99\":" << percentile(99.0)
+                   << ",\"p99.9\":" << percentile(99.9) << ",\"max\":" << _maximum
+                   << ",\"last\":" << _last << "}";
+        }
+
+        protected:
+        /// index returns the bucket of a value.
+        std::size_t index(uint64_t value) const {
+            if (value < (static_cast<uint64_t>(1) << _precision)) {
+                return static_cast<std::size_t>(value);
+            }
+            uint8_t magnitude = 63;
+            while ((value >> magnitude) == 0) {
+                --magnitude;
+            }
+            const auto shift = static_cast<uint8_t>(magnitude - (_precision - 1));
+            return (static_cast<std::size_t>(shift + 1) << (_precision - 1))
+                   + static_cast<std::size_t>((value >> shift) - (static_cast<uint64_t>(1) << (_precision - 1)));
+        }
+
+        /// upper_bound returns the largest value in a bucket.
+        uint64_t upper_bound(std::size_t bucket) const {
+            const auto half = static_cast<std::size_t>(1) << (_precision - 1);
+            if (bucket < 2 * half) {
+                return static_cast<uint64_t>(bucket);
+            }
+            const auto shift = bucket / half - 1;
+            const auto mantissa = static_cast<uint64_t>(bucket % half + half);
+            return ((mantissa + 1) << shift) - 1;
+        }
+
+        uint8_t _precision;
+        std::vector<uint64_t> _counts;
+        uint64_t _count;
+        uint64_t _minimum;
+        uint64_t _maximum;
+        uint64_t _last;
+    };
+
+    /// perf_counters_enabled_from_environment returns false if the environment variable BENCHMARK_PERF_COUNTERS is 0.
+    inline bool perf_counters_enabled_from_environment() {
+        const auto value = std::getenv("BENCHMARK_PERF_COUNTERS");
+        return value == nullptr || std::string(value) != "0";
+    }
+
+    /// perf_counter counts hardware or software events (for instance cache misses) with perf_event_open, on the
+    /// calling thread and, if inherit is true, on the threads it creates after the construction.
+    /// Hardware events are restricted to user space, software events (for instance context switches) are not.
+    /// A counter constructed with a leader joins the leader's group: the kernel schedules the group's counters
+    /// together, and the leader's start and stop control the whole group.
+    /// The counter is unavailable on other platforms, on Linux machines that restrict or lack performance
+    /// monitoring (for instance most virtual machines), and if BENCHMARK_PERF_COUNTERS is 0.
+    /// available then returns false, and stop returns 0.
+    class perf_counter {
+        public:
+        perf_counter(uint32_t type, uint64_t config, bool inherit = false, const perf_counter* leader = nullptr) :
+            _file_descriptor(-1) {
+#ifdef __linux__
+            if (!perf_counters_enabled_from_environment()) {
+                return;
+            }
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.type = type;
+            attributes.size = sizeof(attributes);
+            attributes.config = config;
+            attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            attributes.disabled = leader == nullptr ? 1 : 0;
+            attributes.inherit = inherit ? 1 : 0;
+            attributes.exclude_kernel = type == PERF_TYPE_SOFTWARE ? 0 : 1;
+            attributes.exclude_hv = 1;
+            _file_descriptor = static_cast<int>(syscall(
+                __NR_perf_event_open, &attributes, 0, -1, leader == nullptr ? -1 : leader->_file_descriptor, 0));
+#else
+            static_cast<void>(type);
+            static_cast<void>(config);
+            static_cast<void>(inherit);
+            static_cast<void>(leader);
+#endif
+        }
+        perf_counter(const perf_counter&) = delete;
+        perf_counter(perf_counter&&) = delete;
+        perf_counter& operator=(const perf_counter&) = delete;
+        perf_counter& operator=(perf_counter&&) = delete;
+        ~perf_counter() {
+#ifdef __linux__
+            if (_file_descriptor >= 0) {
+                close(_file_descriptor);
+            }
+#endif
+        }
+
+        /// available returns false if the counter could not be opened.
+        bool available() const {
+            return _file_descriptor >= 0;
+        }
+
+        /// start resets and enables the counter (and its group if the counter is a leader).
+        void start() {
+#ifdef __linux__
+            if (_file_descriptor >= 0) {
+                ioctl(_file_descriptor, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+                ioctl(_file_descriptor, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+            }
+#endif
+        }
+
+        /// stop disables the counter (and its group if the counter is a leader) and returns the number of events
+        /// since start.
+        uint64_t stop() {
+            uint64_t count = 0;
+#ifdef __linux__
+            if (_file_descriptor >= 0) {
+                ioctl(_file_descriptor, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+                read(count);
+            }
+#endif
+            return count;
+        }
+
+        /// read writes the number of events since start to count, and returns false if the counter is unavailable
+        /// or never ran. The count is scaled if the kernel multiplexed the counter with other events.
+        bool read(uint64_t& count) const {
+#ifdef __linux__
+            if (_file_descriptor < 0) {
+                return false;
+            }
+            std::array<uint64_t, 3> value_enabled_running;
+            if (::read(_file_descriptor, value_enabled_running.data(), sizeof(value_enabled_running))
+                    != static_cast<ssize_t>(sizeof(value_enabled_running))
+                || value_enabled_running[2] == 0) {
+                return false;
+            }
+            count = value_enabled_running[2] == value_enabled_running[1] ?
+                        value_enabled_running[0] :
+                        static_cast<uint64_t>(
+                            static_cast<double>(value_enabled_running[0]) * static_cast<double>(value_enabled_running[1])
+                            / static_cast<double>(value_enabled_running[2]));
+            return true;
+#else
+            static_cast<void>(count);
+            return false;
+#endif
+        }
+
+        protected:
+        int _file_descriptor;
+    };
+
+    /// perf_counters counts cycles, instructions, L1D read misses, LLC read misses, branch misses and context
+    /// switches in a single perf_counter group, so that the hardware counters are scheduled together.
+    /// The counters follow the calling thread and the threads it creates after the construction, hence programs
+    /// must construct them before starting the pipeline's threads (for instance the YARP modules).
+    /// Counters that cannot be opened (see perf_counter) or that never ran are written as null.
+    class perf_counters {
+        public:
+        static constexpr std::size_t size = 6;
+
+        perf_counters() : _leader(nullptr) {
+            _counts.fill(0);
+            _valid.fill(false);
+#ifdef __linux__
+            static const std::array<std::pair<uint32_t, uint64_t>, size> types_and_configs{{
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+                {PERF_TYPE_HW_CACHE,
+                 PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                {PERF_TYPE_HW_CACHE,
+                 PERF_COUNT_HW_CACHE_LL | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+                {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+                {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+            }};
+            for (std::size_t index = 0; index < size; ++index) {
+                _counters[index].reset(
+                    new perf_counter(types_and_configs[index].first, types_and_configs[index].second, true, _leader));
+                if (_leader == nullptr && _counters[index]->available()) {
+                    _leader = _counters[index].get();
+                }
+            }
+#endif
+        }
+        perf_counters(const perf_counters&) = delete;
+        perf_counters(perf_counters&&) = delete;
+        perf_counters& operator=(const perf_counters&) = delete;
+        perf_counters& operator=(perf_counters&&) = delete;
+
+        /// start resets and enables the counters.
+        void start() {
+            if (_leader != nullptr) {
+                _leader->start();
+            }
+        }
+
+        /// stop disables the counters and reads their values since start.
+        void stop() {
+            if (_leader == nullptr) {
+                return;
+            }
+            _leader->stop();
+            for (std::size_t index = 0; index < size; ++index) {
+                _valid[index] = _counters[index]->read(_counts[index]);
+            }
+        }
+
+        /// to_json writes the counters values as an object (null values denote unavailable counters).
+        void to_json(std::ostream& output) const {
+            static const std::array<const char*, size> names{
+                {"cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses", "context_switches"}};
+            output << "{";
+            for (std::size_t index = 0; index < size; ++index) {
+                if (index > 0) {
+                    output << ",";
+                }
+                output << "\"" << names[index] << "\":";
+                if (_valid[index]) {
+                    output << _counts[index];
+                } else {
+                    output << "null";
+                }
+            }
+            output << "}";
+        }
+
+        protected:
+        std::array<std::unique_ptr<perf_counter>, size> _counters;
+        perf_counter* _leader;
+        std::array<uint64_t, size> _counts;
+        std::array<bool, size> _valid;
+    };
+
+    /// trace_capacity_from_environment returns the number of records in each thread's trace ring buffer, read from
+    /// the environment variable BENCHMARK_TRACE_CAPACITY (2^18 by default).
+    inline std::size_t trace_capacity_from_environment() {
+        const auto value = std::getenv("BENCHMARK_TRACE_CAPACITY");
+        if (value == nullptr) {
+            return static_cast<std::size_t>(1) << 18;
+        }
+        const auto capacity = std::stoull(value);
+        if (capacity == 0) {
+            throw std::runtime_error("BENCHMARK_TRACE_CAPACITY must be strictly positive");
+        }
+        return static_cast<std::size_t>(capacity);
+    }
+
+    /// tracer records stage enter and exit times, tagged by packet index, in one ring buffer per thread.
+    /// Tracing is enabled by setting the environment variable BENCHMARK_TRACE to an output filename. The records are
+    /// then written in Chrome's trace event format (chrome://tracing, ui.perfetto.dev) when the tracer is destroyed,
+    /// at program exit. A full ring buffer overwrites its oldest records. When tracing is disabled, emit costs a
+    /// branch. The tracer is shared by the program (see global_tracer), since each thread's ring buffer is found
+    /// through a thread-local pointer.
+    class tracer {
+        public:
+        /// record is a stage enter or exit.
+        struct record {
+            uint64_t time;
+            uint64_t packet;
+            uint32_t stage;
+            bool enter;
+        };
+
+        /// ring holds a thread's most recent records, and the packet that the thread is working on.
+        struct ring {
+            ring(std::size_t capacity, std::size_t thread) : records(capacity), size(0), thread(thread), packet(0) {}
+            std::vector<record> records;
+            uint64_t size;
+            std::size_t thread;
+            uint64_t packet;
+        };
+
+        tracer() : _enabled(false), _capacity(0), _time_0(0) {
+            const auto value = std::getenv("BENCHMARK_TRACE");
+            if (value != nullptr && value[0] != '\0') {
+                _enabled = true;
+                _filename = value;
+                _capacity = trace_capacity_from_environment();
+                _time_0 = calibrated_clock().now();
+            }
+        }
+        tracer(const tracer&) = delete;
+        tracer(tracer&&) = delete;
+        tracer& operator=(const tracer&) = delete;
+        tracer& operator=(tracer&&) = delete;
+        virtual ~tracer() {
+            if (_enabled) {
+                std::ofstream output(_filename);
+                to_json(output);
+            }
+        }
+
+        /// enabled returns true if BENCHMARK_TRACE is set.
+        bool enabled() const {
+            return _enabled;
+        }
+
+        /// stage returns the identifier of the stage with the given name, and registers it on the first call.
+        uint32_t stage(const std::string& name) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            const auto stage = std::find(_stages.begin(), _stages.end(), name);
+            if (stage != _stages.end()) {
+                return static_cast<uint32_t>(std::distance(_stages.begin(), stage));
+            }
+            _stages.push_back(name);
+            return static_cast<uint32_t>(_stages.size() - 1);
+        }
+
+        /// set_packet sets the packet that the calling thread is working on.
+        /// It lets single-threaded frameworks tag every stage with the packet dispatched by the reader.
+        void set_packet(uint64_t packet) {
+            if (_enabled) {
+                thread_ring().packet = packet;
+            }
+        }
+
+        /// packet returns the packet that the calling thread is working on.
+        uint64_t packet() {
+            return _enabled ? thread_ring().packet : 0;
+        }
+
+        /// emit records a stage enter or exit on the calling thread.
+        /// The calling thread's first record allocates its ring buffer.
+        void emit(uint32_t stage, uint64_t packet, bool enter) {
+            if (_enabled) {
+                auto& thread_ring = this->thread_ring();
+                thread_ring.records[thread_ring.size % _capacity] = record{calibrated_clock().now(), packet, stage, enter};
+                ++thread_ring.size;
+            }
+        }
+
+        /// to_json writes the records in Chrome's trace event format, with one track per thread.
+        /// Exits whose enter was overwritten are skipped, so that the spans stay nested.
+        void to_json(std::ostream& output) {
+            std::lock_guard<std::mutex> lock(_mutex);
+            output << "{\"traceEvents\":[";
+            auto first = true;
+            for (const auto& thread_ring : _rings) {
+                std::size_t depth = 0;
+                const auto count = std::min(thread_ring->size, static_cast<uint64_t>(_capacity));
+                for (auto index = thread_ring->size - count; index < thread_ring->size; ++index) {
+                    const auto& record = thread_ring->records[index % _capacity];
+                    if (record.enter) {
+                        ++depth;
+                    } else if (depth == 0) {
+                        continue;
+                    } else {
+                        --depth;
+                    }
+                    const auto time = record.time > _time_0 ? record.time - _time_0 : 0;
+                    if (first) {
+                        first = false;
+                    } else {
+                        output << ",";
+                    }
+                    output << "{\"name\":\"" << _stages[record.stage] << "\",\"ph\":\"" << (record.enter ? "B" : "E")
+                           << "\",\"ts\":" << time / 1000 << "." << std::setfill('0') << std::setw(3) << time % 1000
+                           << std::setfill(' ') << ",\"pid\":0,\"tid\":" << thread_ring->thread
+                           << ",\"args\":{\"packet\":" << record.packet << "}}";
+                }
+            }
+            output << "],\"displayTimeUnit\":\"ns\"}";
+        }
+
+        protected:
+        /// thread_ring returns the calling thread's ring buffer, and allocates it on the first call.
+        ring& thread_ring() {
+            thread_local ring* local_ring = nullptr;
+            if (local_ring == nullptr) {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _rings.emplace_back(new ring(_capacity, _rings.size()));
+                local_ring = _rings.back().get();
+            }
+            return *local_ring;
+        }
+
+        bool _enabled;
+        std::string _filename;
+        std::size_t _capacity;
+        uint64_t _time_0;
+        std::mutex _mutex;
+        std::vector<std::string> _stages;
+        std::vector<std::unique_ptr<ring>> _rings;
+    };
+
+    /// global_tracer returns the tracer shared by the program, created on the first call.
+    /// Stages should be registered (see trace_stage) before the benchmark starts, since creating an enabled tracer
+    /// calibrates the clock.
+    inline tracer& global_tracer() {
+        static tracer result;
+        return result;
+    }
+
+    /// trace_stage returns the identifier of the stage with the given name.
+    inline uint32_t trace_stage(const std::string& name) {
+        return global_tracer().stage(name);
+    }
+
+    /// trace_packet sets the packet that the calling thread is working on.
+    inline void trace_packet(uint64_t packet) {
+        global_tracer().set_packet(packet);
+    }
+
+    /// trace_scope records a stage enter on construction and the matching exit on destruction.
+    class trace_scope final {
+        public:
+        trace_scope(uint32_t stage, uint64_t packet) : _stage(stage), _packet(packet) {
+            global_tracer().emit(_stage, _packet, true);
+        }
+        trace_scope(uint32_t stage) : trace_scope(stage, global_tracer().packet()) {}
+        trace_scope(const trace_scope&) = delete;
+        trace_scope(trace_scope&&) = delete;
+        trace_scope& operator=(const trace_scope&) = delete;
+        trace_scope& operator=(trace_scope&&) = delete;
+        ~trace_scope() {
+            global_tracer().emit(_stage, _packet, false);
+        }
+
+        protected:
+        const uint32_t _stage;
+        const uint64_t _packet;
+    };
+
+    /// reference_width and reference_height are the dimensions of the ATIS sensor used to tune the pipelines.
+    constexpr uint16_t reference_width = 304;
+    constexpr uint16_t reference_height = 240;
+
+    /// rectangle is a region of interest, in pixels.
+    struct rectangle {
+        uint16_t left;
+        uint16_t bottom;
+        uint16_t width;
+        uint16_t height;
+    };
+
+    /// sensor contains the dimensions of a stream and the region of interest of the select_rectangle stages.
+    struct sensor {
+        uint16_t width;
+        uint16_t height;
+        rectangle region;
+    };
+
+    /// scale_to_sensor scales a reference length (along a reference_length wide axis) to a length wide axis.
+    /// The integer division yields the reference length itself on the reference sensor.
+    inline uint16_t scale_to_sensor(uint16_t reference, uint16_t reference_length, uint16_t length) {
+        return static_cast<uint16_t>(
+            (static_cast<uint32_t>(reference) * static_cast<uint32_t>(length)) / reference_length);
+    }
+
+    /// dimensions_to_sensor returns a sensor with the given dimensions.
+    /// The region of interest (102, 70, 100, 100 on the reference sensor) is scaled proportionally.
+    inline sensor dimensions_to_sensor(uint16_t width, uint16_t height) {
+        return {
+            width,
+            height,
+            {scale_to_sensor(102, reference_width, width),
+             scale_to_sensor(70, reference_height, height),
+             scale_to_sensor(100, reference_width, width),
+             scale_to_sensor(100, reference_height, height)}};
+    }
+
+    /// filename_to_sensor reads the dimensions of a sensor from an Event Stream file's header.
+    inline sensor filename_to_sensor(const std::string& filename) {
+        const auto header = sepia::read_header(sepia::filename_to_ifstream(filename));
+        if (header.width == 0 || header.height == 0) {
+            throw std::runtime_error("the Event Stream header of " + filename + " has a null dimension");
+        }
+        return dimensions_to_sensor(header.width, header.height);
+    }
+
     /// flow is the output type of the flow pipelines.
     SEPIA_PACK(struct flow {
         uint64_t t;
@@ -53,6 +709,123 @@ namespace benchmark {
         std::vector<uint64_t> packets_ts;
     };
 
+    /// columnar_packet is a non-owning view of a packet stored in columns.
+    /// Iterating over the view yields sepia::dvs_event values assembled from the columns.
+    class columnar_packet {
+        public:
+        /// iterator reads the columns at a given event index.
+        class iterator {
+            public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = sepia::dvs_event;
+            using difference_type = std::ptrdiff_t;
+            using pointer = const sepia::dvs_event*;
+            using reference = sepia::dvs_event;
+
+            iterator(const columnar_packet& packet, std::size_t index) : _packet(packet), _index(index) {}
+            sepia::dvs_event operator*() const {
+                return _packet.event(_index);
+            }
+            iterator& operator++() {
+                ++_index;
+                return *this;
+            }
+            bool operator==(const iterator& other) const {
+                return _index == other._index;
+            }
+            bool operator!=(const iterator& other) const {
+                return _index != other._index;
+            }
+
+            protected:
+            const columnar_packet& _packet;
+            std::size_t _index;
+        };
+
+        columnar_packet(
+            const uint64_t* ts,
+            const uint16_t* xs,
+            const uint16_t* ys,
+            const uint8_t* is_increases,
+            std::size_t size) :
+            ts(ts),
+            xs(xs),
+            ys(ys),
+            is_increases(is_increases),
+            _size(size) {}
+
+        /// size returns the number of events in the packet.
+        std::size_t size() const {
+            return _size;
+        }
+
+        /// event assembles the event with the given index.
+        sepia::dvs_event event(std::size_t index) const {
+            return sepia::dvs_event{ts[index], xs[index], ys[index], is_increases[index] == 1};
+        }
+
+        /// front returns the first event.
+        sepia::dvs_event front() const {
+            return event(0);
+        }
+
+        /// back returns the last event.
+        sepia::dvs_event back() const {
+            return event(_size - 1);
+        }
+
+        iterator begin() const {
+            return iterator(*this, 0);
+        }
+        iterator end() const {
+            return iterator(*this, _size);
+        }
+
+        /// ts, xs, ys and is_increases point to the packet's first element in each column.
+        const uint64_t* ts;
+        const uint16_t* xs;
+        const uint16_t* ys;
+        const uint8_t* is_increases;
+
+        protected:
+        std::size_t _size;
+    };
+
+    /// columnar_event_stream contains the same packets as event_stream in a single contiguous arena per field.
+    /// Packets are ranges of event indices rather than separate allocations.
+    struct columnar_event_stream {
+        /// ts, xs, ys and is_increases contain the events' fields, packet after packet.
+        std::vector<uint64_t> ts;
+        std::vector<uint16_t> xs;
+        std::vector<uint16_t> ys;
+        std::vector<uint8_t> is_increases;
+
+        /// packets_offsets contains the index of each packet's first event, followed by number_of_events.
+        std::vector<std::size_t> packets_offsets;
+
+        /// number_of_events is the total number of events.
+        std::size_t number_of_events;
+
+        /// packets_ts contains each packet's last event timestamp.
+        std::vector<uint64_t> packets_ts;
+
+        /// number_of_packets returns the number of packets.
+        std::size_t number_of_packets() const {
+            return packets_ts.size();
+        }
+
+        /// packet returns a view of the packet with the given index.
+        columnar_packet packet(std::size_t index) const {
+            const auto offset = packets_offsets[index];
+            return columnar_packet(
+                ts.data() + offset,
+                xs.data() + offset,
+                ys.data() + offset,
+                is_increases.data() + offset,
+                packets_offsets[index + 1] - offset);
+        }
+    };
+
     /// hash_events calculates the MurmurHash3 (128 bits, x64 version).
     template <typename Uint, typename EventIterator, typename EventToUint>
     std::string hash_events(EventIterator begin, EventIterator end, EventToUint event_to_uint) {
@@ -71,23 +844,266 @@ namespace benchmark {
         return result;
     }
 
+    /// murmur3 calculates the MurmurHash3 (128 bits, x64 version) of 64-bit values, like hash_events.
+    /// Its operator() is not virtual, and to_json can be called at any time, so that several columns can be hashed in
+    /// a single pass over the events.
+    class murmur3 {
+        public:
+        murmur3() : _block_0(0), _hash{0, 0}, _size(0), _half(false) {}
+        murmur3(const murmur3&) = default;
+        murmur3(murmur3&&) = default;
+        murmur3& operator=(const murmur3&) = default;
+        murmur3& operator=(murmur3&&) = default;
+        ~murmur3() {}
+
+        /// operator() handles a value.
+        void operator()(uint64_t value) {
+            if (_half) {
+                _half = false;
+                ++_size;
+                _hash[0] ^= mix_block_0(_block_0);
+                _hash[0] = rotate(_hash[0], 27);
+                _hash[0] += _hash[1];
+                _hash[0] = _hash[0] * 5 + 0x52dce729;
+                _hash[1] ^= mix_block_1(value);
+                _hash[1] = rotate(_hash[1], 31);
+                _hash[1] += _hash[0];
+                _hash[1] = _hash[1] * 5 + 0x38495ab5;
+            } else {
+                _half = true;
+                _block_0 = value;
+            }
+        }
+
+        /// to_json returns the quoted hexadecimal hash, or an empty string if no values were handled
+        /// (tarsier::hash does not report a hash in this case).
+        std::string to_json() const {
+            if (_size == 0 && !_half) {
+                return std::string();
+            }
+            uint64_t hash[2] = {_hash[0], _hash[1]};
+            if (_half) {
+                hash[0] ^= mix_block_0(_block_0);
+            }
+            hash[0] ^= (_size * 16 + (_half ? 1 : 0));
+            hash[1] ^= (_size * 16 + (_half ? 1 : 0));
+            hash[0] += hash[1];
+            hash[1] += hash[0];
+            hash[0] = mix(hash[0]);
+            hash[1] = mix(hash[1]);
+            hash[0] += hash[1];
+            hash[1] += hash[0];
+            std::stringstream stream;
+            stream << '"' << std::hex << hash[1] << std::hex << std::setfill('0') << std::setw(16) << hash[0] << '"';
+            return stream.str();
+        }
+
+        protected:
+        /// rotate implements a bit-wise rotation.
+        static uint64_t rotate(uint64_t value, uint8_t range) {
+            return (value << range) | (value >> (64 - range));
+        }
+
+        /// mix_block_0 scrambles the lower half of a block.
+        static uint64_t mix_block_0(uint64_t value) {
+            return rotate(value * 0x87c37b91114253d5ull, 31) * 0x4cf5ad432745937full;
+        }
+
+        /// mix_block_1 scrambles the upper half of a block.
+        static uint64_t mix_block_1(uint64_t value) {
+            return rotate(value * 0x4cf5ad432745937full, 33) * 0x87c37b91114253d5ull;
+        }
+
+        /// mix implements a bit-wise mix.
+        static uint64_t mix(uint64_t value) {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ull;
+            value ^= value >> 33;
+            return value;
+        }
+
+        uint64_t _block_0;
+        uint64_t _hash[2];
+        uint64_t _size;
+        bool _half;
+    };
+
+    /// hash_column hashes the values that event_to_uint extracts from each event.
+    /// As with hash_events, the values are widened to 64 bits before hashing, whatever their type.
+    template <typename EventToUint>
+    class hash_column {
+        public:
+        hash_column(EventToUint event_to_uint) : _event_to_uint(std::forward<EventToUint>(event_to_uint)) {}
+
+        /// operator() handles an event.
+        template <typename Event>
+        void operator()(const Event& event) {
+            _murmur3(static_cast<uint64_t>(_event_to_uint(event)));
+        }
+
+        /// to_json returns the column's hash.
+        std::string to_json() const {
+            return _murmur3.to_json();
+        }
+
+        protected:
+        EventToUint _event_to_uint;
+        murmur3 _murmur3;
+    };
+
+    /// make_hash_column creates a hash column from a functor.
+    template <typename EventToUint>
+    inline hash_column<EventToUint> make_hash_column(EventToUint event_to_uint) {
+        return hash_column<EventToUint>(std::forward<EventToUint>(event_to_uint));
+    }
+
+    /// count_column counts the events for which is_counted returns true.
+    template <typename IsCounted>
+    class count_column {
+        public:
+        count_column(IsCounted is_counted) : _is_counted(std::forward<IsCounted>(is_counted)), _count(0) {}
+
+        /// operator() handles an event.
+        template <typename Event>
+        void operator()(const Event& event) {
+            _count += _is_counted(event) ? 1 : 0;
+        }
+
+        /// to_json returns the count.
+        std::string to_json() const {
+            return std::to_string(_count);
+        }
+
+        protected:
+        IsCounted _is_counted;
+        std::size_t _count;
+    };
+
+    /// make_count_column creates a count column from a functor.
+    template <typename IsCounted>
+    inline count_column<IsCounted> make_count_column(IsCounted is_counted) {
+        return count_column<IsCounted>(std::forward<IsCounted>(is_counted));
+    }
+
+    /// column_to_json feeds the events to a single column, and returns its JSON value.
+    template <typename EventIterator, typename Column>
+    std::string column_to_json(EventIterator begin, EventIterator end, Column column) {
+        for (; begin != end; ++begin) {
+            column(*begin);
+        }
+        return column.to_json();
+    }
+
+    /// minimum_parallel_columns_size is the number of events above which columns_to_json hashes each column on its
+    /// own thread.
+    constexpr std::size_t minimum_parallel_columns_size = 1 << 22;
+
+    /// columns_to_json writes the JSON values of the given columns, separated by commas.
+    /// Small outputs are read once, and each event updates every column. The columns' states are independent, so
+    /// the processor overlaps their updates. Outputs larger than minimum_parallel_columns_size are read once per
+    /// column instead, with one thread per column.
+    template <typename EventIterator, typename... Columns>
+    void columns_to_json(std::ostream& output, EventIterator begin, EventIterator end, Columns... columns) {
+        std::vector<std::string> values;
+        if (static_cast<std::size_t>(std::distance(begin, end)) >= minimum_parallel_columns_size
+            && std::thread::hardware_concurrency() > 1) {
+            std::future<std::string> futures[] = {std::async(
+                std::launch::async,
+                column_to_json<EventIterator, Columns>,
+                begin,
+                end,
+                std::move(columns))...};
+            for (auto& future : futures) {
+                values.push_back(future.get());
+            }
+        } else {
+            for (; begin != end; ++begin) {
+                const int handled[] = {(columns(*begin), 0)...};
+                static_cast<void>(handled);
+            }
+            values = {columns.to_json()...};
+        }
+        for (std::size_t index = 0; index < values.size(); ++index) {
+            if (index > 0) {
+                output << ",";
+            }
+            output << values[index];
+        }
+    }
+
+    /// float_to_uint32 returns the bits of a float.
+    inline uint32_t float_to_uint32(float value) {
+        uint32_t result;
+        std::memcpy(&result, &value, sizeof(uint32_t));
+        return result;
+    }
+
+    /// events_columns_to_json writes the number of increase events and the hashes of t, x and y.
+    inline void events_columns_to_json(std::ostream& output, const std::vector<sepia::dvs_event>& events) {
+        columns_to_json(
+            output,
+            events.begin(),
+            events.end(),
+            make_count_column([](sepia::dvs_event event) { return event.is_increase; }),
+            make_hash_column([](sepia::dvs_event event) { return event.t; }),
+            make_hash_column([](sepia::dvs_event event) { return event.x; }),
+            make_hash_column([](sepia::dvs_event event) { return event.y; }));
+    }
+
+    /// flows_columns_to_json writes the hashes of t, vx, vy, x and y.
+    inline void flows_columns_to_json(std::ostream& output, const std::vector<flow>& flows) {
+        columns_to_json(
+            output,
+            flows.begin(),
+            flows.end(),
+            make_hash_column([](flow event) { return event.t; }),
+            make_hash_column([](flow event) { return float_to_uint32(event.vx); }),
+            make_hash_column([](flow event) { return float_to_uint32(event.vy); }),
+            make_hash_column([](flow event) { return event.x; }),
+            make_hash_column([](flow event) { return event.y; }));
+    }
+
+    /// activities_columns_to_json writes the hashes of t, potential, x and y.
+    inline void activities_columns_to_json(std::ostream& output, const std::vector<activity>& activities) {
+        columns_to_json(
+            output,
+            activities.begin(),
+            activities.end(),
+            make_hash_column([](activity event) { return event.t; }),
+            make_hash_column([](activity event) { return float_to_uint32(event.potential); }),
+            make_hash_column([](activity event) { return event.x; }),
+            make_hash_column([](activity event) { return event.y; }));
+    }
+
+    /// starts_packet returns true if an event with timestamp t must start a new packet, given the current packet's size
+    /// and first timestamp. Packets contain up to 5000 events, with up to 10000 us between the first and the last.
+    inline bool starts_packet(std::size_t packet_size, uint64_t packet_begin_t, uint64_t t) {
+        return packet_size >= 5000 || t >= packet_begin_t + 10000;
+    }
+
     /// filename_to_event_stream returns packets and pre-calculated timestamps.
+    /// The file is decoded in parallel, using the index file next to it (the latter is created if needed).
     inline event_stream filename_to_event_stream(const std::string& filename) {
         event_stream result{{}, 0, {}};
         result.packets.emplace_back();
-        sepia::join_observable<sepia::type::dvs>(
-            sepia::filename_to_ifstream(filename),
-            [&](sepia::dvs_event event) {
-                ++result.number_of_events;
-                auto& events = result.packets.back();
-                if (events.empty()) {
-                    events.push_back(event);
-                } else {
-                    if (events.size() >= 5000 || event.t >= events.front().t + 10000) {
-                        result.packets_ts.push_back(events.back().t);
-                        result.packets.push_back(std::vector<sepia::dvs_event>{event});
-                    } else {
+        sepia::join_parallel_batch_observable<sepia::type::dvs>(
+            filename,
+            sepia::load_index<sepia::type::dvs>(filename),
+            [&](const std::vector<sepia::dvs_event>& decoded_events) {
+                result.number_of_events += decoded_events.size();
+                for (const auto& event : decoded_events) {
+                    auto& events = result.packets.back();
+                    if (events.empty()) {
                         events.push_back(event);
+                    } else {
+                        if (starts_packet(events.size(), events.front().t, event.t)) {
+                            result.packets_ts.push_back(events.back().t);
+                            result.packets.push_back(std::vector<sepia::dvs_event>{event});
+                        } else {
+                            events.push_back(event);
+                        }
                     }
                 }
             });
@@ -95,131 +1111,696 @@ namespace benchmark {
         return result;
     }
 
+    /// filename_to_columnar_event_stream returns packets in columns and pre-calculated timestamps.
+    /// Packets follow the same rules as filename_to_event_stream.
+    inline columnar_event_stream filename_to_columnar_event_stream(const std::string& filename) {
+        columnar_event_stream result{{}, {}, {}, {}, {0}, 0, {}};
+        {
+            const auto maximum_number_of_events = static_cast<std::size_t>(sepia::file_size(filename) / 5);
+            result.ts.reserve(maximum_number_of_events);
+            result.xs.reserve(maximum_number_of_events);
+            result.ys.reserve(maximum_number_of_events);
+            result.is_increases.reserve(maximum_number_of_events);
+        }
+        uint64_t packet_begin_t = 0;
+        sepia::join_parallel_batch_observable<sepia::type::dvs>(
+            filename,
+            sepia::load_index<sepia::type::dvs>(filename),
+            [&](const std::vector<sepia::dvs_event>& decoded_events) {
+                for (const auto& event : decoded_events) {
+                    if (result.number_of_events == 0) {
+                        packet_begin_t = event.t;
+                    } else if (starts_packet(
+                                   result.number_of_events - result.packets_offsets.back(), packet_begin_t, event.t)) {
+                        result.packets_ts.push_back(result.ts.back());
+                        result.packets_offsets.push_back(result.number_of_events);
+                        packet_begin_t = event.t;
+                    }
+                    result.ts.push_back(event.t);
+                    result.xs.push_back(event.x);
+                    result.ys.push_back(event.y);
+                    result.is_increases.push_back(event.is_increase ? 1 : 0);
+                    ++result.number_of_events;
+                }
+            });
+        result.packets_ts.push_back(result.ts.back());
+        result.packets_offsets.push_back(result.number_of_events);
+        return result;
+    }
+
+    /// packet_stream decodes and packetizes an Event Stream file on a producer thread which runs ahead of the consumer.
+    /// Packets follow the same rules as filename_to_event_stream, and are exchanged through a bounded ring, hence memory
+    /// usage does not depend on the recording's duration. The time spent by the consumer waiting for the producer is
+    /// measured, so that decoding costs are reported rather than silently mixed into pipeline timings.
+    /// The constructor counts events and packets beforehand with sepia::join_parallel_batch_observable, which bounds
+    /// the number of decoded segments held in memory.
+    class packet_stream {
+        public:
+        packet_stream(const std::string& filename, std::size_t capacity = 256) :
+            _filename(filename),
+            _slots(capacity < 2 ? 2 : capacity),
+            _number_of_events(0),
+            _number_of_packets(0),
+            _head(0),
+            _tail(0),
+            _done(false),
+            _running(true),
+            _holding(false),
+            _stalls(0),
+            _stalled_duration(0) {
+            {
+                std::size_t packet_size = 0;
+                uint64_t packet_begin_t = 0;
+                uint64_t previous_t = 0;
+                sepia::join_parallel_batch_observable<sepia::type::dvs>(
+                    _filename,
+                    sepia::load_index<sepia::type::dvs>(_filename),
+                    [&](const std::vector<sepia::dvs_event>& events) {
+                        _number_of_events += events.size();
+                        for (const auto& event : events) {
+                            if (packet_size == 0 || starts_packet(packet_size, packet_begin_t, event.t)) {
+                                if (packet_size > 0) {
+                                    _packets_ts.push_back(previous_t);
+                                }
+                                ++_number_of_packets;
+                                packet_size = 0;
+                                packet_begin_t = event.t;
+                            }
+                            ++packet_size;
+                            previous_t = event.t;
+                        }
+                    });
+                if (packet_size > 0) {
+                    _packets_ts.push_back(previous_t);
+                }
+            }
+            _producer = std::thread([this]() {
+                try {
+                    std::size_t tail = 0;
+                    sepia::join_batch_observable<sepia::type::dvs>(
+                        _filename, [&](const std::vector<sepia::dvs_event>& events) {
+                            for (const auto& event : events) {
+                                auto* packet = &_slots[tail % _slots.size()];
+                                if (!packet->empty() && starts_packet(packet->size(), packet->front().t, event.t)) {
+                                    ++tail;
+                                    _tail.store(tail, std::memory_order_release);
+                                    while (tail - _head.load(std::memory_order_acquire) >= _slots.size()) {
+                                        if (!_running.load(std::memory_order_relaxed)) {
+                                            throw stopped();
+                                        }
+                                        std::this_thread::yield();
+                                    }
+                                    packet = &_slots[tail % _slots.size()];
+                                    packet->clear();
+                                }
+                                packet->push_back(event);
+                            }
+                        });
+                    if (!_slots[tail % _slots.size()].empty()) {
+                        _tail.store(tail + 1, std::memory_order_release);
+                    }
+                } catch (const stopped&) {
+                } catch (...) {
+                    _exception = std::current_exception();
+                }
+                _done.store(true, std::memory_order_release);
+            });
+        }
+        packet_stream(const packet_stream&) = delete;
+        packet_stream(packet_stream&&) = delete;
+        packet_stream& operator=(const packet_stream&) = delete;
+        packet_stream& operator=(packet_stream&&) = delete;
+        virtual ~packet_stream() {
+            _running.store(false, std::memory_order_relaxed);
+            _producer.join();
+        }
+
+        /// number_of_events returns the total number of events.
+        std::size_t number_of_events() const {
+            return _number_of_events;
+        }
+
+        /// number_of_packets returns the total number of packets.
+        std::size_t number_of_packets() const {
+            return _number_of_packets;
+        }
+
+        /// packets_ts returns each packet's last event timestamp, calculated before decoding starts.
+        const std::vector<uint64_t>& packets_ts() const {
+            return _packets_ts;
+        }
+
+        /// fill blocks until the ring is full or the file is entirely decoded.
+        /// It should be called before starting the timer, so that the producer gets a head start.
+        void fill() {
+            while (_tail.load(std::memory_order_acquire) - _head.load(std::memory_order_relaxed) < _slots.size()
+                   && !_done.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+        }
+
+        /// next returns the next packet, or nullptr after the last one.
+        /// The packet remains valid until the next call. Producer exceptions are rethrown after the last packet.
+        const std::vector<sepia::dvs_event>* next() {
+            auto head = _head.load(std::memory_order_relaxed);
+            if (_holding) {
+                ++head;
+                _head.store(head, std::memory_order_release);
+                _holding = false;
+            }
+            if (_tail.load(std::memory_order_acquire) == head) {
+                const auto begin_t = now();
+                for (;;) {
+                    const auto done = _done.load(std::memory_order_acquire);
+                    if (_tail.load(std::memory_order_acquire) != head) {
+                        break;
+                    }
+                    if (done) {
+                        _stalled_duration += now() - begin_t;
+                        if (_exception) {
+                            std::rethrow_exception(_exception);
+                        }
+                        return nullptr;
+                    }
+                    std::this_thread::yield();
+                }
+                _stalled_duration += now() - begin_t;
+                ++_stalls;
+            }
+            _holding = true;
+            return &_slots[head % _slots.size()];
+        }
+
+        /// stalls returns the number of packets for which the consumer had to wait.
+        std::size_t stalls() const {
+            return _stalls;
+        }
+
+        /// stalled_duration returns the time spent by the consumer waiting for the producer (in ns).
+        uint64_t stalled_duration() const {
+            return _stalled_duration;
+        }
+
+        protected:
+        /// stopped is thrown in the producer thread when the stream is destroyed before the end of the file.
+        struct stopped {};
+
+        const std::string _filename;
+        std::vector<std::vector<sepia::dvs_event>> _slots;
+        std::size_t _number_of_events;
+        std::size_t _number_of_packets;
+        std::vector<uint64_t> _packets_ts;
+        std::atomic<std::size_t> _head;
+        std::atomic<std::size_t> _tail;
+        std::atomic_bool _done;
+        std::atomic_bool _running;
+        bool _holding;
+        std::size_t _stalls;
+        uint64_t _stalled_duration;
+        std::exception_ptr _exception;
+        std::thread _producer;
+    };
+
+    /// stalls_to_json writes a packet stream's stall statistics to the output.
+    inline void stalls_to_json(std::ostream& output, const packet_stream& input_packet_stream) {
+        output << "{\"stalls\":" << input_packet_stream.stalls()
+               << ",\"stalled_duration\":" << input_packet_stream.stalled_duration() << "}";
+    }
+
     /// events_to_json writes the given vector of events to the output.
     /// t is a timestamp or the elapsed time, depending on available information.
     inline void events_to_json(std::ostream& output, uint64_t t, const std::vector<sepia::dvs_event>& events) {
-        output
-            << "["
-            << t << ","
-            << events.size() << ","
-            << std::count_if(events.begin(), events.end(), [](sepia::dvs_event event) { return event.is_increase; }) << ","
-            << hash_events<uint64_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.t; }) << ","
-            << hash_events<uint16_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.x; }) << ","
-            << hash_events<uint16_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.y; }) << "]";
+        output << "[" << t << "," << events.size() << ",";
+        events_columns_to_json(output, events);
+        output << "]";
     }
 
     /// flows_to_json writes the given vector of flow events to the output.
     /// t is a timestamp or the elapsed time, depending on available information.
     inline void flows_to_json(std::ostream& output, uint64_t t, const std::vector<flow>& flows) {
-        output
-            << "["
-            << t << ","
-            << flows.size() << ","
-            << hash_events<uint64_t>(flows.begin(), flows.end(), [](flow event) { return event.t; }) << ","
-            << hash_events<uint32_t>(flows.begin(), flows.end(), [](flow event) {
-                const auto v = event.vx;
-                return *reinterpret_cast<const uint32_t*>(&v);
-            }) << ","
-            << hash_events<uint32_t>(flows.begin(), flows.end(), [](flow event) {
-                const auto v = event.vy;
-                return *reinterpret_cast<const uint32_t*>(&v);
-            }) << ","
-            << hash_events<uint16_t>(flows.begin(), flows.end(), [](flow event) { return event.x; }) << ","
-            << hash_events<uint16_t>(flows.begin(), flows.end(), [](flow event) { return event.y; }) << "]";
+        output << "[" << t << "," << flows.size() << ",";
+        flows_columns_to_json(output, flows);
+        output << "]";
     }
 
     /// activities_to_json writes the given vector of activity events to the output.
     /// time is the wall clock time or the elapsed time (depending on available information) in ns.
     inline void activities_to_json(std::ostream& output, uint64_t time, const std::vector<activity>& activities) {
-        output
-            << "["
-            << time << ","
-            << activities.size() << ","
-            << hash_events<uint64_t>(activities.begin(), activities.end(), [](activity event) { return event.t; }) << ","
-            << hash_events<uint32_t>(activities.begin(), activities.end(), [](activity event) {
-                const auto potential = event.potential;
-                return *reinterpret_cast<const uint32_t*>(&potential);
-            }) << ","
-            << hash_events<uint16_t>(activities.begin(), activities.end(), [](activity event) { return event.x; }) << ","
-            << hash_events<uint16_t>(activities.begin(), activities.end(), [](activity event) { return event.y; }) << "]";
-    }
-
-    /// events_latencies_to_json writes the given vector of events and latencies to the output.
-    /// points is a vector of pairs [t, time], where t is the event timestamp in us,
-    /// and time is the wall clock time or the elapsed time (depending on available information) in ns.
-    inline void events_latencies_to_json(
-        std::ostream& output,
-        const std::vector<sepia::dvs_event>& events,
-        const std::vector<std::pair<uint64_t, uint64_t>>& points) {
-        output
-            << "["
-            << events.size() << ","
-            << std::count_if(events.begin(), events.end(), [](sepia::dvs_event event) { return event.is_increase; }) << ","
-            << hash_events<uint64_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.t; }) << ","
-            << hash_events<uint16_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.x; }) << ","
-            << hash_events<uint16_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.y; }) << ",[";
-        for (std::size_t index = 0; index < points.size(); ++index) {
-            if (index > 0) {
-                output << ",";
-            }
-            output << "[" << points[index].first << ",\"" << points[index].second << "\"]";
+        output << "[" << time << "," << activities.size() << ",";
+        activities_columns_to_json(output, activities);
+        output << "]";
+    }
+
+    /// outputs_columns_to_json writes the columns of the given output events, using the function that matches their
+    /// type.
+    inline void outputs_columns_to_json(std::ostream& output, const std::vector<sepia::dvs_event>& events) {
+        events_columns_to_json(output, events);
+    }
+    inline void outputs_columns_to_json(std::ostream& output, const std::vector<flow>& flows) {
+        flows_columns_to_json(output, flows);
+    }
+    inline void outputs_columns_to_json(std::ostream& output, const std::vector<activity>& activities) {
+        activities_columns_to_json(output, activities);
+    }
+
+    /// output_hash updates the columns' hashes of an output type event by event.
+    /// Its to_json writes the same values as the corresponding *_columns_to_json function.
+    template <typename Event>
+    class output_hash;
+
+    /// output_hash<sepia::dvs_event> counts increase events, and hashes t, x and y.
+    template <>
+    class output_hash<sepia::dvs_event> {
+        public:
+        output_hash() : _increases(0) {}
+
+        /// operator() handles an event.
+        void operator()(sepia::dvs_event event) {
+            _increases += event.is_increase ? 1 : 0;
+            _t(event.t);
+            _x(event.x);
+            _y(event.y);
+        }
+
+        /// to_json writes the count and the hashes.
+        void to_json(std::ostream& output) const {
+            output << _increases << "," << _t.to_json() << "," << _x.to_json() << "," << _y.to_json();
+        }
+
+        protected:
+        std::size_t _increases;
+        murmur3 _t;
+        murmur3 _x;
+        murmur3 _y;
+    };
+
+    /// output_hash<flow> hashes t, vx, vy, x and y.
+    template <>
+    class output_hash<flow> {
+        public:
+        /// operator() handles an event.
+        void operator()(flow event) {
+            _t(event.t);
+            _vx(float_to_uint32(event.vx));
+            _vy(float_to_uint32(event.vy));
+            _x(event.x);
+            _y(event.y);
+        }
+
+        /// to_json writes the hashes.
+        void to_json(std::ostream& output) const {
+            output << _t.to_json() << "," << _vx.to_json() << "," << _vy.to_json() << "," << _x.to_json() << ","
+                   << _y.to_json();
+        }
+
+        protected:
+        murmur3 _t;
+        murmur3 _vx;
+        murmur3 _vy;
+        murmur3 _x;
+        murmur3 _y;
+    };
+
+    /// output_hash<activity> hashes t, potential, x and y.
+    template <>
+    class output_hash<activity> {
+        public:
+        /// operator() handles an event.
+        void operator()(activity event) {
+            _t(event.t);
+            _potential(float_to_uint32(event.potential));
+            _x(event.x);
+            _y(event.y);
+        }
+
+        /// to_json writes the hashes.
+        void to_json(std::ostream& output) const {
+            output << _t.to_json() << "," << _potential.to_json() << "," << _x.to_json() << "," << _y.to_json();
+        }
+
+        protected:
+        murmur3 _t;
+        murmur3 _potential;
+        murmur3 _x;
+        murmur3 _y;
+    };
+
+    /// buffered_sinks is true if BENCHMARK_BUFFERED_SINKS is defined, and makes output_sink keep every output event
+    /// in memory by default. The buffered mode writes the same JSON, and is meant for debugging.
+#ifdef BENCHMARK_BUFFERED_SINKS
+    constexpr bool buffered_sinks = true;
+#else
+    constexpr bool buffered_sinks = false;
+#endif
+
+    /// output_sink verifies the output events of a duration benchmark.
+    /// By default, each event updates running hashes, so that the sink uses constant memory during the timed region.
+    template <typename Event, bool buffered = buffered_sinks>
+    class output_sink {
+        public:
+        output_sink() : _size(0) {}
+
+        /// reserve is a no-op, since the incremental sink does not store events.
+        void reserve(std::size_t) {}
+
+        /// operator() handles an output event.
+        void operator()(Event event) {
+            ++_size;
+            _output_hash(event);
+        }
+
+        /// size returns the number of output events.
+        std::size_t size() const {
+            return _size;
+        }
+
+        /// hashes_to_json writes the number of events and the columns' values.
+        void hashes_to_json(std::ostream& output) const {
+            output << _size << ",";
+            _output_hash.to_json(output);
+        }
+
+        /// to_json writes the duration, the number of events and the columns' values, like events_to_json,
+        /// flows_to_json and activities_to_json.
+        void to_json(std::ostream& output, uint64_t t) const {
+            output << "[" << t << ",";
+            hashes_to_json(output);
+            output << "]";
         }
-        output << "]]";
+
+        /// to_json writes the duration, the number of events, the columns' values and the performance counters.
+        void to_json(std::ostream& output, uint64_t t, const perf_counters& counters) const {
+            output << "[" << t << ",";
+            hashes_to_json(output);
+            output << ",";
+            counters.to_json(output);
+            output << "]";
+        }
+
+        protected:
+        std::size_t _size;
+        output_hash<Event> _output_hash;
+    };
+
+    /// output_sink<Event, true> stores the output events, and hashes them once the benchmark is over.
+    template <typename Event>
+    class output_sink<Event, true> {
+        public:
+        output_sink() {}
+
+        /// reserve allocates memory for the given number of events.
+        void reserve(std::size_t count) {
+            _events.reserve(count);
+        }
+
+        /// operator() handles an output event.
+        void operator()(Event event) {
+            _events.push_back(event);
+        }
+
+        /// size returns the number of output events.
+        std::size_t size() const {
+            return _events.size();
+        }
+
+        /// events returns the stored output events.
+        const std::vector<Event>& events() const {
+            return _events;
+        }
+
+        /// hashes_to_json writes the number of events and the columns' values.
+        void hashes_to_json(std::ostream& output) const {
+            output << _events.size() << ",";
+            outputs_columns_to_json(output, _events);
+        }
+
+        /// to_json writes the duration, the number of events and the columns' values.
+        void to_json(std::ostream& output, uint64_t t) const {
+            output << "[" << t << ",";
+            hashes_to_json(output);
+            output << "]";
+        }
+
+        /// to_json writes the duration, the number of events, the columns' values and the performance counters.
+        void to_json(std::ostream& output, uint64_t t, const perf_counters& counters) const {
+            output << "[" << t << ",";
+            hashes_to_json(output);
+            output << ",";
+            counters.to_json(output);
+            output << "]";
+        }
+
+        protected:
+        std::vector<Event> _events;
+    };
+
+    /// points_period_from_environment returns the value of the environment variable BENCHMARK_POINTS_PERIOD, or 0 if it
+    /// is not set. latency_sink keeps one raw point every points_period output events (none if the period is 0, unless
+    /// the points are written to a file).
+    inline std::size_t points_period_from_environment() {
+        const auto value = std::getenv("BENCHMARK_POINTS_PERIOD");
+        if (value == nullptr) {
+            return 0;
+        }
+        return static_cast<std::size_t>(std::stoull(value));
     }
 
-    /// flows_latencies_to_json writes the given vector of flow events and latencies to the output.
-    /// points is a vector of pairs [t, time], where t is the event timestamp in us,
-    /// and time is the wall clock time or the elapsed time (depending on available information) in ns.
-    inline void flows_latencies_to_json(
-        std::ostream& output,
-        const std::vector<flow>& flows,
-        const std::vector<std::pair<uint64_t, uint64_t>>& points) {
-        output
-            << "["
-            << flows.size() << ","
-            << hash_events<uint64_t>(flows.begin(), flows.end(), [](flow event) { return event.t; }) << ","
-            << hash_events<uint32_t>(flows.begin(), flows.end(), [](flow event) {
-                const auto v = event.vx;
-                return *reinterpret_cast<const uint32_t*>(&v);
-            }) << ","
-            << hash_events<uint32_t>(flows.begin(), flows.end(), [](flow event) {
-                const auto v = event.vy;
-                return *reinterpret_cast<const uint32_t*>(&v);
-            }) << ","
-            << hash_events<uint16_t>(flows.begin(), flows.end(), [](flow event) { return event.x; }) << ","
-            << hash_events<uint16_t>(flows.begin(), flows.end(), [](flow event) { return event.y; }) << ",[";
-        for (std::size_t index = 0; index < points.size(); ++index) {
-            if (index > 0) {
-                output << ",";
+    /// points_filename_from_environment returns the value of the environment variable BENCHMARK_POINTS_FILENAME, or an
+    /// empty string if it is not set. latency_sink writes its sampled points to this file in binary format (see
+    /// points_to_binary) instead of the JSON output.
+    inline std::string points_filename_from_environment() {
+        const auto value = std::getenv("BENCHMARK_POINTS_FILENAME");
+        return value == nullptr ? std::string() : std::string(value);
+    }
+
+    /// points_signature is written at the beginning of binary points files.
+    constexpr char points_signature[] = "benchmarkpoints";
+
+    /// points_version is the binary points format version.
+    constexpr uint8_t points_version = 1;
+
+    /// write_varint writes an unsigned integer as a LEB128 varint (7 bits per byte, least significant group first).
+    inline void write_varint(std::ostream& output, uint64_t value) {
+        while (value >= 0x80) {
+            output.put(static_cast<char>((value & 0x7f) | 0x80));
+            value >>= 7;
+        }
+        output.put(static_cast<char>(value));
+    }
+
+    /// read_varint reads a LEB128 varint written by write_varint.
+    inline uint64_t read_varint(std::istream& input) {
+        uint64_t value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7) {
+            const auto byte = input.get();
+            if (byte == std::char_traits<char>::eof()) {
+                throw std::runtime_error("the points file is truncated");
+            }
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
             }
-            output << "[" << points[index].first << ",\"" << points[index].second << "\"]";
         }
-        output << "]]";
+        throw std::runtime_error("the points file contains a varint larger than 64 bits");
+    }
+
+    /// zigzag maps the difference between two unsigned integers to an unsigned integer, so that small negative
+    /// differences are encoded with small varints.
+    inline uint64_t zigzag(uint64_t value, uint64_t previous_value) {
+        return value >= previous_value ? (value - previous_value) << 1 : ((previous_value - value) << 1) - 1;
+    }
+
+    /// unzigzag reverts zigzag.
+    inline uint64_t unzigzag(uint64_t delta, uint64_t previous_value) {
+        return (delta & 1) == 0 ? previous_value + (delta >> 1) : previous_value - ((delta + 1) >> 1);
     }
 
-    /// activities_latencies_to_json writes the given vector of activity events and latencies to the output.
-    /// points is a vector of pairs [t, time], where t is the event timestamp in us,
-    /// and time is the wall clock time or the elapsed time (depending on available information) in ns.
-    inline void activities_latencies_to_json(
+    /// points_file contains the hashes and the sampled points of a latencies benchmark.
+    struct points_file {
+        std::string hashes;
+        uint64_t points_period;
+        std::vector<std::pair<uint64_t, uint64_t>> points;
+    };
+
+    /// points_to_binary writes the hashes (as written by hashes_to_json) and the points [t, time - time_0].
+    /// The file starts with points_signature, points_version, the hashes' size and bytes, the points period and the
+    /// number of points (varints). Each point is then encoded as two zigzag varints, the differences between its t
+    /// and time and the previous point's (0 for the first point).
+    inline void points_to_binary(
         std::ostream& output,
-        const std::vector<activity>& activities,
+        const std::string& hashes,
+        uint64_t points_period,
         const std::vector<std::pair<uint64_t, uint64_t>>& points) {
-        output
-            << "["
-            << activities.size() << ","
-            << hash_events<uint64_t>(activities.begin(), activities.end(), [](activity event) { return event.t; }) << ","
-            << hash_events<uint32_t>(activities.begin(), activities.end(), [](activity event) {
-                const auto potential = event.potential;
-                return *reinterpret_cast<const uint32_t*>(&potential);
-            }) << ","
-            << hash_events<uint16_t>(activities.begin(), activities.end(), [](activity event) { return event.x; }) << ","
-            << hash_events<uint16_t>(activities.begin(), activities.end(), [](activity event) { return event.y; }) << ",[";
-        for (std::size_t index = 0; index < points.size(); ++index) {
-            if (index > 0) {
-                output << ",";
+        output.write(points_signature, sizeof(points_signature) - 1);
+        output.put(static_cast<char>(points_version));
+        write_varint(output, hashes.size());
+        output.write(hashes.data(), hashes.size());
+        write_varint(output, points_period);
+        write_varint(output, points.size());
+        uint64_t previous_t = 0;
+        uint64_t previous_time = 0;
+        for (const auto& point : points) {
+            write_varint(output, zigzag(point.first, previous_t));
+            write_varint(output, zigzag(point.second, previous_time));
+            previous_t = point.first;
+            previous_time = point.second;
+        }
+    }
+
+    /// binary_to_points reads a file written by points_to_binary.
+    inline points_file binary_to_points(std::istream& input) {
+        {
+            std::array<char, sizeof(points_signature) - 1> signature;
+            input.read(signature.data(), signature.size());
+            if (input.gcount() != static_cast<std::streamsize>(signature.size())
+                || !std::equal(signature.begin(), signature.end(), points_signature)) {
+                throw std::runtime_error("the points file signature is wrong");
+            }
+            if (input.get() != points_version) {
+                throw std::runtime_error("the points file version is not supported");
             }
-            output << "[" << points[index].first << ",\"" << points[index].second << "\"]";
         }
-        output << "]]";
+        points_file result;
+        result.hashes.resize(static_cast<std::size_t>(read_varint(input)));
+        input.read(&result.hashes[0], result.hashes.size());
+        if (input.gcount() != static_cast<std::streamsize>(result.hashes.size())) {
+            throw std::runtime_error("the points file is truncated");
+        }
+        result.points_period = read_varint(input);
+        result.points.resize(static_cast<std::size_t>(read_varint(input)));
+        uint64_t previous_t = 0;
+        uint64_t previous_time = 0;
+        for (auto& point : result.points) {
+            point.first = unzigzag(read_varint(input), previous_t);
+            point.second = unzigzag(read_varint(input), previous_time);
+            previous_t = point.first;
+            previous_time = point.second;
+        }
+        return result;
     }
+
+    /// latency_sink verifies the output events of a latencies benchmark, and counts their latencies in a histogram.
+    /// The latency of an output event with timestamp t is the time elapsed between the dispatch of the first packet
+    /// whose last timestamp is larger than or equal to t, and the event's arrival in the sink. The dispatch time of
+    /// the packet with index i is time_0 + (packets_ts[i] - packets_ts[0]) / speed us.
+    /// Raw points [t, time - time_0] are kept only in sampled mode (see points_period_from_environment), and written
+    /// to a binary file by write_points instead of the JSON output if points_filename is not empty. A points filename
+    /// with a period of 0 keeps every point, since it would otherwise produce an empty file.
+    template <typename Event>
+    class latency_sink {
+        public:
+        latency_sink(
+            std::size_t points_period = points_period_from_environment(),
+            std::string points_filename = points_filename_from_environment()) :
+            _points_period(points_period == 0 && !points_filename.empty() ? 1 : points_period),
+            _points_filename(std::move(points_filename)),
+            _started(false),
+            _packets_ts(nullptr),
+            _time_0(0),
+            _speed(1.0),
+            _packet_index(0),
+            _size(0) {
+            calibrated_clock();
+        }
+
+        /// start must be called before the first output event, with the packets' last timestamps (in us), the
+        /// dispatch time of the first packet (in ns, read from calibrated_clock) and the replay speed factor.
+        /// packets_ts is not copied, and must remain valid until the last output event.
+        void start(const std::vector<uint64_t>& packets_ts, uint64_t time_0, double speed = 1.0) {
+            if (packets_ts.empty()) {
+                throw std::logic_error("packets_ts must not be empty");
+            }
+            _packets_ts = &packets_ts;
+            _time_0 = time_0;
+            _speed = speed;
+            _packet_index = 0;
+            _started = true;
+        }
+
+        /// started returns true if start was called.
+        bool started() const {
+            return _started;
+        }
+
+        /// reserve allocates memory for the given number of events, if the sink keeps them.
+        void reserve(std::size_t count) {
+            _output_sink.reserve(count);
+            if (_points_period > 0) {
+                _points.reserve(count / _points_period + 1);
+            }
+        }
+
+        /// operator() handles an output event.
+        void operator()(Event event) {
+            const auto time = calibrated_clock().now();
+            _output_sink(event);
+            const auto& packets_ts = *_packets_ts;
+            if (packets_ts[_packet_index] < event.t) {
+                while (_packet_index < packets_ts.size() - 1 && packets_ts[_packet_index] < event.t) {
+                    ++_packet_index;
+                }
+            } else if (_packet_index > 0 && packets_ts[_packet_index - 1] >= event.t) {
+                _packet_index = static_cast<std::size_t>(
+                    std::lower_bound(packets_ts.begin(), packets_ts.begin() + _packet_index, event.t)
+                    - packets_ts.begin());
+            }
+            const auto dispatch_time = _time_0
+                                       + static_cast<uint64_t>(
+                                           dispatch_offset(packets_ts[_packet_index] - packets_ts.front(), _speed).count());
+            _histogram.add(time > dispatch_time ? time - dispatch_time : 0);
+            if (_points_period > 0 && _size % _points_period == 0) {
+                _points.emplace_back(static_cast<uint64_t>(event.t), time > _time_0 ? time - _time_0 : 0);
+            }
+            ++_size;
+        }
+
+        /// to_json writes the number of events, the columns' values, the latencies histogram, and the sampled points.
+        /// If the sink has a points filename, the JSON array is empty (see write_points).
+        void to_json(std::ostream& output) const {
+            output << "[";
+            _output_sink.hashes_to_json(output);
+            output << ",";
+            _histogram.to_json(output);
+            output << ",[";
+            if (!_points_filename.empty()) {
+                output << "]]";
+                return;
+            }
+            for (std::size_t index = 0; index < _points.size(); ++index) {
+                if (index > 0) {
+                    output << ",";
+                }
+                output << "[" << _points[index].first << ",\"" << _points[index].second << "\"]";
+            }
+            output << "]]";
+        }
+
+        /// write_points writes the sampled points to the points file in binary format (see points_to_binary).
+        /// It does nothing if the sink has no points filename.
+        void write_points() const {
+            if (_points_filename.empty()) {
+                return;
+            }
+            std::stringstream hashes;
+            _output_sink.hashes_to_json(hashes);
+            std::ofstream points_output(_points_filename, std::ofstream::binary);
+            if (!points_output.good()) {
+                throw sepia::unwritable_file(_points_filename);
+            }
+            points_to_binary(points_output, hashes.str(), _points_period, _points);
+        }
+
+        protected:
+        const std::size_t _points_period;
+        const std::string _points_filename;
+        bool _started;
+        const std::vector<uint64_t>* _packets_ts;
+        uint64_t _time_0;
+        double _speed;
+        std::size_t _packet_index;
+        std::size_t _size;
+        output_sink<Event> _output_sink;
+        latency_histogram _histogram;
+        std::vector<std::pair<uint64_t, uint64_t>> _points;
+    };
 }
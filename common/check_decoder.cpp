@@ -0,0 +1,70 @@
+#include "benchmark.hpp"
+#include "third_party/pontella/source/pontella.hpp"
+
+int main(int argc, char* argv[]) {
+    return pontella::main(
+        {
+            "check_decoder compares the batch DVS decoder with the byte-by-byte state machine",
+            "the batch decoder is run with several chunk sizes, to exercise records straddling chunks",
+            "Syntax: ./check_decoder /path/to/input.es",
+        },
+        argc,
+        argv,
+        1,
+        {},
+        {}, [&](pontella::command command) {
+            const auto filename = command.arguments.front();
+            std::vector<sepia::dvs_event> expected_events;
+            {
+                auto event_stream = sepia::filename_to_ifstream(filename);
+                const auto header = sepia::read_header(*event_stream);
+                if (header.event_stream_type != sepia::type::dvs) {
+                    throw sepia::unsupported_event_type();
+                }
+                sepia::handle_byte<sepia::type::dvs> handle_byte(header.width, header.height);
+                sepia::dvs_event event = {};
+                std::vector<uint8_t> bytes(1 << 16);
+                for (;;) {
+                    event_stream->read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+                    const auto size = static_cast<std::size_t>(event_stream->gcount());
+                    for (std::size_t index = 0; index < size; ++index) {
+                        if (handle_byte(bytes[index], event)) {
+                            expected_events.push_back(event);
+                        }
+                    }
+                    if (size < bytes.size()) {
+                        break;
+                    }
+                }
+            }
+            for (const std::size_t chunk_size : {static_cast<std::size_t>(1),
+                                                 static_cast<std::size_t>(7),
+                                                 static_cast<std::size_t>(33),
+                                                 static_cast<std::size_t>(1 << 16)}) {
+                std::vector<sepia::dvs_event> events;
+                events.reserve(expected_events.size());
+                sepia::join_batch_observable<sepia::type::dvs>(
+                    filename,
+                    [&](const std::vector<sepia::dvs_event>& decoded_events) {
+                        events.insert(events.end(), decoded_events.begin(), decoded_events.end());
+                    },
+                    chunk_size);
+                if (events.size() != expected_events.size()) {
+                    throw std::runtime_error(
+                        "the batch decoder returned " + std::to_string(events.size()) + " events instead of "
+                        + std::to_string(expected_events.size()) + " (chunk size "
+                        + std::to_string(chunk_size) + ")");
+                }
+                for (std::size_t index = 0; index < events.size(); ++index) {
+                    if (events[index].t != expected_events[index].t || events[index].x != expected_events[index].x
+                        || events[index].y != expected_events[index].y
+                        || events[index].is_increase != expected_events[index].is_increase) {
+                        throw std::runtime_error(
+                            "the batch decoder and the state machine differ on event " + std::to_string(index)
+                            + " (chunk size " + std::to_string(chunk_size) + ")");
+                    }
+                }
+            }
+            std::cout << "[" << expected_events.size() << ",true]";
+        });
+}
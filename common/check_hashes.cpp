@@ -0,0 +1,115 @@
+#include "benchmark.hpp"
+#include "third_party/pontella/source/pontella.hpp"
+#include <random>
+
+/// compare throws if the fused hashes differ from the legacy ones.
+inline void compare(const std::string& name, std::size_t size, const std::string& expected, const std::string& fused) {
+    if (expected != fused) {
+        throw std::runtime_error(
+            "the fused and legacy " + name + " hashes differ (" + std::to_string(size) + " events): " + fused
+            + " instead of " + expected);
+    }
+}
+
+/// compare_sinks throws if the incremental sink's output differs from the buffered sink's.
+template <typename Event>
+void compare_sinks(const std::string& name, const std::vector<Event>& events) {
+    benchmark::output_sink<Event, false> incremental_sink;
+    benchmark::output_sink<Event, true> buffered_sink;
+    for (const auto& event : events) {
+        incremental_sink(event);
+        buffered_sink(event);
+    }
+    std::stringstream expected;
+    buffered_sink.to_json(expected, 0);
+    std::stringstream incremental;
+    incremental_sink.to_json(incremental, 0);
+    compare(name + " sink", events.size(), expected.str(), incremental.str());
+}
+
+int main(int argc, char* argv[]) {
+    return pontella::main(
+        {
+            "check_hashes compares the fused column hashes with one hash_events pass per column",
+            "and the incremental output sinks with the buffered ones",
+            "random outputs of several sizes are hashed, to exercise partial blocks and parallel hashing",
+            "Syntax: ./check_hashes",
+        },
+        argc,
+        argv,
+        0,
+        {},
+        {}, [&](pontella::command) {
+            std::mt19937_64 engine(0);
+            std::uniform_real_distribution<float> float_distribution(-1.0f, 1.0f);
+            std::size_t checks = 0;
+            for (const std::size_t size : {static_cast<std::size_t>(0),
+                                           static_cast<std::size_t>(1),
+                                           static_cast<std::size_t>(3),
+                                           static_cast<std::size_t>(7),
+                                           static_cast<std::size_t>(8),
+                                           static_cast<std::size_t>(9),
+                                           static_cast<std::size_t>(1000),
+                                           benchmark::minimum_parallel_columns_size + 5}) {
+                {
+                    std::vector<sepia::dvs_event> events(size);
+                    for (auto& event : events) {
+                        event = {engine(), static_cast<uint16_t>(engine()), static_cast<uint16_t>(engine()), (engine() & 1) == 1};
+                    }
+                    std::stringstream expected;
+                    expected
+                        << std::count_if(events.begin(), events.end(), [](sepia::dvs_event event) { return event.is_increase; }) << ","
+                        << benchmark::hash_events<uint64_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.t; }) << ","
+                        << benchmark::hash_events<uint16_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.x; }) << ","
+                        << benchmark::hash_events<uint16_t>(events.begin(), events.end(), [](sepia::dvs_event event) { return event.y; });
+                    std::stringstream fused;
+                    benchmark::events_columns_to_json(fused, events);
+                    compare("events", size, expected.str(), fused.str());
+                    compare_sinks("events", events);
+                    ++checks;
+                }
+                {
+                    std::vector<benchmark::flow> flows(size);
+                    for (auto& flow : flows) {
+                        flow = {engine(), float_distribution(engine), float_distribution(engine), static_cast<uint16_t>(engine()), static_cast<uint16_t>(engine())};
+                    }
+                    std::stringstream expected;
+                    expected
+                        << benchmark::hash_events<uint64_t>(flows.begin(), flows.end(), [](benchmark::flow event) { return event.t; }) << ","
+                        << benchmark::hash_events<uint32_t>(flows.begin(), flows.end(), [](benchmark::flow event) {
+                               return benchmark::float_to_uint32(event.vx);
+                           }) << ","
+                        << benchmark::hash_events<uint32_t>(flows.begin(), flows.end(), [](benchmark::flow event) {
+                               return benchmark::float_to_uint32(event.vy);
+                           }) << ","
+                        << benchmark::hash_events<uint16_t>(flows.begin(), flows.end(), [](benchmark::flow event) { return event.x; }) << ","
+                        << benchmark::hash_events<uint16_t>(flows.begin(), flows.end(), [](benchmark::flow event) { return event.y; });
+                    std::stringstream fused;
+                    benchmark::flows_columns_to_json(fused, flows);
+                    compare("flows", size, expected.str(), fused.str());
+                    compare_sinks("flows", flows);
+                    ++checks;
+                }
+                {
+                    std::vector<benchmark::activity> activities(size);
+                    for (auto& activity : activities) {
+                        activity = {engine(), float_distribution(engine), static_cast<uint16_t>(engine()), static_cast<uint16_t>(engine())};
+                    }
+                    std::stringstream expected;
+                    expected
+                        << benchmark::hash_events<uint64_t>(activities.begin(), activities.end(), [](benchmark::activity event) { return event.t; }) << ","
+                        << benchmark::hash_events<uint32_t>(activities.begin(), activities.end(), [](benchmark::activity event) {
+                               return benchmark::float_to_uint32(event.potential);
+                           }) << ","
+                        << benchmark::hash_events<uint16_t>(activities.begin(), activities.end(), [](benchmark::activity event) { return event.x; }) << ","
+                        << benchmark::hash_events<uint16_t>(activities.begin(), activities.end(), [](benchmark::activity event) { return event.y; });
+                    std::stringstream fused;
+                    benchmark::activities_columns_to_json(fused, activities);
+                    compare("activities", size, expected.str(), fused.str());
+                    compare_sinks("activities", activities);
+                    ++checks;
+                }
+            }
+            std::cout << "[" << checks << ",true]";
+        });
+}
@@ -0,0 +1,236 @@
+#include "benchmark.hpp"
+#include "third_party/pontella/source/pontella.hpp"
+#include <random>
+
+/// burst_period is the period of the event rate modulation (in us).
+constexpr double burst_period = 5e4;
+
+/// pi is used to sample angles and modulate the event rate.
+constexpr double pi = 3.14159265358979323846;
+
+/// triangle reflects a position moving at constant speed between 0 and length.
+/// It returns the position and the direction of the motion (1 or -1).
+inline std::pair<double, double> triangle(double position, double length) {
+    if (length <= 0.0) {
+        return {0.0, 1.0};
+    }
+    auto remainder = std::fmod(position, 2.0 * length);
+    if (remainder < 0.0) {
+        remainder += 2.0 * length;
+    }
+    if (remainder < length) {
+        return {remainder, 1.0};
+    }
+    return {2.0 * length - remainder, -1.0};
+}
+
+/// scene generates the events of moving edges and blobs, and background noise.
+class scene {
+    public:
+    scene(uint16_t width, uint16_t height, std::size_t number_of_objects, double noise, std::mt19937_64& engine) :
+        _width(width),
+        _height(height),
+        _noise(noise),
+        _engine(engine),
+        _unit_distribution(0.0, 1.0) {
+        const auto size = static_cast<double>(std::min(width, height));
+        for (std::size_t index = 0; index < number_of_objects; ++index) {
+            object new_object;
+            new_object.is_edge = index % 2 == 0;
+            new_object.x = unit() * width;
+            new_object.y = unit() * height;
+            new_object.radius = size * (0.05 + 0.1 * unit());
+            // speeds are in pixels per us, between a quarter and one sensor size per second
+            const auto speed = size * (0.25 + 0.75 * unit()) * 1e-6;
+            const auto angle = unit() * 2.0 * pi;
+            if (new_object.is_edge) {
+                // edges are vertical or horizontal, and move along their normal
+                if (index % 4 == 0) {
+                    new_object.vx = speed * (angle < pi ? 1.0 : -1.0);
+                    new_object.vy = 0.0;
+                } else {
+                    new_object.vx = 0.0;
+                    new_object.vy = speed * (angle < pi ? 1.0 : -1.0);
+                }
+            } else {
+                new_object.vx = speed * std::cos(angle);
+                new_object.vy = speed * std::sin(angle);
+            }
+            _objects.push_back(new_object);
+        }
+    }
+    scene(const scene&) = delete;
+    scene(scene&&) = delete;
+    scene& operator=(const scene&) = delete;
+    scene& operator=(scene&&) = delete;
+    virtual ~scene() {}
+
+    /// event draws an event with the given timestamp.
+    sepia::dvs_event event(uint64_t t) {
+        if (_objects.empty() || unit() < _noise) {
+            return {t, pixel(unit() * _width, _width), pixel(unit() * _height, _height), unit() < 0.5};
+        }
+        const auto& selected_object =
+            _objects[std::min(static_cast<std::size_t>(unit() * _objects.size()), _objects.size() - 1)];
+        const auto time = static_cast<double>(t);
+        if (selected_object.is_edge) {
+            // edges wrap around the sensor, and events are spread over three pixels across the edge
+            const auto jitter = std::floor(unit() * 3.0) - 1.0;
+            if (selected_object.vx != 0.0) {
+                const auto x = wrap(selected_object.x + selected_object.vx * time + jitter, _width);
+                return {t, pixel(x, _width), pixel(unit() * _height, _height), selected_object.vx > 0.0};
+            }
+            const auto y = wrap(selected_object.y + selected_object.vy * time + jitter, _height);
+            return {t, pixel(unit() * _width, _width), pixel(y, _height), selected_object.vy > 0.0};
+        }
+        // blobs bounce off the sensor's borders, and events are drawn on their contour
+        // the polarity is positive on the leading half of the contour
+        const auto x_and_direction =
+            triangle(selected_object.x + selected_object.vx * time, std::max(_width - 2.0 * selected_object.radius, 0.0));
+        const auto y_and_direction = triangle(
+            selected_object.y + selected_object.vy * time, std::max(_height - 2.0 * selected_object.radius, 0.0));
+        const auto angle = unit() * 2.0 * pi;
+        const auto cos_angle = std::cos(angle);
+        const auto sin_angle = std::sin(angle);
+        return {
+            t,
+            pixel(selected_object.radius + x_and_direction.first + selected_object.radius * cos_angle, _width),
+            pixel(selected_object.radius + y_and_direction.first + selected_object.radius * sin_angle, _height),
+            cos_angle * selected_object.vx * x_and_direction.second
+                    + sin_angle * selected_object.vy * y_and_direction.second
+                > 0.0};
+    }
+
+    protected:
+    /// object represents a moving edge or blob.
+    struct object {
+        bool is_edge;
+        double x;
+        double y;
+        double vx;
+        double vy;
+        double radius;
+    };
+
+    /// unit draws a number in the range [0, 1).
+    double unit() {
+        return _unit_distribution(_engine);
+    }
+
+    /// wrap returns the position modulo the given length.
+    static double wrap(double position, double length) {
+        const auto remainder = std::fmod(position, length);
+        return remainder < 0.0 ? remainder + length : remainder;
+    }
+
+    /// pixel converts a position to a pixel coordinate in the range [0, length - 1].
+    static uint16_t pixel(double position, uint16_t length) {
+        if (position < 0.0) {
+            return 0;
+        }
+        return static_cast<uint16_t>(std::min(position, static_cast<double>(length - 1)));
+    }
+
+    const uint16_t _width;
+    const uint16_t _height;
+    const double _noise;
+    std::mt19937_64& _engine;
+    std::uniform_real_distribution<double> _unit_distribution;
+    std::vector<object> _objects;
+};
+
+/// option_to_double returns the value of the given option, or the default value if the option is not set.
+inline double option_to_double(const pontella::command& command, const std::string& name, double default_value) {
+    const auto name_and_argument = command.options.find(name);
+    return name_and_argument == command.options.end() ? default_value : std::stod(name_and_argument->second);
+}
+
+int main(int argc, char* argv[]) {
+    return pontella::main(
+        {
+            "generate creates a synthetic Event Stream file with moving edges and blobs",
+            "the stream is deterministic for a given set of options",
+            "Syntax: ./generate [options] /path/to/output.es",
+            "Available options:",
+            "    -r [rate], --rate [rate]                    sets the mean event rate in Mev/s",
+            "                                                    defaults to 1",
+            "    -d [duration], --duration [duration]        sets the stream duration in seconds",
+            "                                                    defaults to 1",
+            "    -x [width], --width [width]                 sets the sensor width in pixels (at most 1280)",
+            "                                                    defaults to 304",
+            "    -y [height], --height [height]              sets the sensor height in pixels (at most 720)",
+            "                                                    defaults to 240",
+            "    -b [burstiness], --burstiness [burstiness]  sets the amplitude of the rate modulation",
+            "                                                    in the range [0, 1], the rate oscillates between",
+            "                                                    rate * (1 - burstiness) and rate * (1 + burstiness)",
+            "                                                    with a 50 ms period",
+            "                                                    defaults to 0",
+            "    -n [fraction], --noise [fraction]           sets the fraction of uniformly distributed events",
+            "                                                    in the range [0, 1]",
+            "                                                    defaults to 0.1",
+            "    -o [objects], --objects [objects]           sets the number of moving objects",
+            "                                                    (even objects are edges, odd objects are blobs)",
+            "                                                    defaults to 4",
+            "    -s [seed], --seed [seed]                    sets the random number generator's seed",
+            "                                                    defaults to 0",
+            "    -h, --help                                  shows this help message",
+        },
+        argc,
+        argv,
+        1,
+        {{"rate", {"r"}},
+         {"duration", {"d"}},
+         {"width", {"x"}},
+         {"height", {"y"}},
+         {"burstiness", {"b"}},
+         {"noise", {"n"}},
+         {"objects", {"o"}},
+         {"seed", {"s"}}},
+        {},
+        [&](pontella::command command) {
+            const auto rate = option_to_double(command, "rate", 1.0);
+            if (!(rate > 0.0)) {
+                throw std::runtime_error("the rate must be strictly positive");
+            }
+            const auto duration = option_to_double(command, "duration", 1.0);
+            if (!(duration > 0.0)) {
+                throw std::runtime_error("the duration must be strictly positive");
+            }
+            const auto width = option_to_double(command, "width", 304.0);
+            const auto height = option_to_double(command, "height", 240.0);
+            if (width < 1.0 || width > 1280.0 || height < 1.0 || height > 720.0) {
+                throw std::runtime_error("the resolution must be in the range [1, 1280] x [1, 720]");
+            }
+            const auto burstiness = option_to_double(command, "burstiness", 0.0);
+            if (burstiness < 0.0 || burstiness > 1.0) {
+                throw std::runtime_error("the burstiness must be in the range [0, 1]");
+            }
+            const auto noise = option_to_double(command, "noise", 0.1);
+            if (noise < 0.0 || noise > 1.0) {
+                throw std::runtime_error("the noise fraction must be in the range [0, 1]");
+            }
+            const auto number_of_objects = static_cast<std::size_t>(option_to_double(command, "objects", 4.0));
+            const auto seed = static_cast<uint64_t>(option_to_double(command, "seed", 0.0));
+            std::mt19937_64 engine(seed);
+            scene generator(
+                static_cast<uint16_t>(width), static_cast<uint16_t>(height), number_of_objects, noise, engine);
+            sepia::write<sepia::type::dvs> write(
+                sepia::filename_to_ofstream(command.arguments.front()),
+                static_cast<uint16_t>(width),
+                static_cast<uint16_t>(height));
+            // the number of events per microsecond follows a Poisson distribution, whose mean is modulated
+            // by the burstiness
+            const auto end_t = static_cast<uint64_t>(duration * 1e6);
+            for (uint64_t t = 0; t < end_t; ++t) {
+                const auto mean =
+                    rate * (1.0 + burstiness * std::sin(2.0 * pi * static_cast<double>(t) / burst_period));
+                if (mean <= 0.0) {
+                    continue;
+                }
+                std::poisson_distribution<uint32_t> count_distribution(mean);
+                for (auto count = count_distribution(engine); count > 0; --count) {
+                    write(generator.event(t));
+                }
+            }
+        });
+}
@@ -0,0 +1,58 @@
+#include "benchmark.hpp"
+#include "third_party/pontella/source/pontella.hpp"
+
+/// points_to_json writes the hashes, the points period and the points as a JSON object.
+inline void points_to_json(std::ostream& output, const benchmark::points_file& points_file) {
+    output << "{\"hashes\":[" << points_file.hashes << "],\"points_period\":" << points_file.points_period
+           << ",\"points\":[";
+    for (std::size_t index = 0; index < points_file.points.size(); ++index) {
+        if (index > 0) {
+            output << ",";
+        }
+        output << "[" << points_file.points[index].first << "," << points_file.points[index].second << "]";
+    }
+    output << "]}";
+}
+
+/// points_to_csv writes the points as CSV lines.
+inline void points_to_csv(std::ostream& output, const benchmark::points_file& points_file) {
+    output << "t,time\n";
+    for (const auto& point : points_file.points) {
+        output << point.first << "," << point.second << "\n";
+    }
+}
+
+int main(int argc, char* argv[]) {
+    return pontella::main(
+        {
+            "points converts a binary points file written by a latencies benchmark to JSON or CSV",
+            "the JSON output has the structure {\"hashes\":[...],\"points_period\":...,\"points\":[[t,time],...]}",
+            "the CSV output has a header line (t,time) and one line per point",
+            "Syntax: ./points [options] /path/to/input.points [/path/to/output]",
+            "    the output is written to the standard output if its path is omitted",
+            "Available options:",
+            "    -c, --csv     writes CSV instead of JSON",
+            "    -h, --help    shows this help message",
+        },
+        argc,
+        argv,
+        -1,
+        {},
+        {{"csv", {"c"}}}, [&](pontella::command command) {
+            if (command.arguments.empty() || command.arguments.size() > 2) {
+                throw std::runtime_error("points expects one or two arguments");
+            }
+            const auto points_file = benchmark::binary_to_points(*sepia::filename_to_ifstream(command.arguments[0]));
+            std::unique_ptr<std::ostream> file_output;
+            if (command.arguments.size() == 2) {
+                file_output = sepia::filename_to_ofstream(command.arguments[1]);
+            }
+            auto& output = file_output ? *file_output : std::cout;
+            if (command.flags.find("csv") != command.flags.end()) {
+                points_to_csv(output, points_file);
+            } else {
+                points_to_json(output, points_file);
+            }
+            output.flush();
+        });
+}
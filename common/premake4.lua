@@ -23,3 +23,91 @@ solution 'packetize'
             linkoptions {'-std=c++11'}
         configuration 'windows'
             files {'.clang-format'}
+    project 'check_decoder'
+        kind 'ConsoleApp'
+        language 'C++'
+        location 'build'
+        files {'benchmark.hpp', 'check_decoder.cpp'}
+        configuration 'release'
+            targetdir 'build/release'
+            defines {'NDEBUG'}
+            flags {'OptimizeSpeed'}
+        configuration 'debug'
+            targetdir 'build/debug'
+            defines {'DEBUG'}
+            flags {'Symbols'}
+        configuration 'linux'
+            links {'pthread'}
+            buildoptions {'-std=c++11'}
+            linkoptions {'-std=c++11'}
+        configuration 'macosx'
+            buildoptions {'-std=c++11'}
+            linkoptions {'-std=c++11'}
+        configuration 'windows'
+            files {'.clang-format'}
+    project 'check_hashes'
+        kind 'ConsoleApp'
+        language 'C++'
+        location 'build'
+        files {'benchmark.hpp', 'check_hashes.cpp'}
+        configuration 'release'
+            targetdir 'build/release'
+            defines {'NDEBUG'}
+            flags {'OptimizeSpeed'}
+        configuration 'debug'
+            targetdir 'build/debug'
+            defines {'DEBUG'}
+            flags {'Symbols'}
+        configuration 'linux'
+            links {'pthread'}
+            buildoptions {'-std=c++11'}
+            linkoptions {'-std=c++11'}
+        configuration 'macosx'
+            buildoptions {'-std=c++11'}
+            linkoptions {'-std=c++11'}
+        configuration 'windows'
+            files {'.clang-format'}
+    project 'generate'
+        kind 'ConsoleApp'
+        language 'C++'
+        location 'build'
+        files {'benchmark.hpp', 'generate.cpp'}
+        configuration 'release'
+            targetdir 'build/release'
+            defines {'NDEBUG'}
+            flags {'OptimizeSpeed'}
+        configuration 'debug'
+            targetdir 'build/debug'
+            defines {'DEBUG'}
+            flags {'Symbols'}
+        configuration 'linux'
+            links {'pthread'}
+            buildoptions {'-std=c++11'}
+            linkoptions {'-std=c++11'}
+        configuration 'macosx'
+            buildoptions {'-std=c++11'}
+            linkoptions {'-std=c++11'}
+        configuration 'windows'
+            files {'.clang-format'}
+    project 'points'
+        kind 'ConsoleApp'
+        language 'C++'
+        location 'build'
+        files {'benchmark.hpp', 'points.cpp'}
+        configuration 'release'
+            targetdir 'build/release'
+            defines {'NDEBUG'}
+            flags {'OptimizeSpeed'}
+        configuration 'debug'
+            targetdir 'build/debug'
+            defines {'DEBUG'}
+            flags {'Symbols'}
+        configuration 'linux'
+            links {'pthread'}
+            buildoptions {'-std=c++11'}
+            linkoptions {'-std=c++11'}
+        configuration 'macosx'
+            buildoptions {'-std=c++11'}
+            linkoptions {'-std=c++11'}
+        configuration 'windows'
+            files {'.clang-format'}
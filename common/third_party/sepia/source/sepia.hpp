@@ -1,11 +1,13 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
 #include <cctype>
 #include <chrono>
 #include <cmath>
 #include <condition_variable>
+#include <cstdio>
 #include <fstream>
 #include <functional>
 #include <memory>
@@ -17,6 +19,25 @@
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#if !defined(SEPIA_SCALAR) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define SEPIA_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define SEPIA_AVX2
+#include <immintrin.h>
+#endif
+#endif
 
 #ifdef SEPIA_COMPILER_WORKING_DIRECTORY
 #ifdef _WIN32
@@ -328,6 +349,119 @@ namespace sepia {
         return stream;
     }
 
+    /// memory_map maps a file to read-only memory.
+    class memory_map {
+        public:
+        memory_map(const std::string& filename) : _data(nullptr), _size(0) {
+#ifdef _WIN32
+            _file = CreateFileA(
+                filename.c_str(),
+                GENERIC_READ,
+                FILE_SHARE_READ,
+                nullptr,
+                OPEN_EXISTING,
+                FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN,
+                nullptr);
+            if (_file == INVALID_HANDLE_VALUE) {
+                throw unreadable_file(filename);
+            }
+            LARGE_INTEGER size;
+            if (!GetFileSizeEx(_file, &size)) {
+                CloseHandle(_file);
+                throw unreadable_file(filename);
+            }
+            _size = static_cast<std::size_t>(size.QuadPart);
+            _mapping = nullptr;
+            if (_size > 0) {
+                _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (_mapping == nullptr) {
+                    CloseHandle(_file);
+                    throw unreadable_file(filename);
+                }
+                _data = reinterpret_cast<const uint8_t*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+                if (_data == nullptr) {
+                    CloseHandle(_mapping);
+                    CloseHandle(_file);
+                    throw unreadable_file(filename);
+                }
+            }
+#else
+            const auto file_descriptor = open(filename.c_str(), O_RDONLY);
+            if (file_descriptor < 0) {
+                throw unreadable_file(filename);
+            }
+            struct stat status;
+            if (fstat(file_descriptor, &status) < 0) {
+                close(file_descriptor);
+                throw unreadable_file(filename);
+            }
+            _size = static_cast<std::size_t>(status.st_size);
+            if (_size > 0) {
+                auto data = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+                if (data == MAP_FAILED) {
+                    close(file_descriptor);
+                    throw unreadable_file(filename);
+                }
+                madvise(data, _size, MADV_SEQUENTIAL);
+                _data = reinterpret_cast<const uint8_t*>(data);
+            }
+            close(file_descriptor);
+#endif
+        }
+        memory_map(const memory_map&) = delete;
+        memory_map(memory_map&& other) :
+#ifdef _WIN32
+            _file(other._file),
+            _mapping(other._mapping),
+#endif
+            _data(other._data),
+            _size(other._size) {
+#ifdef _WIN32
+            other._file = INVALID_HANDLE_VALUE;
+            other._mapping = nullptr;
+#endif
+            other._data = nullptr;
+            other._size = 0;
+        }
+        memory_map& operator=(const memory_map&) = delete;
+        memory_map& operator=(memory_map&&) = delete;
+        virtual ~memory_map() {
+#ifdef _WIN32
+            if (_data != nullptr) {
+                UnmapViewOfFile(_data);
+            }
+            if (_mapping != nullptr) {
+                CloseHandle(_mapping);
+            }
+            if (_file != INVALID_HANDLE_VALUE) {
+                CloseHandle(_file);
+            }
+#else
+            if (_data != nullptr) {
+                munmap(const_cast<uint8_t*>(_data), _size);
+            }
+#endif
+        }
+
+        /// data returns a pointer to the first mapped byte.
+        const uint8_t* data() const {
+            return _data;
+        }
+
+        /// size returns the number of mapped bytes.
+        std::size_t size() const {
+            return _size;
+        }
+
+        protected:
+#ifdef _WIN32
+        HANDLE _file;
+        HANDLE _mapping;
+#endif
+        const uint8_t* _data;
+        std::size_t _size;
+    };
+
     /// header bundles an event stream's header parameters.
     struct header {
         /// version contains the version's major, minor and patch numbers in that order.
@@ -814,6 +948,397 @@ namespace sepia {
         state _state;
     };
 
+    /// handle_bytes decodes contiguous blocks of bytes without per-byte dispatch.
+    /// Records are decoded whole, and handle_byte is only used for records that straddle two blocks.
+    /// operator() calls a handler for each event, whereas append writes the events to a contiguous vector.
+    template <type event_stream_type>
+    class handle_bytes;
+
+    /// handle_bytes<type::generic> feeds blocks of generic bytes to the state machine.
+    template <>
+    class handle_bytes<type::generic> {
+        public:
+        handle_bytes(uint16_t width, uint16_t height) : _handle_byte(width, height) {}
+        handle_bytes(const handle_bytes&) = default;
+        handle_bytes(handle_bytes&&) = default;
+        handle_bytes& operator=(const handle_bytes&) = default;
+        handle_bytes& operator=(handle_bytes&&) = default;
+        ~handle_bytes() {}
+
+        /// operator() handles a block of bytes.
+        template <typename HandleEvent>
+        void operator()(const uint8_t* begin, const uint8_t* end, generic_event& generic_event, HandleEvent& handle_event) {
+            for (; begin != end; ++begin) {
+                if (_handle_byte(*begin, generic_event)) {
+                    handle_event(generic_event);
+                }
+            }
+        }
+
+        /// append handles a block of bytes and appends the decoded events to the given vector.
+        void append(
+            const uint8_t* begin,
+            const uint8_t* end,
+            generic_event& generic_event,
+            std::vector<sepia::generic_event>& generic_events) {
+            for (; begin != end; ++begin) {
+                if (_handle_byte(*begin, generic_event)) {
+                    generic_events.push_back(generic_event);
+                }
+            }
+        }
+
+        /// reset initializes the state machine.
+        void reset() {
+            _handle_byte.reset();
+        }
+
+        protected:
+        handle_byte<type::generic> _handle_byte;
+    };
+
+    /// handle_bytes<type::dvs> decodes blocks of DVS bytes.
+    template <>
+    class handle_bytes<type::dvs> {
+        public:
+        handle_bytes(uint16_t width, uint16_t height) :
+            _width(width),
+            _height(height),
+            _handle_byte(width, height),
+            _straddling(false) {}
+        handle_bytes(const handle_bytes&) = default;
+        handle_bytes(handle_bytes&&) = default;
+        handle_bytes& operator=(const handle_bytes&) = default;
+        handle_bytes& operator=(handle_bytes&&) = default;
+        ~handle_bytes() {}
+
+        /// operator() handles a block of bytes.
+        template <typename HandleEvent>
+        void operator()(const uint8_t* begin, const uint8_t* end, dvs_event& dvs_event, HandleEvent& handle_event) {
+            for (; _straddling && begin != end; ++begin) {
+                if (_handle_byte(*begin, dvs_event)) {
+                    _straddling = false;
+                    handle_event(dvs_event);
+                }
+            }
+            while (begin != end) {
+                if (*begin == 0b11111111) {
+                    dvs_event.t += 0b1111111;
+                    ++begin;
+                } else if (*begin == 0b11111110) {
+                    ++begin;
+                } else if (end - begin >= 5) {
+                    dvs_event.t += (*begin >> 1);
+                    dvs_event.is_increase = ((*begin & 1) == 1);
+                    dvs_event.x = static_cast<uint16_t>(begin[1] | (begin[2] << 8));
+                    if (dvs_event.x >= _width) {
+                        throw coordinates_overflow();
+                    }
+                    dvs_event.y = static_cast<uint16_t>(begin[3] | (begin[4] << 8));
+                    if (dvs_event.y >= _height) {
+                        throw coordinates_overflow();
+                    }
+                    begin += 5;
+                    handle_event(dvs_event);
+                } else {
+                    for (; begin != end; ++begin) {
+                        _handle_byte(*begin, dvs_event);
+                    }
+                    _straddling = true;
+                }
+            }
+        }
+
+        /// append handles a block of bytes and appends the decoded events to the given vector.
+        /// When SSE2 (respectively AVX2) is available, 16 (respectively 32) bytes are loaded at once to check that the
+        /// next 3 (respectively 6) records start with neither an overflow nor a reset byte. Such runs are decoded
+        /// without branches, and their coordinates are range-checked once per run. Other bytes go through the scalar
+        /// path, which also raises coordinates_overflow on the offending event.
+        void append(
+            const uint8_t* begin,
+            const uint8_t* end,
+            dvs_event& dvs_event,
+            std::vector<sepia::dvs_event>& dvs_events) {
+            for (; _straddling && begin != end; ++begin) {
+                if (_handle_byte(*begin, dvs_event)) {
+                    _straddling = false;
+                    dvs_events.push_back(dvs_event);
+                }
+            }
+            const auto previous_size = dvs_events.size();
+            dvs_events.resize(previous_size + static_cast<std::size_t>(end - begin) / 5);
+            auto output = dvs_events.data() + previous_size;
+            try {
+                while (begin != end) {
+#ifdef SEPIA_AVX2
+                    while (end - begin >= 32) {
+                        const auto bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin));
+                        const auto mask = _mm256_movemask_epi8(
+                            _mm256_cmpeq_epi8(_mm256_or_si256(bytes, _mm256_set1_epi8(1)), _mm256_set1_epi8(-1)));
+                        if ((mask & 0b10000100001000010000100001) != 0 || !decode_records<6>(begin, dvs_event, output)) {
+                            break;
+                        }
+                        begin += 30;
+                        output += 6;
+                    }
+#endif
+#ifdef SEPIA_SSE2
+                    while (end - begin >= 16) {
+                        const auto bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(begin));
+                        const auto mask =
+                            _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_or_si128(bytes, _mm_set1_epi8(1)), _mm_set1_epi8(-1)));
+                        if ((mask & 0b10000100001) != 0 || !decode_records<3>(begin, dvs_event, output)) {
+                            break;
+                        }
+                        begin += 15;
+                        output += 3;
+                    }
+                    if (begin == end) {
+                        break;
+                    }
+#endif
+                    if (*begin == 0b11111111) {
+                        dvs_event.t += 0b1111111;
+                        ++begin;
+                    } else if (*begin == 0b11111110) {
+                        ++begin;
+                    } else if (end - begin >= 5) {
+                        dvs_event.t += (*begin >> 1);
+                        dvs_event.is_increase = ((*begin & 1) == 1);
+                        dvs_event.x = static_cast<uint16_t>(begin[1] | (begin[2] << 8));
+                        if (dvs_event.x >= _width) {
+                            throw coordinates_overflow();
+                        }
+                        dvs_event.y = static_cast<uint16_t>(begin[3] | (begin[4] << 8));
+                        if (dvs_event.y >= _height) {
+                            throw coordinates_overflow();
+                        }
+                        begin += 5;
+                        *output = dvs_event;
+                        ++output;
+                    } else {
+                        for (; begin != end; ++begin) {
+                            _handle_byte(*begin, dvs_event);
+                        }
+                        _straddling = true;
+                    }
+                }
+            } catch (...) {
+                dvs_events.resize(static_cast<std::size_t>(output - dvs_events.data()));
+                throw;
+            }
+            dvs_events.resize(static_cast<std::size_t>(output - dvs_events.data()));
+        }
+
+        /// reset initializes the state machine.
+        void reset() {
+            _handle_byte.reset();
+            _straddling = false;
+        }
+
+        /// is_idle returns false if a record was only partially decoded.
+        bool is_idle() const {
+            return !_straddling;
+        }
+
+        protected:
+        /// decode_records decodes a run of records which do not start with an overflow or a reset byte.
+        /// If a coordinate is out of range, the run is discarded and false is returned.
+        template <std::size_t count>
+        bool decode_records(const uint8_t* begin, dvs_event& dvs_event, sepia::dvs_event* output) const {
+            auto t = dvs_event.t;
+            uint16_t x = 0;
+            uint16_t y = 0;
+            auto is_increase = false;
+            uint32_t overflow = 0;
+            for (std::size_t index = 0; index < count; ++index, begin += 5, ++output) {
+                t += (*begin >> 1);
+                is_increase = ((*begin & 1) == 1);
+                x = static_cast<uint16_t>(begin[1] | (begin[2] << 8));
+                y = static_cast<uint16_t>(begin[3] | (begin[4] << 8));
+                overflow |= static_cast<uint32_t>(x >= _width) | static_cast<uint32_t>(y >= _height);
+                output->t = t;
+                output->x = x;
+                output->y = y;
+                output->is_increase = is_increase;
+            }
+            if (overflow != 0) {
+                return false;
+            }
+            dvs_event.t = t;
+            dvs_event.x = x;
+            dvs_event.y = y;
+            dvs_event.is_increase = is_increase;
+            return true;
+        }
+
+        const uint16_t _width;
+        const uint16_t _height;
+        handle_byte<type::dvs> _handle_byte;
+        bool _straddling;
+    };
+
+    /// handle_bytes<type::atis> decodes blocks of ATIS bytes.
+    template <>
+    class handle_bytes<type::atis> {
+        public:
+        handle_bytes(uint16_t width, uint16_t height) :
+            _width(width),
+            _height(height),
+            _handle_byte(width, height),
+            _straddling(false) {}
+        handle_bytes(const handle_bytes&) = default;
+        handle_bytes(handle_bytes&&) = default;
+        handle_bytes& operator=(const handle_bytes&) = default;
+        handle_bytes& operator=(handle_bytes&&) = default;
+        ~handle_bytes() {}
+
+        /// operator() handles a block of bytes.
+        template <typename HandleEvent>
+        void operator()(const uint8_t* begin, const uint8_t* end, atis_event& atis_event, HandleEvent& handle_event) {
+            for (; _straddling && begin != end; ++begin) {
+                if (_handle_byte(*begin, atis_event)) {
+                    _straddling = false;
+                    handle_event(atis_event);
+                }
+            }
+            while (begin != end) {
+                if ((*begin & 0b11111100) == 0b11111100) {
+                    atis_event.t += static_cast<uint64_t>(0b111111) * (*begin & 0b11);
+                    ++begin;
+                } else if (end - begin >= 5) {
+                    atis_event.t += (*begin >> 2);
+                    atis_event.is_threshold_crossing = ((*begin & 1) == 1);
+                    atis_event.polarity = ((*begin & 0b10) == 0b10);
+                    atis_event.x = static_cast<uint16_t>(begin[1] | (begin[2] << 8));
+                    if (atis_event.x >= _width) {
+                        throw coordinates_overflow();
+                    }
+                    atis_event.y = static_cast<uint16_t>(begin[3] | (begin[4] << 8));
+                    if (atis_event.y >= _height) {
+                        throw coordinates_overflow();
+                    }
+                    begin += 5;
+                    handle_event(atis_event);
+                } else {
+                    for (; begin != end; ++begin) {
+                        _handle_byte(*begin, atis_event);
+                    }
+                    _straddling = true;
+                }
+            }
+        }
+
+        /// append handles a block of bytes and appends the decoded events to the given vector.
+        void append(
+            const uint8_t* begin,
+            const uint8_t* end,
+            atis_event& atis_event,
+            std::vector<sepia::atis_event>& atis_events) {
+            auto push_back = [&](const sepia::atis_event& decoded_event) { atis_events.push_back(decoded_event); };
+            operator()(begin, end, atis_event, push_back);
+        }
+
+        /// reset initializes the state machine.
+        void reset() {
+            _handle_byte.reset();
+            _straddling = false;
+        }
+
+        /// is_idle returns false if a record was only partially decoded.
+        bool is_idle() const {
+            return !_straddling;
+        }
+
+        protected:
+        const uint16_t _width;
+        const uint16_t _height;
+        handle_byte<type::atis> _handle_byte;
+        bool _straddling;
+    };
+
+    /// handle_bytes<type::color> decodes blocks of color bytes.
+    template <>
+    class handle_bytes<type::color> {
+        public:
+        handle_bytes(uint16_t width, uint16_t height) :
+            _width(width),
+            _height(height),
+            _handle_byte(width, height),
+            _straddling(false) {}
+        handle_bytes(const handle_bytes&) = default;
+        handle_bytes(handle_bytes&&) = default;
+        handle_bytes& operator=(const handle_bytes&) = default;
+        handle_bytes& operator=(handle_bytes&&) = default;
+        ~handle_bytes() {}
+
+        /// operator() handles a block of bytes.
+        template <typename HandleEvent>
+        void operator()(const uint8_t* begin, const uint8_t* end, color_event& color_event, HandleEvent& handle_event) {
+            for (; _straddling && begin != end; ++begin) {
+                if (_handle_byte(*begin, color_event)) {
+                    _straddling = false;
+                    handle_event(color_event);
+                }
+            }
+            while (begin != end) {
+                if (*begin == 0b11111111) {
+                    color_event.t += 0b11111110;
+                    ++begin;
+                } else if (*begin == 0b11111110) {
+                    ++begin;
+                } else if (end - begin >= 8) {
+                    color_event.t += *begin;
+                    color_event.x = static_cast<uint16_t>(begin[1] | (begin[2] << 8));
+                    if (color_event.x >= _width) {
+                        throw coordinates_overflow();
+                    }
+                    color_event.y = static_cast<uint16_t>(begin[3] | (begin[4] << 8));
+                    if (color_event.y >= _height) {
+                        throw coordinates_overflow();
+                    }
+                    color_event.r = begin[5];
+                    color_event.g = begin[6];
+                    color_event.b = begin[7];
+                    begin += 8;
+                    handle_event(color_event);
+                } else {
+                    for (; begin != end; ++begin) {
+                        _handle_byte(*begin, color_event);
+                    }
+                    _straddling = true;
+                }
+            }
+        }
+
+        /// append handles a block of bytes and appends the decoded events to the given vector.
+        void append(
+            const uint8_t* begin,
+            const uint8_t* end,
+            color_event& color_event,
+            std::vector<sepia::color_event>& color_events) {
+            auto push_back = [&](const sepia::color_event& decoded_event) { color_events.push_back(decoded_event); };
+            operator()(begin, end, color_event, push_back);
+        }
+
+        /// reset initializes the state machine.
+        void reset() {
+            _handle_byte.reset();
+            _straddling = false;
+        }
+
+        /// is_idle returns false if a record was only partially decoded.
+        bool is_idle() const {
+            return !_straddling;
+        }
+
+        protected:
+        const uint16_t _width;
+        const uint16_t _height;
+        handle_byte<type::color> _handle_byte;
+        bool _straddling;
+    };
+
     /// write_to_reference converts and writes events to a non-owned byte stream.
     template <type event_stream_type>
     class write_to_reference;
@@ -1350,6 +1875,512 @@ namespace sepia {
         capture_observable_exception.rethrow_unless<end_of_file>();
     }
 
+    /// mmap_observable maps a file to memory and dispatches events.
+    template <type event_stream_type, typename HandleEvent, typename HandleException, typename MustRestart>
+    class mmap_observable {
+        public:
+        mmap_observable(
+            const std::string& filename,
+            HandleEvent handle_event,
+            HandleException handle_exception,
+            MustRestart must_restart,
+            dispatch dispatch_events,
+            std::size_t chunk_size) :
+            _memory_map(filename),
+            _handle_event(std::forward<HandleEvent>(handle_event)),
+            _handle_exception(std::forward<HandleException>(handle_exception)),
+            _must_restart(std::forward<MustRestart>(must_restart)),
+            _dispatch_events(dispatch_events),
+            _chunk_size(chunk_size),
+            _running(true) {
+            auto event_stream = filename_to_ifstream(filename);
+            const auto header = read_header(*event_stream);
+            const auto header_size = static_cast<std::size_t>(event_stream->tellg());
+            if (header.event_stream_type != event_stream_type) {
+                throw unsupported_event_type();
+            }
+            _loop = std::thread([this, header, header_size]() {
+                try {
+                    switch (_dispatch_events) {
+                        case dispatch::synchronously_but_skip_offset: {
+                            auto offset_skipped = false;
+                            auto time_reference = std::chrono::system_clock::now();
+                            uint64_t initial_t = 0;
+                            uint64_t previous_t = 0;
+                            auto handle_event = [&](const event<event_stream_type>& event) {
+                                if (offset_skipped) {
+                                    if (event.t > previous_t) {
+                                        previous_t = event.t;
+                                        std::this_thread::sleep_until(
+                                            time_reference + std::chrono::microseconds(event.t - initial_t));
+                                    }
+                                } else {
+                                    offset_skipped = true;
+                                    initial_t = event.t;
+                                    previous_t = event.t;
+                                }
+                                _handle_event(event);
+                            };
+                            loop(header, header_size, handle_event, [&]() {
+                                offset_skipped = false;
+                                time_reference = std::chrono::system_clock::now();
+                            });
+                            break;
+                        }
+                        case dispatch::synchronously: {
+                            auto time_reference = std::chrono::system_clock::now();
+                            uint64_t previous_t = 0;
+                            auto handle_event = [&](const event<event_stream_type>& event) {
+                                if (event.t > previous_t) {
+                                    std::this_thread::sleep_until(time_reference + std::chrono::microseconds(event.t));
+                                }
+                                previous_t = event.t;
+                                _handle_event(event);
+                            };
+                            loop(header, header_size, handle_event, [&]() {
+                                time_reference = std::chrono::system_clock::now();
+                            });
+                            break;
+                        }
+                        case dispatch::as_fast_as_possible: {
+                            loop(header, header_size, _handle_event, []() {});
+                            break;
+                        }
+                    }
+                } catch (...) {
+                    _handle_exception(std::current_exception());
+                }
+            });
+        }
+        mmap_observable(const mmap_observable&) = delete;
+        mmap_observable(mmap_observable&&) = default;
+        mmap_observable& operator=(const mmap_observable&) = delete;
+        mmap_observable& operator=(mmap_observable&&) = default;
+        virtual ~mmap_observable() {
+            _running.store(false, std::memory_order_relaxed);
+            _loop.join();
+        }
+
+        protected:
+        /// loop decodes the mapped bytes chunk by chunk until the end of the file is reached.
+        template <typename HandleDecodedEvent, typename HandleRestart>
+        void loop(
+            const header& header,
+            std::size_t header_size,
+            HandleDecodedEvent& handle_decoded_event,
+            HandleRestart handle_restart) {
+            event<event_stream_type> event = {};
+            handle_bytes<event_stream_type> handle_bytes(header.width, header.height);
+            auto offset = header_size;
+            while (_running.load(std::memory_order_relaxed)) {
+                const auto size = (_memory_map.size() - offset < _chunk_size ? _memory_map.size() - offset : _chunk_size);
+                handle_bytes(
+                    _memory_map.data() + offset, _memory_map.data() + offset + size, event, handle_decoded_event);
+                offset += size;
+                if (offset == _memory_map.size()) {
+                    if (_must_restart()) {
+                        offset = header_size;
+                        handle_bytes.reset();
+                        event = {};
+                        handle_restart();
+                        continue;
+                    }
+                    throw end_of_file();
+                }
+            }
+        }
+
+        memory_map _memory_map;
+        HandleEvent _handle_event;
+        HandleException _handle_exception;
+        MustRestart _must_restart;
+        dispatch _dispatch_events;
+        std::size_t _chunk_size;
+        std::atomic_bool _running;
+        std::thread _loop;
+    };
+
+    /// make_mmap_observable creates a memory-mapped event stream observable from functors.
+    template <
+        type event_stream_type,
+        typename HandleEvent,
+        typename HandleException,
+        typename MustRestart = decltype(&false_function)>
+    inline std::unique_ptr<mmap_observable<event_stream_type, HandleEvent, HandleException, MustRestart>>
+    make_mmap_observable(
+        const std::string& filename,
+        HandleEvent handle_event,
+        HandleException handle_exception,
+        MustRestart must_restart = &false_function,
+        dispatch dispatch_events = dispatch::synchronously_but_skip_offset,
+        std::size_t chunk_size = 1 << 16) {
+        return sepia::make_unique<mmap_observable<event_stream_type, HandleEvent, HandleException, MustRestart>>(
+            filename,
+            std::forward<HandleEvent>(handle_event),
+            std::forward<HandleException>(handle_exception),
+            std::forward<MustRestart>(must_restart),
+            dispatch_events,
+            chunk_size);
+    }
+
+    /// join_observable creates a memory-mapped event stream observable from functors and blocks until the end
+    /// of the file is reached.
+    template <type event_stream_type, typename HandleEvent>
+    inline void join_observable(const std::string& filename, HandleEvent handle_event, std::size_t chunk_size = 1 << 16) {
+        capture_exception capture_observable_exception;
+        auto observable = make_mmap_observable<event_stream_type>(
+            filename,
+            std::forward<HandleEvent>(handle_event),
+            std::ref(capture_observable_exception),
+            &false_function,
+            dispatch::as_fast_as_possible,
+            chunk_size);
+        capture_observable_exception.wait();
+        capture_observable_exception.rethrow_unless<end_of_file>();
+    }
+
+    /// read_typed_header reads the header of the given file, checks its event type, and returns its size in bytes.
+    inline std::size_t read_typed_header(const std::string& filename, type event_stream_type, header& header) {
+        auto event_stream = filename_to_ifstream(filename);
+        header = read_header(*event_stream);
+        if (header.event_stream_type != event_stream_type) {
+            throw unsupported_event_type();
+        }
+        return static_cast<std::size_t>(event_stream->tellg());
+    }
+
+    /// index_entry locates a record boundary in an Event Stream file.
+    /// Decoding can resume at offset from the timestamp t, since no record straddles this position.
+    struct index_entry {
+        /// offset is the entry's position in the file, in bytes (header included).
+        uint64_t offset;
+
+        /// t is the timestamp of the last event before offset, or 0 if there is no such event.
+        uint64_t t;
+    };
+
+    /// join_batch_observable decodes a memory-mapped event stream chunk by chunk from the given index entry, and
+    /// calls handle_events with each chunk's events as a contiguous vector. It blocks until the end of the file is
+    /// reached. Events decoded before an exception are passed to handle_events before the exception is rethrown.
+    template <type event_stream_type, typename HandleEvents>
+    inline void join_batch_observable(
+        const std::string& filename,
+        index_entry first_entry,
+        HandleEvents handle_events,
+        std::size_t chunk_size = 1 << 16) {
+        const memory_map memory_map(filename);
+        header header;
+        read_typed_header(filename, event_stream_type, header);
+        handle_bytes<event_stream_type> handle_bytes(header.width, header.height);
+        std::vector<event<event_stream_type>> events;
+        event<event_stream_type> event = {};
+        event.t = first_entry.t;
+        for (auto offset = static_cast<std::size_t>(first_entry.offset); offset < memory_map.size();) {
+            const auto size = (memory_map.size() - offset < chunk_size ? memory_map.size() - offset : chunk_size);
+            events.clear();
+            try {
+                handle_bytes.append(memory_map.data() + offset, memory_map.data() + offset + size, event, events);
+            } catch (...) {
+                if (!events.empty()) {
+                    handle_events(static_cast<const std::vector<sepia::event<event_stream_type>>&>(events));
+                }
+                throw;
+            }
+            if (!events.empty()) {
+                handle_events(static_cast<const std::vector<sepia::event<event_stream_type>>&>(events));
+            }
+            offset += size;
+        }
+    }
+
+    /// join_batch_observable decodes a memory-mapped event stream chunk by chunk, and calls handle_events with each
+    /// chunk's events as a contiguous vector. It blocks until the end of the file is reached.
+    template <type event_stream_type, typename HandleEvents>
+    inline void
+    join_batch_observable(const std::string& filename, HandleEvents handle_events, std::size_t chunk_size = 1 << 16) {
+        header header;
+        const auto header_size = read_typed_header(filename, event_stream_type, header);
+        join_batch_observable<event_stream_type>(
+            filename, index_entry{header_size, 0}, std::forward<HandleEvents>(handle_events), chunk_size);
+    }
+
+    /// build_index decodes an event stream and records an entry about every bytes_per_entry bytes.
+    /// Each entry is placed on the first record boundary after its nominal position. The first entry points to the
+    /// first byte after the header.
+    template <type event_stream_type>
+    inline std::vector<index_entry> build_index(const std::string& filename, std::size_t bytes_per_entry = 1 << 20) {
+        const memory_map memory_map(filename);
+        header header;
+        const auto header_size = read_typed_header(filename, event_stream_type, header);
+        std::vector<index_entry> index{index_entry{header_size, 0}};
+        handle_bytes<event_stream_type> handle_bytes(header.width, header.height);
+        event<event_stream_type> event = {};
+        auto skip_event = [](const sepia::event<event_stream_type>&) {};
+        for (auto offset = header_size; offset < memory_map.size();) {
+            const auto size =
+                (memory_map.size() - offset < bytes_per_entry ? memory_map.size() - offset : bytes_per_entry);
+            handle_bytes(memory_map.data() + offset, memory_map.data() + offset + size, event, skip_event);
+            offset += size;
+            for (; !handle_bytes.is_idle() && offset < memory_map.size(); ++offset) {
+                handle_bytes(memory_map.data() + offset, memory_map.data() + offset + 1, event, skip_event);
+            }
+            if (offset < memory_map.size()) {
+                index.push_back(index_entry{offset, event.t});
+            }
+        }
+        return index;
+    }
+
+    /// index_signature returns the index file signature.
+    inline std::string index_signature() {
+        return "Event Stream Index";
+    }
+
+    /// index_filename returns the path of the index file associated with an Event Stream file.
+    inline std::string index_filename(const std::string& filename) {
+        return filename + ".index";
+    }
+
+    /// file_size returns the size of the given file in bytes.
+    inline uint64_t file_size(const std::string& filename) {
+        auto stream = filename_to_ifstream(filename);
+        stream->seekg(0, std::ifstream::end);
+        return static_cast<uint64_t>(stream->tellg());
+    }
+
+    /// file_modification_time returns the last modification time of the given file, in a platform-dependent unit.
+    inline uint64_t file_modification_time(const std::string& filename) {
+#ifdef _WIN32
+        WIN32_FILE_ATTRIBUTE_DATA attributes;
+        if (!GetFileAttributesExA(filename.c_str(), GetFileExInfoStandard, &attributes)) {
+            throw unreadable_file(filename);
+        }
+        return (static_cast<uint64_t>(attributes.ftLastWriteTime.dwHighDateTime) << 32)
+               | static_cast<uint64_t>(attributes.ftLastWriteTime.dwLowDateTime);
+#else
+        struct stat status;
+        if (stat(filename.c_str(), &status) != 0) {
+            throw unreadable_file(filename);
+        }
+        return static_cast<uint64_t>(status.st_mtime);
+#endif
+    }
+
+    /// file_fingerprint identifies the content of an Event Stream file for its index: the file size, its
+    /// modification time and a hash (FNV-1a) of its first bytes_per_block bytes, header included.
+    /// The size alone does not detect a file rewritten with a different content of the same length.
+    inline std::array<uint64_t, 3>
+    file_fingerprint(const std::string& filename, std::size_t bytes_per_block = 1 << 16) {
+        auto stream = filename_to_ifstream(filename);
+        std::vector<char> block(bytes_per_block);
+        stream->read(block.data(), block.size());
+        uint64_t hash = 0xcbf29ce484222325;
+        for (std::streamsize index = 0; index < stream->gcount(); ++index) {
+            hash = (hash ^ static_cast<uint8_t>(block[static_cast<std::size_t>(index)])) * 0x100000001b3;
+        }
+        return {{file_size(filename), file_modification_time(filename), hash}};
+    }
+
+    /// write_index writes the index of an Event Stream file to its index file.
+    /// The index is written to a temporary file first, so that concurrent readers never see a partial index.
+    template <type event_stream_type>
+    inline void write_index(const std::string& filename, const std::vector<index_entry>& index) {
+        const auto temporary_filename =
+            index_filename(filename) + "."
+            + std::to_string(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+        {
+            auto index_stream = filename_to_ofstream(temporary_filename);
+            index_stream->write(index_signature().data(), index_signature().size());
+            index_stream->put(static_cast<char>(event_stream_type));
+            auto write_uint64 = [&](uint64_t value) {
+                std::array<uint8_t, 8> bytes;
+                for (auto& byte : bytes) {
+                    byte = static_cast<uint8_t>(value & 0b11111111);
+                    value >>= 8;
+                }
+                index_stream->write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+            };
+            for (const auto value : file_fingerprint(filename)) {
+                write_uint64(value);
+            }
+            write_uint64(index.size());
+            for (const auto& entry : index) {
+                write_uint64(entry.offset);
+                write_uint64(entry.t);
+            }
+            if (!index_stream->good()) {
+                throw unwritable_file(temporary_filename);
+            }
+        }
+        if (std::rename(temporary_filename.c_str(), index_filename(filename).c_str()) != 0) {
+            std::remove(temporary_filename.c_str());
+            throw unwritable_file(index_filename(filename));
+        }
+    }
+
+    /// read_index reads the index of an Event Stream file from its index file.
+    /// An empty vector is returned if the index file does not exist, or does not match the Event Stream file's
+    /// fingerprint (see file_fingerprint).
+    template <type event_stream_type>
+    inline std::vector<index_entry> read_index(const std::string& filename) {
+        std::ifstream index_stream(index_filename(filename), std::ifstream::binary);
+        if (!index_stream.good()) {
+            return {};
+        }
+        auto read_signature = index_signature();
+        index_stream.read(&read_signature[0], read_signature.size());
+        if (!index_stream.good() || read_signature != index_signature()
+            || index_stream.get() != static_cast<int>(event_stream_type)) {
+            return {};
+        }
+        auto read_uint64 = [&]() {
+            std::array<uint8_t, 8> bytes;
+            index_stream.read(reinterpret_cast<char*>(bytes.data()), bytes.size());
+            uint64_t value = 0;
+            for (auto byte = bytes.rbegin(); byte != bytes.rend(); ++byte) {
+                value = (value << 8) | *byte;
+            }
+            return value;
+        };
+        for (const auto value : file_fingerprint(filename)) {
+            if (read_uint64() != value) {
+                return {};
+            }
+        }
+        const auto size = read_uint64();
+        std::vector<index_entry> index;
+        while (index.size() < size) {
+            const auto offset = read_uint64();
+            const auto t = read_uint64();
+            if (!index_stream.good()) {
+                return {};
+            }
+            index.push_back(index_entry{offset, t});
+        }
+        return index;
+    }
+
+    /// load_index reads the index of an Event Stream file, or builds it if the index file is missing or stale.
+    /// Built indices are written next to the Event Stream file when possible.
+    template <type event_stream_type>
+    inline std::vector<index_entry> load_index(const std::string& filename, std::size_t bytes_per_entry = 1 << 20) {
+        auto index = read_index<event_stream_type>(filename);
+        if (index.empty()) {
+            index = build_index<event_stream_type>(filename, bytes_per_entry);
+            try {
+                write_index<event_stream_type>(filename, index);
+            } catch (const unwritable_file&) {
+            }
+        }
+        return index;
+    }
+
+    /// find_index_entry returns the last entry whose timestamp is strictly smaller than t, or the first entry.
+    /// Decoding from the returned entry yields every event whose timestamp is larger than or equal to t.
+    inline index_entry find_index_entry(const std::vector<index_entry>& index, uint64_t t) {
+        const auto entry = std::lower_bound(
+            index.begin(), index.end(), t, [](const index_entry& entry, uint64_t t) { return entry.t < t; });
+        return entry == index.begin() ? *entry : *std::prev(entry);
+    }
+
+    /// join_parallel_batch_observable decodes a memory-mapped event stream with several threads, using the index to
+    /// split the file on record boundaries. handle_events is called on the calling thread, once per index segment and
+    /// in file order. Events decoded before an exception are passed to handle_events before the exception is rethrown.
+    /// The threads decode at most 2 * number_of_threads segments ahead of the one passed to handle_events, so that
+    /// memory usage does not depend on the file size when handle_events is slower than decoding.
+    template <type event_stream_type, typename HandleEvents>
+    inline void join_parallel_batch_observable(
+        const std::string& filename,
+        const std::vector<index_entry>& index,
+        HandleEvents handle_events,
+        std::size_t number_of_threads = std::thread::hardware_concurrency()) {
+        const memory_map memory_map(filename);
+        header header;
+        read_typed_header(filename, event_stream_type, header);
+        std::vector<std::vector<event<event_stream_type>>> segments(index.size());
+        std::vector<std::exception_ptr> exceptions(index.size());
+        std::vector<uint8_t> decoded(index.size(), 0);
+        std::atomic<std::size_t> next_segment(0);
+        if (number_of_threads == 0) {
+            number_of_threads = 1;
+        }
+        const auto window = 2 * number_of_threads;
+        std::size_t consumed = 0;
+        bool stopped = false;
+        std::mutex mutex;
+        std::condition_variable condition_variable;
+        std::vector<std::thread> threads;
+        for (std::size_t thread_index = 0; thread_index < number_of_threads; ++thread_index) {
+            threads.emplace_back([&]() {
+                for (auto segment = next_segment.fetch_add(1); segment < index.size();
+                     segment = next_segment.fetch_add(1)) {
+                    {
+                        std::unique_lock<std::mutex> lock(mutex);
+                        condition_variable.wait(lock, [&]() { return segment < consumed + window || stopped; });
+                        if (stopped) {
+                            break;
+                        }
+                    }
+                    handle_bytes<event_stream_type> handle_bytes(header.width, header.height);
+                    event<event_stream_type> event = {};
+                    event.t = index[segment].t;
+                    const auto end =
+                        (segment + 1 < index.size() ? static_cast<std::size_t>(index[segment + 1].offset) :
+                                                      memory_map.size());
+                    try {
+                        handle_bytes.append(
+                            memory_map.data() + index[segment].offset,
+                            memory_map.data() + end,
+                            event,
+                            segments[segment]);
+                    } catch (...) {
+                        exceptions[segment] = std::current_exception();
+                    }
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        decoded[segment] = 1;
+                    }
+                    condition_variable.notify_all();
+                }
+            });
+        }
+        std::exception_ptr exception;
+        for (std::size_t segment = 0; segment < index.size(); ++segment) {
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                condition_variable.wait(lock, [&]() { return decoded[segment] == 1; });
+            }
+            try {
+                if (!segments[segment].empty()) {
+                    handle_events(
+                        static_cast<const std::vector<sepia::event<event_stream_type>>&>(segments[segment]));
+                }
+            } catch (...) {
+                exception = std::current_exception();
+            }
+            std::vector<event<event_stream_type>>().swap(segments[segment]);
+            if (!exception) {
+                exception = exceptions[segment];
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                consumed = segment + 1;
+                stopped = static_cast<bool>(exception);
+            }
+            condition_variable.notify_all();
+            if (exception) {
+                next_segment.store(index.size());
+                break;
+            }
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
     /// forward-declare parameter for referencing in unvalidated_parameter.
     class parameter;
 
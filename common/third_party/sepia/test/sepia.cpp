@@ -1,6 +1,7 @@
 #define CATCH_CONFIG_MAIN
 #include "../source/sepia.hpp"
 #include "../third_party/Catch2/single_include/catch.hpp"
+#include <cstring>
 #include <sstream>
 
 const std::string examples = sepia::join({sepia::dirname(SEPIA_DIRNAME), "third_party", "event_stream", "examples"});
@@ -163,6 +164,207 @@ TEST_CASE("write color events", "[sepia::write<sepia::type::color>]") {
     REQUIRE(std::strcmp(bytes.c_str(), output_bytes.c_str()) == 0);
 }
 
+TEST_CASE("memory-map DVS events", "[sepia::join_observable<sepia::type::dvs>]") {
+    const auto filename = sepia::join({examples, "dvs.es"});
+    std::vector<sepia::dvs_event> events;
+    sepia::join_observable<sepia::type::dvs>(
+        sepia::filename_to_ifstream(filename), [&](sepia::dvs_event dvs_event) -> void { events.push_back(dvs_event); });
+    for (const std::size_t chunk_size : {static_cast<std::size_t>(7), static_cast<std::size_t>(1 << 16)}) {
+        std::vector<sepia::dvs_event> mapped_events;
+        sepia::join_observable<sepia::type::dvs>(
+            filename, [&](sepia::dvs_event dvs_event) -> void { mapped_events.push_back(dvs_event); }, chunk_size);
+        REQUIRE(events.size() == mapped_events.size());
+        REQUIRE(std::memcmp(events.data(), mapped_events.data(), events.size() * sizeof(sepia::dvs_event)) == 0);
+    }
+}
+
+TEST_CASE("memory-map ATIS events", "[sepia::join_observable<sepia::type::atis>]") {
+    const auto filename = sepia::join({examples, "atis.es"});
+    std::vector<sepia::atis_event> events;
+    sepia::join_observable<sepia::type::atis>(
+        sepia::filename_to_ifstream(filename), [&](sepia::atis_event atis_event) -> void { events.push_back(atis_event); });
+    for (const std::size_t chunk_size : {static_cast<std::size_t>(7), static_cast<std::size_t>(1 << 16)}) {
+        std::vector<sepia::atis_event> mapped_events;
+        sepia::join_observable<sepia::type::atis>(
+            filename, [&](sepia::atis_event atis_event) -> void { mapped_events.push_back(atis_event); }, chunk_size);
+        REQUIRE(events.size() == mapped_events.size());
+        REQUIRE(std::memcmp(events.data(), mapped_events.data(), events.size() * sizeof(sepia::atis_event)) == 0);
+    }
+}
+
+TEST_CASE("memory-map color events", "[sepia::join_observable<sepia::type::color>]") {
+    const auto filename = sepia::join({examples, "color.es"});
+    std::vector<sepia::color_event> events;
+    sepia::join_observable<sepia::type::color>(
+        sepia::filename_to_ifstream(filename), [&](sepia::color_event color_event) -> void { events.push_back(color_event); });
+    for (const std::size_t chunk_size : {static_cast<std::size_t>(7), static_cast<std::size_t>(1 << 16)}) {
+        std::vector<sepia::color_event> mapped_events;
+        sepia::join_observable<sepia::type::color>(
+            filename, [&](sepia::color_event color_event) -> void { mapped_events.push_back(color_event); }, chunk_size);
+        REQUIRE(events.size() == mapped_events.size());
+        REQUIRE(std::memcmp(events.data(), mapped_events.data(), events.size() * sizeof(sepia::color_event)) == 0);
+    }
+}
+
+TEST_CASE("batch-decode DVS events", "[sepia::join_batch_observable<sepia::type::dvs>]") {
+    const auto filename = sepia::join({examples, "dvs.es"});
+    std::vector<sepia::dvs_event> events;
+    {
+        auto event_stream = sepia::filename_to_ifstream(filename);
+        const auto header = sepia::read_header(*event_stream);
+        sepia::handle_byte<sepia::type::dvs> handle_byte(header.width, header.height);
+        sepia::dvs_event dvs_event = {};
+        for (auto byte = event_stream->get(); !event_stream->eof(); byte = event_stream->get()) {
+            if (handle_byte(static_cast<uint8_t>(byte), dvs_event)) {
+                events.push_back(dvs_event);
+            }
+        }
+    }
+    for (const std::size_t chunk_size :
+         {static_cast<std::size_t>(1), static_cast<std::size_t>(33), static_cast<std::size_t>(1 << 16)}) {
+        std::vector<sepia::dvs_event> batch_events;
+        sepia::join_batch_observable<sepia::type::dvs>(
+            filename,
+            [&](const std::vector<sepia::dvs_event>& dvs_events) -> void {
+                batch_events.insert(batch_events.end(), dvs_events.begin(), dvs_events.end());
+            },
+            chunk_size);
+        REQUIRE(events.size() == batch_events.size());
+        REQUIRE(std::memcmp(events.data(), batch_events.data(), events.size() * sizeof(sepia::dvs_event)) == 0);
+    }
+}
+
+TEST_CASE("batch-decode ATIS events", "[sepia::join_batch_observable<sepia::type::atis>]") {
+    const auto filename = sepia::join({examples, "atis.es"});
+    std::vector<sepia::atis_event> events;
+    {
+        auto event_stream = sepia::filename_to_ifstream(filename);
+        const auto header = sepia::read_header(*event_stream);
+        sepia::handle_byte<sepia::type::atis> handle_byte(header.width, header.height);
+        sepia::atis_event atis_event = {};
+        for (auto byte = event_stream->get(); !event_stream->eof(); byte = event_stream->get()) {
+            if (handle_byte(static_cast<uint8_t>(byte), atis_event)) {
+                events.push_back(atis_event);
+            }
+        }
+    }
+    for (const std::size_t chunk_size :
+         {static_cast<std::size_t>(1), static_cast<std::size_t>(33), static_cast<std::size_t>(1 << 16)}) {
+        std::vector<sepia::atis_event> batch_events;
+        sepia::join_batch_observable<sepia::type::atis>(
+            filename,
+            [&](const std::vector<sepia::atis_event>& atis_events) -> void {
+                batch_events.insert(batch_events.end(), atis_events.begin(), atis_events.end());
+            },
+            chunk_size);
+        REQUIRE(events.size() == batch_events.size());
+        REQUIRE(std::memcmp(events.data(), batch_events.data(), events.size() * sizeof(sepia::atis_event)) == 0);
+    }
+}
+
+TEST_CASE("batch-decode color events", "[sepia::join_batch_observable<sepia::type::color>]") {
+    const auto filename = sepia::join({examples, "color.es"});
+    std::vector<sepia::color_event> events;
+    {
+        auto event_stream = sepia::filename_to_ifstream(filename);
+        const auto header = sepia::read_header(*event_stream);
+        sepia::handle_byte<sepia::type::color> handle_byte(header.width, header.height);
+        sepia::color_event color_event = {};
+        for (auto byte = event_stream->get(); !event_stream->eof(); byte = event_stream->get()) {
+            if (handle_byte(static_cast<uint8_t>(byte), color_event)) {
+                events.push_back(color_event);
+            }
+        }
+    }
+    for (const std::size_t chunk_size :
+         {static_cast<std::size_t>(1), static_cast<std::size_t>(33), static_cast<std::size_t>(1 << 16)}) {
+        std::vector<sepia::color_event> batch_events;
+        sepia::join_batch_observable<sepia::type::color>(
+            filename,
+            [&](const std::vector<sepia::color_event>& color_events) -> void {
+                batch_events.insert(batch_events.end(), color_events.begin(), color_events.end());
+            },
+            chunk_size);
+        REQUIRE(events.size() == batch_events.size());
+        REQUIRE(std::memcmp(events.data(), batch_events.data(), events.size() * sizeof(sepia::color_event)) == 0);
+    }
+}
+
+TEST_CASE("batch-decode DVS coordinates overflow", "[sepia::handle_bytes<sepia::type::dvs>]") {
+    // runs of valid records surround the overflowing one, so that the vectorized path reaches it
+    for (const bool overflow_x : {true, false}) {
+        std::vector<uint8_t> bytes;
+        for (uint8_t index = 0; index < 64; ++index) {
+            const uint16_t x = index == 32 && overflow_x ? 16 : index % 16;
+            const uint16_t y = index == 32 && !overflow_x ? 16 : (index * 3) % 16;
+            bytes.insert(
+                bytes.end(),
+                {static_cast<uint8_t>(((index % 5) << 1) | (index & 1)),
+                 static_cast<uint8_t>(x & 0b11111111),
+                 static_cast<uint8_t>(x >> 8),
+                 static_cast<uint8_t>(y & 0b11111111),
+                 static_cast<uint8_t>(y >> 8)});
+        }
+        std::vector<sepia::dvs_event> events;
+        {
+            sepia::handle_byte<sepia::type::dvs> handle_byte(16, 16);
+            sepia::dvs_event dvs_event = {};
+            REQUIRE_THROWS_AS(
+                [&]() {
+                    for (const auto byte : bytes) {
+                        if (handle_byte(byte, dvs_event)) {
+                            events.push_back(dvs_event);
+                        }
+                    }
+                }(),
+                sepia::coordinates_overflow);
+        }
+        REQUIRE(events.size() == 32);
+        std::vector<sepia::dvs_event> batch_events;
+        sepia::handle_bytes<sepia::type::dvs> handle_bytes(16, 16);
+        sepia::dvs_event dvs_event = {};
+        REQUIRE_THROWS_AS(
+            handle_bytes.append(bytes.data(), bytes.data() + bytes.size(), dvs_event, batch_events),
+            sepia::coordinates_overflow);
+        REQUIRE(events.size() == batch_events.size());
+        REQUIRE(std::memcmp(events.data(), batch_events.data(), events.size() * sizeof(sepia::dvs_event)) == 0);
+    }
+}
+
+TEST_CASE("index DVS events", "[sepia::join_parallel_batch_observable<sepia::type::dvs>]") {
+    const auto filename = sepia::join({examples, "dvs.es"});
+    std::vector<sepia::dvs_event> events;
+    sepia::join_observable<sepia::type::dvs>(
+        sepia::filename_to_ifstream(filename), [&](sepia::dvs_event dvs_event) -> void { events.push_back(dvs_event); });
+    const auto index = sepia::build_index<sepia::type::dvs>(filename, 1 << 10);
+    REQUIRE(index.size() > 1);
+    for (const std::size_t number_of_threads : {static_cast<std::size_t>(1), static_cast<std::size_t>(4)}) {
+        std::vector<sepia::dvs_event> parallel_events;
+        sepia::join_parallel_batch_observable<sepia::type::dvs>(
+            filename,
+            index,
+            [&](const std::vector<sepia::dvs_event>& dvs_events) -> void {
+                parallel_events.insert(parallel_events.end(), dvs_events.begin(), dvs_events.end());
+            },
+            number_of_threads);
+        REQUIRE(events.size() == parallel_events.size());
+        REQUIRE(std::memcmp(events.data(), parallel_events.data(), events.size() * sizeof(sepia::dvs_event)) == 0);
+    }
+    const auto t = events[events.size() / 2].t;
+    std::vector<sepia::dvs_event> seeked_events;
+    sepia::join_batch_observable<sepia::type::dvs>(
+        filename, sepia::find_index_entry(index, t), [&](const std::vector<sepia::dvs_event>& dvs_events) -> void {
+            seeked_events.insert(seeked_events.end(), dvs_events.begin(), dvs_events.end());
+        });
+    REQUIRE(seeked_events.size() >= events.size() - events.size() / 2);
+    REQUIRE(
+        std::memcmp(
+            seeked_events.data(),
+            events.data() + (events.size() - seeked_events.size()),
+            seeked_events.size() * sizeof(sepia::dvs_event))
+        == 0);
+}
+
 TEST_CASE("parse JSON parameters", "[sepia::parameter]") {
     auto parameter = sepia::make_unique<sepia::object_parameter>(
         "key 0",
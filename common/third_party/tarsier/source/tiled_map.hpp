@@ -0,0 +1,209 @@
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+/// tarsier is a collection of event handlers.
+namespace tarsier {
+    /// tiled_map stores a value per pixel, and groups the pixels in tiles of tile_width x tile_height stored
+    /// contiguously. A window around a pixel then spans fewer cache lines than with a row-major layout.
+    /// A tile_height of 1 yields the row-major layout.
+    template <typename T, uint16_t tile_width = 8, uint16_t tile_height = 8>
+    class tiled_map {
+        public:
+        static_assert(tile_width > 0 && tile_height > 0, "the tiles must not be empty");
+
+        /// padding adds elements after the last tile, so that vector operations may read past the end of a segment.
+        tiled_map(uint16_t width, uint16_t height, T value = T(), std::size_t padding = 0) :
+            _width(width),
+            _height(height),
+            _tiles_per_row((width + tile_width - 1) / tile_width),
+            _values(
+                static_cast<std::size_t>(_tiles_per_row) * ((height + tile_height - 1) / tile_height) * tile_size
+                    + padding,
+                value) {}
+        tiled_map(const tiled_map&) = default;
+        tiled_map(tiled_map&&) = default;
+        tiled_map& operator=(const tiled_map&) = default;
+        tiled_map& operator=(tiled_map&&) = default;
+        ~tiled_map() {}
+
+        /// width returns the number of pixels per row.
+        uint16_t width() const {
+            return _width;
+        }
+
+        /// height returns the number of rows.
+        uint16_t height() const {
+            return _height;
+        }
+
+        /// index returns the position of the given pixel in the underlying vector.
+        std::size_t index(uint16_t x, uint16_t y) const {
+            return (static_cast<std::size_t>(x / tile_width) + static_cast<std::size_t>(y / tile_height) * _tiles_per_row)
+                       * tile_size
+                   + (x % tile_width) + (y % tile_height) * tile_width;
+        }
+
+        /// operator[] returns the value at the given index.
+        T& operator[](std::size_t index) {
+            return _values[index];
+        }
+
+        /// operator[] returns the value at the given index.
+        const T& operator[](std::size_t index) const {
+            return _values[index];
+        }
+
+        /// at returns the value of the given pixel.
+        T& at(uint16_t x, uint16_t y) {
+            return _values[index(x, y)];
+        }
+
+        /// at returns the value of the given pixel.
+        const T& at(uint16_t x, uint16_t y) const {
+            return _values[index(x, y)];
+        }
+
+        /// values returns the underlying vector, which includes the padding and the incomplete tiles' extra pixels.
+        std::vector<T>& values() {
+            return _values;
+        }
+
+        /// for_each_segment calls handle_segment(T* begin, uint16_t x, uint16_t y, uint16_t length) for each run of
+        /// contiguous pixels in the window [x_begin, x_end) x [y_begin, y_end), in row-major order.
+        template <typename HandleSegment>
+        void for_each_segment(
+            uint16_t x_begin,
+            uint16_t x_end,
+            uint16_t y_begin,
+            uint16_t y_end,
+            HandleSegment handle_segment) {
+            for (auto y = y_begin; y < y_end; ++y) {
+                if (tile_height == 1) {
+                    handle_segment(&_values[index(x_begin, y)], x_begin, y, static_cast<uint16_t>(x_end - x_begin));
+                } else {
+                    for (auto x = x_begin; x < x_end;) {
+                        const uint16_t length =
+                            (x_end - x < tile_width - x % tile_width ? x_end - x : tile_width - x % tile_width);
+                        handle_segment(&_values[index(x, y)], x, y, length);
+                        x += length;
+                    }
+                }
+            }
+        }
+
+        /// for_each_segment_around calls for_each_segment on the square window with the given radius centred on
+        /// (x, y), clipped by the map's borders.
+        template <typename HandleSegment>
+        void for_each_segment_around(uint16_t x, uint16_t y, uint16_t radius, HandleSegment handle_segment) {
+            for_each_segment(
+                (x <= radius ? 0 : x - radius),
+                (x >= _width - 1 - radius ? _width - 1 : x + radius) + 1,
+                (y <= radius ? 0 : y - radius),
+                (y >= _height - 1 - radius ? _height - 1 : y + radius) + 1,
+                handle_segment);
+        }
+
+        protected:
+        /// tile_size is the number of pixels in a tile.
+        static constexpr std::size_t tile_size = static_cast<std::size_t>(tile_width) * tile_height;
+
+        uint16_t _width;
+        uint16_t _height;
+        std::size_t _tiles_per_row;
+        std::vector<T> _values;
+    };
+
+    /// flat_map is a tiled_map with the row-major layout.
+    template <typename T>
+    using flat_map = tiled_map<T, 1, 1>;
+
+    /// ts_map stores a timestamp per pixel in a tiled_map.
+    /// The default layout is row-major, which was the fastest in the layouts benchmark. Tiles are opt-in.
+    /// If Stored is smaller than 64 bits (for instance uint32_t), timestamps are stored relatively to an epoch, which
+    /// reduces the map's footprint. When a timestamp does not fit, the epoch moves to half the range below it, and
+    /// older timestamps are clamped to the new epoch. Handlers must therefore compare timestamps within windows
+    /// shorter than half the range (about 35 minutes with uint32_t and microseconds).
+    template <typename Stored = uint64_t, uint16_t tile_width = 1, uint16_t tile_height = 1>
+    class ts_map {
+        public:
+        static_assert(
+            std::is_unsigned<Stored>::value && sizeof(Stored) <= sizeof(uint64_t),
+            "the stored type must be an unsigned integer with at most 64 bits");
+
+        /// stored_type is the type of the underlying values.
+        typedef Stored stored_type;
+
+        ts_map(uint16_t width, uint16_t height, std::size_t padding = 0) :
+            _map(width, height, 0, padding),
+            _epoch(0) {}
+        ts_map(const ts_map&) = default;
+        ts_map(ts_map&&) = default;
+        ts_map& operator=(const ts_map&) = default;
+        ts_map& operator=(ts_map&&) = default;
+        ~ts_map() {}
+
+        /// index returns the position of the given pixel.
+        std::size_t index(uint16_t x, uint16_t y) const {
+            return _map.index(x, y);
+        }
+
+        /// get returns the timestamp at the given index.
+        uint64_t get(std::size_t index) const {
+            return decode(_map[index]);
+        }
+
+        /// set changes the timestamp at the given index.
+        void set(std::size_t index, uint64_t t) {
+            if (relative) {
+                if (t < _epoch) {
+                    _map[index] = 0;
+                    return;
+                }
+                if (t - _epoch > std::numeric_limits<Stored>::max()) {
+                    rebase(t - half_range);
+                }
+            }
+            _map[index] = static_cast<Stored>(relative ? t - _epoch : t);
+        }
+
+        /// decode converts a stored value to a timestamp.
+        uint64_t decode(Stored value) const {
+            return relative ? _epoch + value : value;
+        }
+
+        /// epoch returns the timestamp that corresponds to a stored zero.
+        uint64_t epoch() const {
+            return _epoch;
+        }
+
+        /// for_each_segment_around calls handle_segment(const Stored* begin, uint16_t x, uint16_t y, uint16_t length)
+        /// for each run of contiguous pixels in the window centred on (x, y), in row-major order.
+        template <typename HandleSegment>
+        void for_each_segment_around(uint16_t x, uint16_t y, uint16_t radius, HandleSegment handle_segment) {
+            _map.for_each_segment_around(x, y, radius, handle_segment);
+        }
+
+        protected:
+        /// relative is true if timestamps are stored as offsets from the epoch.
+        static constexpr bool relative = sizeof(Stored) < sizeof(uint64_t);
+
+        /// half_range is the distance between a rebased epoch and the timestamp that triggered the rebase.
+        static constexpr uint64_t half_range = (static_cast<uint64_t>(std::numeric_limits<Stored>::max()) >> 1) + 1;
+
+        /// rebase moves the epoch forward, and clamps the values older than the new epoch.
+        void rebase(uint64_t epoch) {
+            const auto delta = epoch - _epoch;
+            for (auto& value : _map.values()) {
+                value = (value < delta ? 0 : static_cast<Stored>(value - delta));
+            }
+            _epoch = epoch;
+        }
+
+        tiled_map<Stored, tile_width, tile_height> _map;
+        uint64_t _epoch;
+    };
+}
@@ -44,6 +44,10 @@ enum caer_module_status {
  * Explicit output streams in this case are new data that is declared
  * as output event stream explicitly, while implicit are input streams
  * with their 'readOnly' flag set to false, meaning the data is modified.
+ * Modules that modify an input only through the libcaer packet pool
+ * (caerPacketPoolMakeWritable() before the first change) can also set
+ * the 'copyOnWrite' flag, so that input data needed by other modules
+ * is shared with them instead of being copied on every run.
  * Output streams can either be undefined and later be determined at
  * runtime, or be well defined. Only one output stream per type is allowed.
  */
@@ -74,9 +78,10 @@ static inline const char *caerModuleTypeToString(enum caer_module_type type) {
 }
 
 struct caer_event_stream_in {
-	int16_t type;   // Use -1 for any type.
-	int16_t number; // Use -1 for any number of.
-	bool readOnly;  // True if input is never modified.
+	int16_t type;     // Use -1 for any type.
+	int16_t number;   // Use -1 for any number of.
+	bool readOnly;    // True if input is never modified.
+	bool copyOnWrite; // True if input is only modified after caerPacketPoolMakeWritable().
 };
 
 typedef struct caer_event_stream_in const *caerEventStreamIn;
@@ -37,7 +37,7 @@ static const struct caer_event_stream_in benchmark_activity_sink_inputs[] = {{
 static const struct caer_module_info benchmark_activity_sink_info = {
     .version = 1,
     .name = "benchmark_activity_sink",
-    .description = "Stores events in RAM",
+    .description = "Hashes events as they arrive",
     .type = CAER_MODULE_OUTPUT,
     .memSize = sizeof(struct benchmark_activity_sink_state_struct),
     .functions = &benchmark_activity_sink_functions,
@@ -5,23 +5,25 @@ benchmark_activity_sink::benchmark_activity_sink(char* filename, std::size_t num
     _filename(filename),
     _number_of_packets(number_of_packets),
     _received_packets(0),
-    _end_t(0) {
-    _activities.reserve(number_of_events);
+    _end_t(0),
+    _trace_stage(benchmark::trace_stage("sink")) {
+    _output_sink.reserve(number_of_events);
 }
 
 benchmark_activity_sink::~benchmark_activity_sink() {
     std::ofstream output(_filename);
-    benchmark::activities_to_json(output, _end_t, _activities);
+    _output_sink.to_json(output, _end_t);
 }
 
 void benchmark_activity_sink::add_packet(caerEventPacketContainer container) {
+    benchmark::trace_scope scope(_trace_stage);
     if (container) {
         auto packet = reinterpret_cast<caerPoint2DEventPacket>(caerEventPacketContainerFindEventPacketByType(container, POINT2D_EVENT));
         for (int32_t index = 0; index < caerEventPacketHeaderGetEventNumber(&(packet->packetHeader)); ++index) {
     		caerPoint2DEventConst event = caerPoint2DEventPacketGetEventConst(packet, index);
     		if (caerPoint2DEventIsValid(event)) {
                 const float xy = caerPoint2DEventGetY(event);
-                _activities.push_back({
+                _output_sink({
                     static_cast<uint64_t>(caerPoint2DEventGetTimestamp64(event, packet)),
                     caerPoint2DEventGetX(event),
                     *reinterpret_cast<const uint16_t*>(&xy),
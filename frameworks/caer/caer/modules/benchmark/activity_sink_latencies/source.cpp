@@ -1,33 +1,38 @@
 #include "source.hpp"
 #include <signal.h>
 
-benchmark_activity_sink_latencies::benchmark_activity_sink_latencies(char* filename, std::size_t number_of_packets, std::size_t number_of_events) :
+benchmark_activity_sink_latencies::benchmark_activity_sink_latencies(char* filename, benchmark_reader_latencies* reader) :
     _filename(filename),
-    _number_of_packets(number_of_packets),
-    _received_packets(0) {
-    _activities.reserve(number_of_events);
-    _points.reserve(number_of_events);
+    _reader(reader),
+    _number_of_packets(reader->number_of_packets()),
+    _received_packets(0),
+    _trace_stage(benchmark::trace_stage("sink")) {
+    _latency_sink.reserve(reader->number_of_events());
 }
 
 benchmark_activity_sink_latencies::~benchmark_activity_sink_latencies() {
     std::ofstream output(_filename);
-    benchmark::activities_latencies_to_json(output, _activities, _points);
+    _latency_sink.to_json(output);
+    _latency_sink.write_points();
 }
 
 void benchmark_activity_sink_latencies::add_packet(caerEventPacketContainer container) {
+    benchmark::trace_scope scope(_trace_stage);
     if (container) {
+        if (!_latency_sink.started()) {
+            _latency_sink.start(_reader->packets_ts(), _reader->time_0(), _reader->speed());
+        }
         auto packet = reinterpret_cast<caerPoint2DEventPacket>(caerEventPacketContainerFindEventPacketByType(container, POINT2D_EVENT));
         for (int32_t index = 0; index < caerEventPacketHeaderGetEventNumber(&(packet->packetHeader)); ++index) {
     		caerPoint2DEventConst event = caerPoint2DEventPacketGetEventConst(packet, index);
     		if (caerPoint2DEventIsValid(event)) {
                 const float xy = caerPoint2DEventGetY(event);
-                _activities.push_back({
+                _latency_sink({
                     static_cast<uint64_t>(caerPoint2DEventGetTimestamp64(event, packet)),
                     caerPoint2DEventGetX(event),
                     *reinterpret_cast<const uint16_t*>(&xy),
                     *(reinterpret_cast<const uint16_t*>(&xy) + 1),
                 });
-                _points.emplace_back(static_cast<uint64_t>(_activities.back().t), benchmark::now());
     		}
         }
     }
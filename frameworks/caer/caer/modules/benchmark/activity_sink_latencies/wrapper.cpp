@@ -2,6 +2,6 @@
 #include "source.hpp"
 #include "wrapper.h"
 
-BENCHMARK_WRAP_CONSTRUCT_3(benchmark_activity_sink_latencies, char*, std::size_t, std::size_t)
+BENCHMARK_WRAP_CONSTRUCT_2(benchmark_activity_sink_latencies, char*, benchmark_reader_latencies*)
 BENCHMARK_WRAP_DESTRUCT(benchmark_activity_sink_latencies)
 BENCHMARK_WRAP_VOID_1(benchmark_activity_sink_latencies, add_packet, caerEventPacketContainer)
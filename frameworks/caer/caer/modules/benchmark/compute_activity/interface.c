@@ -17,8 +17,6 @@ static struct caer_module_functions benchmark_compute_activity_functions = {
 };
 
 static void benchmark_compute_activity_config_init(sshsNode module_node) {
-    sshsNodeCreateInt(module_node, "width", 304, 0, 304, SSHS_FLAGS_NORMAL, "window width");
-    sshsNodeCreateInt(module_node, "height", 240, 0, 240, SSHS_FLAGS_NORMAL, "window height");
     sshsNodeCreateFloat(module_node, "decay", 1e3, 0, 1e7, SSHS_FLAGS_NORMAL, "exponential decay");
 }
 
@@ -50,10 +48,14 @@ caerModuleInfo caerModuleGetInfo() {
 }
 
 static bool benchmark_compute_activity_init(caerModuleData module_data) {
+    sshsNode source_info = caerMainloopModuleGetSourceInfoForInput(module_data->moduleID, 0);
+    if (source_info == NULL) {
+        return false;
+    }
     benchmark_compute_activity_state state = module_data->moduleState;
     state->benchmark_compute_activity_instance = benchmark_compute_activity_construct(
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "width")),
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "height")),
+        (uint16_t)(sshsNodeGetInt(source_info, "dataSizeX")),
+        (uint16_t)(sshsNodeGetInt(source_info, "dataSizeY")),
         (float)(sshsNodeGetFloat(module_data->moduleNode, "decay")));
     sshsNodeAddAttributeListener(module_data->moduleNode, module_data, &caerModuleConfigDefaultListener);
     caerMainloopDataNotifyIncrease(NULL);
@@ -6,16 +6,17 @@ benchmark_compute_activity::benchmark_compute_activity(
     float decay) :
     _width(width),
     _decay(decay),
-    _potentials_and_ts(width * height, {0.0f, 0}) {}
+    _potentials_and_ts(width * height, {0.0f, 0}),
+    _trace_stage(benchmark::trace_stage("compute_activity")) {}
 
 void benchmark_compute_activity::handle_packet(caerEventPacketContainer in, caerEventPacketContainer* out) {
+    benchmark::trace_scope scope(_trace_stage);
     auto packet = reinterpret_cast<caerPoint3DEventPacket>(caerEventPacketContainerFindEventPacketByType(in, POINT3D_EVENT));
     if (packet && packet->packetHeader.eventValid) {
-        *out = caerEventPacketContainerAllocate(1);
-        auto out_packet = caerPoint2DEventPacketAllocate(packet->packetHeader.eventValid, 7, 0);
+        *out = caerPacketPoolContainerAllocate(1);
+        auto out_packet = caerPacketPoolPoint2DAllocate(packet->packetHeader.eventValid, 7, 0);
         caerEventPacketContainerSetEventPacket(*out, 0, &(out_packet->packetHeader));
         (*out)->eventsNumber = packet->packetHeader.eventValid;
-        out_packet->packetHeader.eventCapacity = packet->packetHeader.eventValid;
         out_packet->packetHeader.eventNumber = 0;
         out_packet->packetHeader.eventValid = 0;
         int32_t out_index = 0;
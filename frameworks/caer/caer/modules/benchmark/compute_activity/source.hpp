@@ -1,8 +1,10 @@
 #pragma once
 
+#include "../../../../../../common/benchmark.hpp"
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/point2d.h>
 #include <libcaer/events/point3d.h>
+#include <libcaer/packet_pool.h>
 #include <vector>
 #include <cmath>
 
@@ -17,4 +19,5 @@ struct benchmark_compute_activity {
     const uint16_t _width;
     const float _decay;
     std::vector<std::pair<float, uint64_t>> _potentials_and_ts;
+    const uint32_t _trace_stage;
 };
@@ -17,8 +17,6 @@ static struct caer_module_functions benchmark_compute_flow_functions = {
 };
 
 static void benchmark_compute_flow_config_init(sshsNode module_node) {
-    sshsNodeCreateInt(module_node, "width", 304, 0, 304, SSHS_FLAGS_NORMAL, "window width");
-    sshsNodeCreateInt(module_node, "height", 240, 0, 240, SSHS_FLAGS_NORMAL, "window height");
     sshsNodeCreateInt(module_node, "spatial_window", 3, 0, 10, SSHS_FLAGS_NORMAL, "spatial radius in pixels");
     sshsNodeCreateInt(module_node, "temporal_window", 1e4, 0, 1e7, SSHS_FLAGS_NORMAL, "temporal context");
     sshsNodeCreateInt(module_node, "minimum_number_of_events", 8, 0, 22, SSHS_FLAGS_NORMAL, "minimum number of events to trigger a flow computation");
@@ -52,10 +50,34 @@ caerModuleInfo caerModuleGetInfo() {
 }
 
 static bool benchmark_compute_flow_init(caerModuleData module_data) {
+    sshsNode source_info = caerMainloopModuleGetSourceInfoForInput(module_data->moduleID, 0);
+    if (source_info == NULL) {
+        return false;
+    }
+    // compute_activity reads the dimensions of the flow events from this module's sourceInfo node
+    int32_t width = sshsNodeGetInt(source_info, "polaritySizeX");
+    int32_t height = sshsNodeGetInt(source_info, "polaritySizeY");
+    sshsNode source_info_node = sshsGetRelativeNode(module_data->moduleNode, "sourceInfo/");
+    sshsNodeCreateInt(
+        source_info_node,
+        "dataSizeX",
+        width,
+        width,
+        width,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Data width.");
+    sshsNodeCreateInt(
+        source_info_node,
+        "dataSizeY",
+        height,
+        height,
+        height,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Data height.");
     benchmark_compute_flow_state state = module_data->moduleState;
     state->benchmark_compute_flow_instance = benchmark_compute_flow_construct(
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "width")),
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "height")),
+        (uint16_t)(width),
+        (uint16_t)(height),
         (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "spatial_window")),
         (uint64_t)(sshsNodeGetInt(module_data->moduleNode, "temporal_window")),
         (size_t)(sshsNodeGetInt(module_data->moduleNode, "minimum_number_of_events")));
@@ -71,6 +93,7 @@ static void benchmark_compute_flow_run(caerModuleData module_data, caerEventPack
 
 static void benchmark_compute_flow_exit(caerModuleData module_data) {
     sshsNodeRemoveAttributeListener(module_data->moduleNode, module_data, &caerModuleConfigDefaultListener);
+    sshsNodeClearSubTree(sshsGetRelativeNode(module_data->moduleNode, "sourceInfo/"), true);
     benchmark_compute_flow_state state = module_data->moduleState;
     benchmark_compute_flow_destruct(state->benchmark_compute_flow_instance);
 }
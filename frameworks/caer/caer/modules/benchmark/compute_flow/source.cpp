@@ -6,21 +6,20 @@ benchmark_compute_flow::benchmark_compute_flow(
     uint16_t spatial_window,
     uint64_t temporal_window,
     std::size_t minimum_number_of_events) :
-    _width(width),
-    _height(height),
     _spatial_window(spatial_window),
     _temporal_window(temporal_window),
     _minimum_number_of_events(minimum_number_of_events),
-    _ts(width * height, 0) {}
+    _ts(width, height),
+    _trace_stage(benchmark::trace_stage("compute_flow")) {}
 
 void benchmark_compute_flow::handle_packet(caerEventPacketContainer in, caerEventPacketContainer* out) {
+    benchmark::trace_scope scope(_trace_stage);
     auto packet = reinterpret_cast<caerPolarityEventPacket>(caerEventPacketContainerFindEventPacketByType(in, POLARITY_EVENT));
     if (packet && packet->packetHeader.eventValid) {
-        *out = caerEventPacketContainerAllocate(1);
-        auto out_packet = caerPoint3DEventPacketAllocate(packet->packetHeader.eventValid, 3, 0);
+        *out = caerPacketPoolContainerAllocate(1);
+        auto out_packet = caerPacketPoolPoint3DAllocate(packet->packetHeader.eventValid, 3, 0);
         caerEventPacketContainerSetEventPacket(*out, 0, &(out_packet->packetHeader));
         (*out)->eventsNumber = packet->packetHeader.eventValid;
-        out_packet->packetHeader.eventCapacity = packet->packetHeader.eventValid;
         out_packet->packetHeader.eventNumber = 0;
         out_packet->packetHeader.eventValid = 0;
         int32_t out_index = 0;
@@ -30,25 +29,25 @@ void benchmark_compute_flow::handle_packet(caerEventPacketContainer in, caerEven
                 const uint64_t t = caerPolarityEventGetTimestamp64(event, packet);
                 const uint16_t x = caerPolarityEventGetX(event);
                 const uint16_t y = caerPolarityEventGetY(event);
-                _ts[x + y * _width] = t;
+                _ts.set(_ts.index(x, y), t);
                 const uint64_t t_threshold = (t <= _temporal_window ? 0 : t - _temporal_window);
                 std::vector<point> points;
-                for (uint16_t y_other = (y <= _spatial_window ? 0 : y - _spatial_window);
-                     y_other <= (y >= _height - 1 - _spatial_window ? _height - 1 : y + _spatial_window);
-                     ++y_other) {
-                    for (uint16_t x_other = (x <= _spatial_window ? 0 : x - _spatial_window);
-                         x_other <= (x >= _width - 1 - _spatial_window ? _width - 1 : x + _spatial_window);
-                         ++x_other) {
-                        const auto t_other = _ts[x_other + y_other * _width];
-                        if (t_other > t_threshold) {
-                            points.push_back(point{
-                                static_cast<float>(t_other),
-                                static_cast<float>(x_other),
-                                static_cast<float>(y_other),
-                            });
+                _ts.for_each_segment_around(
+                    x,
+                    y,
+                    _spatial_window,
+                    [&](const uint64_t* ts_other, uint16_t x_other, uint16_t y_other, uint16_t length) {
+                        for (uint16_t offset = 0; offset < length; ++offset) {
+                            const auto t_other = ts_other[offset];
+                            if (t_other > t_threshold) {
+                                points.push_back(point{
+                                    static_cast<float>(t_other),
+                                    static_cast<float>(x_other + offset),
+                                    static_cast<float>(y_other),
+                                });
+                            }
                         }
-                    }
-                }
+                    });
                 if (points.size() >= _minimum_number_of_events) {
                     auto t_mean = 0.0f;
                     auto x_mean = 0.0f;
@@ -1,8 +1,11 @@
 #pragma once
 
+#include "../../../../../../common/benchmark.hpp"
+#include "../../../../../../common/third_party/tarsier/source/tiled_map.hpp"
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/polarity.h>
 #include <libcaer/events/point3d.h>
+#include <libcaer/packet_pool.h>
 #include <vector>
 
 struct benchmark_compute_flow {
@@ -25,10 +28,9 @@ struct benchmark_compute_flow {
         float y;
     };
 
-    const uint16_t _width;
-    const uint16_t _height;
     const uint16_t _spatial_window;
     const uint64_t _temporal_window;
     const size_t _minimum_number_of_events;
-    std::vector<uint64_t> _ts;
+    tarsier::ts_map<> _ts;
+    const uint32_t _trace_stage;
 };
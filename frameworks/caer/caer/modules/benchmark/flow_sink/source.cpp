@@ -5,23 +5,25 @@ benchmark_flow_sink::benchmark_flow_sink(char* filename, std::size_t number_of_p
     _filename(filename),
     _number_of_packets(number_of_packets),
     _received_packets(0),
-    _end_t(0) {
-    _flows.reserve(number_of_events);
+    _end_t(0),
+    _trace_stage(benchmark::trace_stage("sink")) {
+    _output_sink.reserve(number_of_events);
 }
 
 benchmark_flow_sink::~benchmark_flow_sink() {
     std::ofstream output(_filename);
-    benchmark::flows_to_json(output, _end_t, _flows);
+    _output_sink.to_json(output, _end_t);
 }
 
 void benchmark_flow_sink::add_packet(caerEventPacketContainer container) {
+    benchmark::trace_scope scope(_trace_stage);
     if (container) {
         auto packet = reinterpret_cast<caerPoint3DEventPacket>(caerEventPacketContainerFindEventPacketByType(container, POINT3D_EVENT));
         for (int32_t index = 0; index < caerEventPacketHeaderGetEventNumber(&(packet->packetHeader)); ++index) {
     		caerPoint3DEventConst event = caerPoint3DEventPacketGetEventConst(packet, index);
     		if (caerPoint3DEventIsValid(event)) {
                 const float xy = caerPoint3DEventGetZ(event);
-                _flows.push_back({
+                _output_sink({
                     static_cast<uint64_t>(caerPoint3DEventGetTimestamp64(event, packet)),
                     caerPoint3DEventGetX(event),
                     caerPoint3DEventGetY(event),
@@ -9,13 +9,14 @@ struct benchmark_flow_sink {
         benchmark_flow_sink(char* filename, std::size_t number_of_packets, std::size_t number_of_events);
         ~benchmark_flow_sink();
 
-        /// add_packet stores the given packet.
+        /// add_packet hashes (or stores, if sinks are buffered) the given packet.
         void add_packet(caerEventPacketContainer container);
 
     protected:
         std::string _filename;
         std::size_t _number_of_packets;
         std::size_t _received_packets;
-        std::vector<benchmark::flow> _flows;
+        benchmark::output_sink<benchmark::flow> _output_sink;
         uint64_t _end_t;
+        const uint32_t _trace_stage;
 };
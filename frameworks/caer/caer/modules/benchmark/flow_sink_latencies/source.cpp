@@ -1,34 +1,39 @@
 #include "source.hpp"
 #include <signal.h>
 
-benchmark_flow_sink_latencies::benchmark_flow_sink_latencies(char* filename, std::size_t number_of_packets, std::size_t number_of_events) :
+benchmark_flow_sink_latencies::benchmark_flow_sink_latencies(char* filename, benchmark_reader_latencies* reader) :
     _filename(filename),
-    _number_of_packets(number_of_packets),
-    _received_packets(0) {
-    _flows.reserve(number_of_events);
-    _points.reserve(number_of_events);
+    _reader(reader),
+    _number_of_packets(reader->number_of_packets()),
+    _received_packets(0),
+    _trace_stage(benchmark::trace_stage("sink")) {
+    _latency_sink.reserve(reader->number_of_events());
 }
 
 benchmark_flow_sink_latencies::~benchmark_flow_sink_latencies() {
     std::ofstream output(_filename);
-    benchmark::flows_latencies_to_json(output, _flows, _points);
+    _latency_sink.to_json(output);
+    _latency_sink.write_points();
 }
 
 void benchmark_flow_sink_latencies::add_packet(caerEventPacketContainer container) {
+    benchmark::trace_scope scope(_trace_stage);
     if (container) {
+        if (!_latency_sink.started()) {
+            _latency_sink.start(_reader->packets_ts(), _reader->time_0(), _reader->speed());
+        }
         auto packet = reinterpret_cast<caerPoint3DEventPacket>(caerEventPacketContainerFindEventPacketByType(container, POINT3D_EVENT));
         for (int32_t index = 0; index < caerEventPacketHeaderGetEventNumber(&(packet->packetHeader)); ++index) {
     		caerPoint3DEventConst event = caerPoint3DEventPacketGetEventConst(packet, index);
     		if (caerPoint3DEventIsValid(event)) {
                 const float xy = caerPoint3DEventGetZ(event);
-                _flows.push_back({
+                _latency_sink({
                     static_cast<uint64_t>(caerPoint3DEventGetTimestamp64(event, packet)),
                     caerPoint3DEventGetX(event),
                     caerPoint3DEventGetY(event),
                     *reinterpret_cast<const uint16_t*>(&xy),
                     *(reinterpret_cast<const uint16_t*>(&xy) + 1),
                 });
-                _points.emplace_back(static_cast<uint64_t>(_flows.back().t), benchmark::now());
     		}
         }
     }
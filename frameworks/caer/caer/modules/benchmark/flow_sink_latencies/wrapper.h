@@ -6,10 +6,11 @@ extern "C" {
 
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/polarity.h>
+#include "../reader_latencies/wrapper.h"
 
 typedef struct benchmark_flow_sink_latencies benchmark_flow_sink_latencies;
 
-benchmark_flow_sink_latencies* benchmark_flow_sink_latencies_construct(char* filename, size_t number_of_packets, size_t number_of_events);
+benchmark_flow_sink_latencies* benchmark_flow_sink_latencies_construct(char* filename, benchmark_reader_latencies* reader);
 void benchmark_flow_sink_latencies_destruct(benchmark_flow_sink_latencies* benchmark_flow_sink_latencies_instance);
 void benchmark_flow_sink_latencies_add_packet(benchmark_flow_sink_latencies* benchmark_flow_sink_latencies_instance, caerEventPacketContainer container);
 
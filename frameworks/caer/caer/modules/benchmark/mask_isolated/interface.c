@@ -17,8 +17,6 @@ static struct caer_module_functions benchmark_mask_isolated_functions = {
 };
 
 static void benchmark_mask_isolated_config_init(sshsNode module_node) {
-    sshsNodeCreateInt(module_node, "width", 304, 0, 304, SSHS_FLAGS_NORMAL, "sensor width");
-    sshsNodeCreateInt(module_node, "height", 240, 0, 240, SSHS_FLAGS_NORMAL, "sensor height");
     sshsNodeCreateInt(module_node, "temporal_window", 1e3, 0, 1e7, SSHS_FLAGS_NORMAL, "temporal context");
 }
 
@@ -26,6 +24,7 @@ static const struct caer_event_stream_in benchmark_mask_isolated_inputs[] = {{
     .type = POLARITY_EVENT,
     .number = 1,
     .readOnly = false,
+    .copyOnWrite = true,
 }};
 
 static const struct caer_module_info benchmark_mask_isolated_info = {
@@ -46,10 +45,14 @@ caerModuleInfo caerModuleGetInfo() {
 }
 
 static bool benchmark_mask_isolated_init(caerModuleData module_data) {
+    sshsNode source_info = caerMainloopModuleGetSourceInfoForInput(module_data->moduleID, 0);
+    if (source_info == NULL) {
+        return false;
+    }
     benchmark_mask_isolated_state state = module_data->moduleState;
     state->benchmark_mask_isolated_instance = benchmark_mask_isolated_construct(
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "width")),
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "height")),
+        (uint16_t)(sshsNodeGetInt(source_info, "polaritySizeX")),
+        (uint16_t)(sshsNodeGetInt(source_info, "polaritySizeY")),
         (uint64_t)(sshsNodeGetInt(module_data->moduleNode, "temporal_window")));
     sshsNodeAddAttributeListener(module_data->moduleNode, module_data, &caerModuleConfigDefaultListener);
     caerMainloopDataNotifyIncrease(NULL);
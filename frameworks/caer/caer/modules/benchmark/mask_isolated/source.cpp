@@ -4,27 +4,43 @@ benchmark_mask_isolated::benchmark_mask_isolated(uint16_t width, uint16_t height
     _width(width),
     _height(height),
     _temporal_window(temporal_window),
-    _ts(width * height, 0)
+    _ts(width * height, 0),
+    _trace_stage(benchmark::trace_stage("mask_isolated"))
 {}
 
 void benchmark_mask_isolated::handle_packet(caerEventPacketContainer in) {
+    benchmark::trace_scope scope(_trace_stage);
     auto packet = reinterpret_cast<caerPolarityEventPacket>(caerEventPacketContainerFindEventPacketByType(in, POLARITY_EVENT));
     if (packet) {
+        bool writable = false;
         for (int32_t index = 0; index < caerEventPacketHeaderGetEventNumber(&(packet->packetHeader)); ++index) {
     		caerPolarityEvent event = caerPolarityEventPacketGetEvent(packet, index);
     		if (caerPolarityEventIsValid(event)) {
                 const auto t = caerPolarityEventGetTimestamp64(event, packet);
                 const auto x = caerPolarityEventGetX(event);
                 const auto y = caerPolarityEventGetY(event);
-                const auto index = x + y * _width;
-                _ts[index] = t + _temporal_window;
-                if ((x == 0 || _ts[index - 1] <= t)
-                    && (x >= _width - 1 || _ts[index + 1] <= t)
-                    && (y == 0 || _ts[index - _width] <= t)
-                    && (y >= _height - 1 || _ts[index + _width] <= t)) {
+                const auto position = x + y * _width;
+                _ts[position] = t + _temporal_window;
+                if ((x == 0 || _ts[position - 1] <= t)
+                    && (x >= _width - 1 || _ts[position + 1] <= t)
+                    && (y == 0 || _ts[position - _width] <= t)
+                    && (y >= _height - 1 || _ts[position + _width] <= t)) {
+                    if (!writable) {
+                        // the packet may be shared with other modules, copy it before the first change
+                        packet = reinterpret_cast<caerPolarityEventPacket>(caerPacketPoolContainerMakeWritable(in, POLARITY_EVENT));
+                        if (!packet) {
+                            return;
+                        }
+                        event = caerPolarityEventPacketGetEvent(packet, index);
+                        writable = true;
+                    }
                     caerPolarityEventInvalidate(event, packet);
                 }
     		}
         }
+        if (writable) {
+            // move the remaining events together, so that the following modules skip the discarded ones
+            caerEventPacketCompact(&(packet->packetHeader), CAER_EVENT_PACKET_COMPACT_RATIO);
+        }
     }
 }
@@ -1,7 +1,9 @@
 #pragma once
 
+#include "../../../../../../common/benchmark.hpp"
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/polarity.h>
+#include <libcaer/packet_pool.h>
 #include <vector>
 
 struct benchmark_mask_isolated {
@@ -16,4 +18,5 @@ struct benchmark_mask_isolated {
     const uint16_t _height;
     const uint64_t _temporal_window;
     std::vector<uint64_t> _ts;
+    const uint32_t _trace_stage;
 };
@@ -33,6 +33,12 @@ static void benchmark_reader_config_init(sshsNode module_node) {
         PATH_MAX,
         SSHS_FLAGS_NORMAL,
 		"output log file");
+    sshsNodeCreateBool(
+        module_node,
+        "stream",
+        false,
+        SSHS_FLAGS_NORMAL,
+		"decode the file on a producer thread instead of loading it beforehand");
 }
 
 static const struct caer_event_stream_out benchmark_reader_outputs[] = {
@@ -59,12 +65,51 @@ caerModuleInfo caerModuleGetInfo() {
 static bool benchmark_reader_init(caerModuleData module_data) {
     char* filename = sshsNodeGetString(module_data->moduleNode, "filename");
     char* output_filename = sshsNodeGetString(module_data->moduleNode, "output_filename");
+    bool stream = sshsNodeGetBool(module_data->moduleNode, "stream");
+    // the performance counters cannot follow the modules' threads in pipelined execution
+    bool pipelined = sshsNodeGetBool(sshsGetNode(sshsGetGlobal(), "/caer/"), "pipelinedExecution");
     benchmark_reader_state state = module_data->moduleState;
-    state->benchmark_reader_instance = benchmark_reader_construct(filename, output_filename);
+    state->benchmark_reader_instance = benchmark_reader_construct(filename, output_filename, stream, pipelined);
     state->ended = false;
     if (state->benchmark_reader_instance == NULL) {
         return false;
     }
+    // the processors allocate their maps with the sensor dimensions, read from the sourceInfo node
+    int32_t width = benchmark_reader_width(state->benchmark_reader_instance);
+    int32_t height = benchmark_reader_height(state->benchmark_reader_instance);
+    sshsNode source_info_node = sshsGetRelativeNode(module_data->moduleNode, "sourceInfo/");
+    sshsNodeCreateInt(
+        source_info_node,
+        "polaritySizeX",
+        width,
+        width,
+        width,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Polarity events width.");
+    sshsNodeCreateInt(
+        source_info_node,
+        "polaritySizeY",
+        height,
+        height,
+        height,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Polarity events height.");
+    sshsNodeCreateInt(
+        source_info_node,
+        "dataSizeX",
+        width,
+        width,
+        width,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Data width.");
+    sshsNodeCreateInt(
+        source_info_node,
+        "dataSizeY",
+        height,
+        height,
+        height,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Data height.");
     sshsNodeAddAttributeListener(module_data->moduleNode, module_data, &caerModuleConfigDefaultListener);
     caerMainloopDataNotifyIncrease(NULL);
     return true;
@@ -82,6 +127,7 @@ static void benchmark_reader_run(caerModuleData module_data, caerEventPacketCont
 
 static void benchmark_reader_exit(caerModuleData module_data) {
     sshsNodeRemoveAttributeListener(module_data->moduleNode, module_data, &caerModuleConfigDefaultListener);
+    sshsNodeClearSubTree(sshsGetRelativeNode(module_data->moduleNode, "sourceInfo/"), true);
     benchmark_reader_state state = module_data->moduleState;
     benchmark_reader_destruct(state->benchmark_reader_instance);
 }
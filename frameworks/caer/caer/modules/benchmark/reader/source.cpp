@@ -1,58 +1,121 @@
 #include "source.hpp"
 
-benchmark_reader::benchmark_reader(char* filename, char* output_filename) :
-    _event_stream(benchmark::filename_to_event_stream(filename)),
+benchmark_reader::benchmark_reader(char* filename, char* output_filename, bool stream, bool pipelined) :
+    _event_stream(stream ? benchmark::columnar_event_stream{} : benchmark::filename_to_columnar_event_stream(filename)),
+    _packet_stream(stream ? new benchmark::packet_stream(filename) : nullptr),
     _output_filename(output_filename),
-    _begin_t(0) {
-    _next_packet = _event_stream.packets.begin();
+    _begin_t(0),
+    _perf_counters(pipelined ? nullptr : new benchmark::perf_counters()),
+    _perf_counters_running(false),
+    _trace_stage(benchmark::trace_stage("reader")),
+    _sensor(benchmark::filename_to_sensor(filename)) {
+    _next_packet = 0;
+    if (_packet_stream) {
+        _packet_stream->fill();
+    }
 }
 
 benchmark_reader::~benchmark_reader() {
     std::ofstream output(_output_filename);
-    output << "\"" << _begin_t << "\"";
+    output << "[\"" << _begin_t << "\",";
+    if (_perf_counters) {
+        _perf_counters->to_json(output);
+    } else {
+        output << "null";
+    }
+    // the modules have handled every packet by the time the reader exits, so the pool counters are final
+    caer_packet_pool_statistics pool_statistics;
+    caerPacketPoolGetStatistics(&pool_statistics);
+    output << ",{\"hits\":" << pool_statistics.hits << ",\"misses\":" << pool_statistics.misses
+           << ",\"recycled\":" << pool_statistics.recycled << ",\"released\":" << pool_statistics.released
+           << ",\"shared\":" << pool_statistics.shared << ",\"copied\":" << pool_statistics.copied << "}]";
+    if (_packet_stream) {
+        benchmark::stalls_to_json(std::cerr, *_packet_stream);
+        std::cerr << std::endl;
+    }
 }
 
 size_t benchmark_reader::number_of_packets() {
-    return _event_stream.packets.size();
+    return _packet_stream ? _packet_stream->number_of_packets() : _event_stream.number_of_packets();
 }
 
 size_t benchmark_reader::number_of_events() {
-    return _event_stream.number_of_events;
+    return _packet_stream ? _packet_stream->number_of_events() : _event_stream.number_of_events;
+}
+
+uint16_t benchmark_reader::width() {
+    return _sensor.width;
+}
+
+uint16_t benchmark_reader::height() {
+    return _sensor.height;
 }
 
 caerEventPacketContainer benchmark_reader::next_packet() {
-    if (_next_packet == _event_stream.packets.end()) {
+    if (_packet_stream) {
+        const auto events = _packet_stream->next();
+        if (events == nullptr) {
+            stop_perf_counters();
+            return NULL;
+        }
+        if (_next_packet == 0) {
+            start_perf_counters();
+            _begin_t = benchmark::now();
+        }
+        benchmark::trace_packet(_next_packet);
+        benchmark::trace_scope scope(_trace_stage, _next_packet);
+        ++_next_packet;
+        return events_to_container(*events);
+    }
+    if (_next_packet == _event_stream.number_of_packets()) {
+        stop_perf_counters();
         return NULL;
     }
-    if (_next_packet ==  _event_stream.packets.begin()) {
+    if (_next_packet == 0) {
+        start_perf_counters();
         _begin_t = benchmark::now();
     }
-    auto packet = events_to_container(*_next_packet);
-    std::advance(_next_packet, 1);
+    benchmark::trace_packet(_next_packet);
+    benchmark::trace_scope scope(_trace_stage, _next_packet);
+    auto packet = events_to_container(_event_stream.packet(_next_packet));
+    ++_next_packet;
     return packet;
 }
 
-caerEventPacketContainer benchmark_reader::events_to_container(const std::vector<sepia::dvs_event>& events) {
-    auto container = caerEventPacketContainerAllocate(1);
-    auto packet = caerPolarityEventPacketAllocate(static_cast<int32_t>(events.size()), 1, 0);
+void benchmark_reader::start_perf_counters() {
+    if (_perf_counters) {
+        _perf_counters->start();
+        _perf_counters_running = true;
+    }
+}
+
+void benchmark_reader::stop_perf_counters() {
+    if (_perf_counters_running) {
+        _perf_counters->stop();
+        _perf_counters_running = false;
+    }
+}
+
+template <typename Packet>
+caerEventPacketContainer benchmark_reader::events_to_container(const Packet& events) {
+    auto container = caerPacketPoolContainerAllocate(1);
+    auto packet = caerPacketPoolPolarityAllocate(static_cast<int32_t>(events.size()), 1, 0);
     caerEventPacketContainerSetEventPacket(container, 0, &(packet->packetHeader));
     container->lowestEventTimestamp = static_cast<int64_t>(events.front().t);
     container->highestEventTimestamp = static_cast<int64_t>(events.back().t);
     container->eventsNumber = static_cast<int32_t>(events.size());
     container->eventsValidNumber = static_cast<int32_t>(events.size());
-    packet->packetHeader.eventCapacity = static_cast<int32_t>(events.size());
     packet->packetHeader.eventNumber = 0;
     packet->packetHeader.eventValid = 0;
-    for (auto event_iterator = events.begin(); event_iterator != events.end(); ++event_iterator) {
-        auto event = caerPolarityEventPacketGetEvent(
-            packet,
-            static_cast<int32_t>(std::distance(events.begin(), event_iterator))
-        );
-        caerPolarityEventSetX(event, event_iterator->x);
-        caerPolarityEventSetY(event, event_iterator->y);
-        caerPolarityEventSetTimestamp(event, static_cast<int32_t>(event_iterator->t));
-        caerPolarityEventSetPolarity(event, event_iterator->is_increase);
+    int32_t index = 0;
+    for (const auto dvs_event : events) {
+        auto event = caerPolarityEventPacketGetEvent(packet, index);
+        caerPolarityEventSetX(event, dvs_event.x);
+        caerPolarityEventSetY(event, dvs_event.y);
+        caerPolarityEventSetTimestamp(event, static_cast<int32_t>(dvs_event.t));
+        caerPolarityEventSetPolarity(event, dvs_event.is_increase);
         caerPolarityEventValidate(event, packet);
+        ++index;
     }
     return container;
 }
@@ -3,10 +3,12 @@
 #include "../../../../../../common/benchmark.hpp"
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/polarity.h>
+#include <libcaer/packet_pool.h>
+#include <iostream>
 
 struct benchmark_reader {
     public:
-    benchmark_reader(char* filename, char* output_filename);
+    benchmark_reader(char* filename, char* output_filename, bool stream, bool pipelined);
     ~benchmark_reader();
 
     /// number_of_packets returns the number of packets loaded.
@@ -15,15 +17,39 @@ struct benchmark_reader {
     /// number_of_events returns the number of events loaded.
     size_t number_of_events();
 
+    /// width returns the sensor width, read from the file's header.
+    uint16_t width();
+
+    /// height returns the sensor height, read from the file's header.
+    uint16_t height();
+
     /// next_packet returns the next event packet to push through the pipeline.
+    /// The downstream modules' traces are tagged with the packet's index (see benchmark::trace_packet), which
+    /// requires the mainloop to run the modules sequentially on a single thread. Tracing is not supported in
+    /// pipelined execution.
     caerEventPacketContainer next_packet();
 
     protected:
-    /// events_to_packet allocates and fills a caer container from a vector of events.
-    static caerEventPacketContainer events_to_container(const std::vector<sepia::dvs_event>& events);
+    /// start_perf_counters starts the performance counters when the first packet is dispatched.
+    void start_perf_counters();
+
+    /// stop_perf_counters stops the performance counters when the reader runs out of packets.
+    /// The mainloop runs the modules sequentially, hence the sink has received the last packet by then.
+    void stop_perf_counters();
+
+    /// events_to_packet allocates and fills a caer container from a packet.
+    template <typename Packet>
+    static caerEventPacketContainer events_to_container(const Packet& events);
 
-    benchmark::event_stream _event_stream;
+    benchmark::columnar_event_stream _event_stream;
+    std::unique_ptr<benchmark::packet_stream> _packet_stream;
     std::string _output_filename;
-    std::vector<std::vector<sepia::dvs_event>>::iterator _next_packet;
+    std::size_t _next_packet;
     uint64_t _begin_t;
+    /// _perf_counters follow the reader's thread, they are null in pipelined execution since the other modules
+    /// run on threads that the reader did not create.
+    std::unique_ptr<benchmark::perf_counters> _perf_counters;
+    bool _perf_counters_running;
+    const uint32_t _trace_stage;
+    const benchmark::sensor _sensor;
 };
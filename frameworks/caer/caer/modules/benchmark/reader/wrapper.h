@@ -9,10 +9,12 @@ extern "C" {
 
 typedef struct benchmark_reader benchmark_reader;
 
-benchmark_reader* benchmark_reader_construct(char* filename, char* output_filename);
+benchmark_reader* benchmark_reader_construct(char* filename, char* output_filename, bool stream, bool pipelined);
 void benchmark_reader_destruct(benchmark_reader* benchmark_reader_instance);
 size_t benchmark_reader_number_of_packets(benchmark_reader* benchmark_reader_instance);
 size_t benchmark_reader_number_of_events(benchmark_reader* benchmark_reader_instance);
+uint16_t benchmark_reader_width(benchmark_reader* benchmark_reader_instance);
+uint16_t benchmark_reader_height(benchmark_reader* benchmark_reader_instance);
 caerEventPacketContainer benchmark_reader_next_packet(benchmark_reader* benchmark_reader_instance);
 
 struct benchmark_reader_state_struct {
@@ -33,6 +33,20 @@ static void benchmark_reader_latencies_config_init(sshsNode module_node) {
         PATH_MAX,
         SSHS_FLAGS_NORMAL,
 		"output log file");
+    sshsNodeCreateBool(
+        module_node,
+        "stream",
+        false,
+        SSHS_FLAGS_NORMAL,
+		"decode the file on a producer thread instead of loading it beforehand");
+    sshsNodeCreateDouble(
+        module_node,
+        "speed",
+        1.0,
+        1e-3,
+        1e6,
+        SSHS_FLAGS_NORMAL,
+		"replay the packets speed times faster than real time");
 }
 
 static const struct caer_event_stream_out benchmark_reader_latencies_outputs[] = {
@@ -59,12 +73,50 @@ caerModuleInfo caerModuleGetInfo() {
 static bool benchmark_reader_latencies_init(caerModuleData module_data) {
     char* filename = sshsNodeGetString(module_data->moduleNode, "filename");
     char* output_filename = sshsNodeGetString(module_data->moduleNode, "output_filename");
+    bool stream = sshsNodeGetBool(module_data->moduleNode, "stream");
+    double speed = sshsNodeGetDouble(module_data->moduleNode, "speed");
     benchmark_reader_latencies_state state = module_data->moduleState;
-    state->benchmark_reader_latencies_instance = benchmark_reader_latencies_construct(filename, output_filename);
+    state->benchmark_reader_latencies_instance = benchmark_reader_latencies_construct(filename, output_filename, stream, speed);
     state->ended = false;
     if (state->benchmark_reader_latencies_instance == NULL) {
         return false;
     }
+    // the processors allocate their maps with the sensor dimensions, read from the sourceInfo node
+    int32_t width = benchmark_reader_latencies_width(state->benchmark_reader_latencies_instance);
+    int32_t height = benchmark_reader_latencies_height(state->benchmark_reader_latencies_instance);
+    sshsNode source_info_node = sshsGetRelativeNode(module_data->moduleNode, "sourceInfo/");
+    sshsNodeCreateInt(
+        source_info_node,
+        "polaritySizeX",
+        width,
+        width,
+        width,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Polarity events width.");
+    sshsNodeCreateInt(
+        source_info_node,
+        "polaritySizeY",
+        height,
+        height,
+        height,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Polarity events height.");
+    sshsNodeCreateInt(
+        source_info_node,
+        "dataSizeX",
+        width,
+        width,
+        width,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Data width.");
+    sshsNodeCreateInt(
+        source_info_node,
+        "dataSizeY",
+        height,
+        height,
+        height,
+        SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT,
+        "Data height.");
     sshsNodeAddAttributeListener(module_data->moduleNode, module_data, &caerModuleConfigDefaultListener);
     caerMainloopDataNotifyIncrease(NULL);
     return true;
@@ -82,6 +134,7 @@ static void benchmark_reader_latencies_run(caerModuleData module_data, caerEvent
 
 static void benchmark_reader_latencies_exit(caerModuleData module_data) {
     sshsNodeRemoveAttributeListener(module_data->moduleNode, module_data, &caerModuleConfigDefaultListener);
+    sshsNodeClearSubTree(sshsGetRelativeNode(module_data->moduleNode, "sourceInfo/"), true);
     benchmark_reader_latencies_state state = module_data->moduleState;
     benchmark_reader_latencies_destruct(state->benchmark_reader_latencies_instance);
 }
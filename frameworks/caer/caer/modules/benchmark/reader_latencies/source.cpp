@@ -1,61 +1,114 @@
 #include "source.hpp"
 
-benchmark_reader_latencies::benchmark_reader_latencies(char* filename, char* output_filename) :
-    _event_stream(benchmark::filename_to_event_stream(filename)),
-    _output_filename(output_filename) {
-    _next_packet = _event_stream.packets.begin();
-    _t_0 = _event_stream.packets_ts.front();
+benchmark_reader_latencies::benchmark_reader_latencies(char* filename, char* output_filename, bool stream, double speed) :
+    _event_stream(stream ? benchmark::columnar_event_stream{} : benchmark::filename_to_columnar_event_stream(filename)),
+    _packet_stream(stream ? new benchmark::packet_stream(filename) : nullptr),
+    _output_filename(output_filename),
+    _speed(speed),
+    _trace_stage(benchmark::trace_stage("reader")),
+    _sensor(benchmark::filename_to_sensor(filename)) {
+    _next_packet = 0;
+    _time_0 = 0;
+    if (_packet_stream) {
+        _t_0 = 0;
+        _packet_stream->fill();
+    } else {
+        _t_0 = _event_stream.packets_ts.front();
+    }
 }
 
 benchmark_reader_latencies::~benchmark_reader_latencies() {
     std::ofstream output(_output_filename);
-    output << "\"" << benchmark::time_point_to_uint64(_time_point_0) << "\"";
+    output << "\"" << _time_0 << "\"";
+    if (_packet_stream) {
+        benchmark::stalls_to_json(std::cerr, *_packet_stream);
+        std::cerr << std::endl;
+    }
 }
 
 size_t benchmark_reader_latencies::number_of_packets() {
-    return _event_stream.packets.size();
+    return _packet_stream ? _packet_stream->number_of_packets() : _event_stream.number_of_packets();
 }
 
 size_t benchmark_reader_latencies::number_of_events() {
-    return _event_stream.number_of_events;
+    return _packet_stream ? _packet_stream->number_of_events() : _event_stream.number_of_events;
+}
+
+uint16_t benchmark_reader_latencies::width() {
+    return _sensor.width;
+}
+
+uint16_t benchmark_reader_latencies::height() {
+    return _sensor.height;
+}
+
+const std::vector<uint64_t>& benchmark_reader_latencies::packets_ts() const {
+    return _packet_stream ? _packet_stream->packets_ts() : _event_stream.packets_ts;
+}
+
+uint64_t benchmark_reader_latencies::time_0() const {
+    return _time_0;
+}
+
+double benchmark_reader_latencies::speed() const {
+    return _speed;
 }
 
 caerEventPacketContainer benchmark_reader_latencies::next_packet() {
-    if (_next_packet == _event_stream.packets.end()) {
+    if (_packet_stream) {
+        const auto events = _packet_stream->next();
+        if (events == nullptr) {
+            return NULL;
+        }
+        if (_next_packet == 0) {
+            _t_0 = events->back().t;
+            _time_0 = benchmark::calibrated_clock().now();
+        } else {
+            benchmark::calibrated_clock().busy_sleep_until(
+                _time_0 + static_cast<uint64_t>(benchmark::dispatch_offset(events->back().t - _t_0, _speed).count()));
+        }
+        benchmark::trace_packet(_next_packet);
+        benchmark::trace_scope scope(_trace_stage, _next_packet);
+        ++_next_packet;
+        return events_to_container(*events);
+    }
+    if (_next_packet == _event_stream.number_of_packets()) {
         return NULL;
     }
-    if (_next_packet == _event_stream.packets.begin()) {
-        _time_point_0 = std::chrono::high_resolution_clock::now();
+    if (_next_packet == 0) {
+        _time_0 = benchmark::calibrated_clock().now();
     } else {
-        benchmark::busy_sleep_until(_time_point_0
-            + std::chrono::microseconds(_event_stream.packets_ts[std::distance(_event_stream.packets.begin(), _next_packet)] - _t_0));
+        benchmark::calibrated_clock().busy_sleep_until(_time_0
+            + static_cast<uint64_t>(
+                benchmark::dispatch_offset(_event_stream.packets_ts[_next_packet] - _t_0, _speed).count()));
     }
-    auto packet = events_to_container(*_next_packet);
-    std::advance(_next_packet, 1);
+    benchmark::trace_packet(_next_packet);
+    benchmark::trace_scope scope(_trace_stage, _next_packet);
+    auto packet = events_to_container(_event_stream.packet(_next_packet));
+    ++_next_packet;
     return packet;
 }
 
-caerEventPacketContainer benchmark_reader_latencies::events_to_container(const std::vector<sepia::dvs_event>& events) {
-    auto container = caerEventPacketContainerAllocate(1);
-    auto packet = caerPolarityEventPacketAllocate(static_cast<int32_t>(events.size()), 1, 0);
+template <typename Packet>
+caerEventPacketContainer benchmark_reader_latencies::events_to_container(const Packet& events) {
+    auto container = caerPacketPoolContainerAllocate(1);
+    auto packet = caerPacketPoolPolarityAllocate(static_cast<int32_t>(events.size()), 1, 0);
     caerEventPacketContainerSetEventPacket(container, 0, &(packet->packetHeader));
     container->lowestEventTimestamp = static_cast<int64_t>(events.front().t);
     container->highestEventTimestamp = static_cast<int64_t>(events.back().t);
     container->eventsNumber = static_cast<int32_t>(events.size());
     container->eventsValidNumber = static_cast<int32_t>(events.size());
-    packet->packetHeader.eventCapacity = static_cast<int32_t>(events.size());
     packet->packetHeader.eventNumber = 0;
     packet->packetHeader.eventValid = 0;
-    for (auto event_iterator = events.begin(); event_iterator != events.end(); ++event_iterator) {
-        auto event = caerPolarityEventPacketGetEvent(
-            packet,
-            static_cast<int32_t>(std::distance(events.begin(), event_iterator))
-        );
-        caerPolarityEventSetX(event, event_iterator->x);
-        caerPolarityEventSetY(event, event_iterator->y);
-        caerPolarityEventSetTimestamp(event, static_cast<int32_t>(event_iterator->t));
-        caerPolarityEventSetPolarity(event, event_iterator->is_increase);
+    int32_t index = 0;
+    for (const auto dvs_event : events) {
+        auto event = caerPolarityEventPacketGetEvent(packet, index);
+        caerPolarityEventSetX(event, dvs_event.x);
+        caerPolarityEventSetY(event, dvs_event.y);
+        caerPolarityEventSetTimestamp(event, static_cast<int32_t>(dvs_event.t));
+        caerPolarityEventSetPolarity(event, dvs_event.is_increase);
         caerPolarityEventValidate(event, packet);
+        ++index;
     }
     return container;
 }
@@ -3,10 +3,12 @@
 #include "../../../../../../common/benchmark.hpp"
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/polarity.h>
+#include <libcaer/packet_pool.h>
+#include <iostream>
 
 struct benchmark_reader_latencies {
     public:
-    benchmark_reader_latencies(char* filename, char* output_filename);
+    benchmark_reader_latencies(char* filename, char* output_filename, bool stream, double speed);
     ~benchmark_reader_latencies();
 
     /// number_of_packets returns the number of packets loaded.
@@ -15,16 +17,38 @@ struct benchmark_reader_latencies {
     /// number_of_events returns the number of events loaded.
     size_t number_of_events();
 
+    /// width returns the sensor width, read from the file's header.
+    uint16_t width();
+
+    /// height returns the sensor height, read from the file's header.
+    uint16_t height();
+
     /// next_packet returns the next event packet to push through the pipeline.
+    /// When the mainloop runs the modules sequentially on a single thread, the downstream modules' traces are
+    /// tagged with the packet's index (see benchmark::trace_packet). They are tagged 0 in pipelined execution.
     caerEventPacketContainer next_packet();
 
+    /// packets_ts returns each packet's last event timestamp.
+    const std::vector<uint64_t>& packets_ts() const;
+
+    /// time_0 returns the wall clock time read when the first packet was dispatched.
+    uint64_t time_0() const;
+
+    /// speed returns the replay speed factor.
+    double speed() const;
+
     protected:
-        /// events_to_packet allocates and fills a caer container from a vector of events.
-        static caerEventPacketContainer events_to_container(const std::vector<sepia::dvs_event>& events);
+        /// events_to_packet allocates and fills a caer container from a packet.
+        template <typename Packet>
+        static caerEventPacketContainer events_to_container(const Packet& events);
 
-        benchmark::event_stream _event_stream;
+        benchmark::columnar_event_stream _event_stream;
+        std::unique_ptr<benchmark::packet_stream> _packet_stream;
         std::string _output_filename;
-        std::vector<std::vector<sepia::dvs_event>>::iterator _next_packet;
+        double _speed;
+        std::size_t _next_packet;
         uint64_t _t_0;
-        std::chrono::high_resolution_clock::time_point _time_point_0;
+        uint64_t _time_0;
+        const uint32_t _trace_stage;
+        const benchmark::sensor _sensor;
 };
@@ -9,10 +9,12 @@ extern "C" {
 
 typedef struct benchmark_reader_latencies benchmark_reader_latencies;
 
-benchmark_reader_latencies* benchmark_reader_latencies_construct(char* filename, char* output_filename);
+benchmark_reader_latencies* benchmark_reader_latencies_construct(char* filename, char* output_filename, bool stream, double speed);
 void benchmark_reader_latencies_destruct(benchmark_reader_latencies* benchmark_reader_latencies_instance);
 size_t benchmark_reader_latencies_number_of_packets(benchmark_reader_latencies* benchmark_reader_latencies_instance);
 size_t benchmark_reader_latencies_number_of_events(benchmark_reader_latencies* benchmark_reader_latencies_instance);
+uint16_t benchmark_reader_latencies_width(benchmark_reader_latencies* benchmark_reader_latencies_instance);
+uint16_t benchmark_reader_latencies_height(benchmark_reader_latencies* benchmark_reader_latencies_instance);
 caerEventPacketContainer benchmark_reader_latencies_next_packet(benchmark_reader_latencies* benchmark_reader_latencies_instance);
 
 struct benchmark_reader_latencies_state_struct {
@@ -17,16 +17,17 @@ static struct caer_module_functions benchmark_select_rectangle_functions = {
 };
 
 static void benchmark_select_rectangle_config_init(sshsNode module_node) {
-    sshsNodeCreateInt(module_node, "left", 0, 0, 303, SSHS_FLAGS_NORMAL, "bottom-left corner's x coordinate");
-    sshsNodeCreateInt(module_node, "bottom", 0, 0, 239, SSHS_FLAGS_NORMAL, "bottom-left corner's y coordinate");
-    sshsNodeCreateInt(module_node, "width", 304, 0, 304, SSHS_FLAGS_NORMAL, "window width");
-    sshsNodeCreateInt(module_node, "height", 240, 0, 240, SSHS_FLAGS_NORMAL, "window height");
+    sshsNodeCreateInt(module_node, "left", -1, -1, UINT16_MAX, SSHS_FLAGS_NORMAL, "bottom-left corner's x coordinate (-1 scales 102 on a 304 pixels wide sensor)");
+    sshsNodeCreateInt(module_node, "bottom", -1, -1, UINT16_MAX, SSHS_FLAGS_NORMAL, "bottom-left corner's y coordinate (-1 scales 70 on a 240 pixels high sensor)");
+    sshsNodeCreateInt(module_node, "width", -1, -1, UINT16_MAX, SSHS_FLAGS_NORMAL, "window width (-1 scales 100 on a 304 pixels wide sensor)");
+    sshsNodeCreateInt(module_node, "height", -1, -1, UINT16_MAX, SSHS_FLAGS_NORMAL, "window height (-1 scales 100 on a 240 pixels high sensor)");
 }
 
 static const struct caer_event_stream_in benchmark_select_rectangle_inputs[] = {{
     .type = POLARITY_EVENT,
     .number = 1,
     .readOnly = false,
+    .copyOnWrite = true,
 }};
 
 static const struct caer_module_info benchmark_select_rectangle_info = {
@@ -47,12 +48,18 @@ caerModuleInfo caerModuleGetInfo() {
 }
 
 static bool benchmark_select_rectangle_init(caerModuleData module_data) {
+    sshsNode source_info = caerMainloopModuleGetSourceInfoForInput(module_data->moduleID, 0);
+    if (source_info == NULL) {
+        return false;
+    }
     benchmark_select_rectangle_state state = module_data->moduleState;
     state->benchmark_select_rectangle_instance = benchmark_select_rectangle_construct(
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "left")),
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "bottom")),
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "width")),
-        (uint16_t)(sshsNodeGetInt(module_data->moduleNode, "height")));
+        (uint16_t)(sshsNodeGetInt(source_info, "polaritySizeX")),
+        (uint16_t)(sshsNodeGetInt(source_info, "polaritySizeY")),
+        sshsNodeGetInt(module_data->moduleNode, "left"),
+        sshsNodeGetInt(module_data->moduleNode, "bottom"),
+        sshsNodeGetInt(module_data->moduleNode, "width"),
+        sshsNodeGetInt(module_data->moduleNode, "height"));
     sshsNodeAddAttributeListener(module_data->moduleNode, module_data, &caerModuleConfigDefaultListener);
     caerMainloopDataNotifyIncrease(NULL);
     return true;
@@ -1,23 +1,58 @@
 #include "source.hpp"
 
-benchmark_select_rectangle::benchmark_select_rectangle(uint16_t left, uint16_t bottom, uint16_t width, uint16_t height) :
-    _left(left),
-    _right(left + width),
-    _bottom(bottom),
-    _top(bottom + height) {}
+benchmark_select_rectangle::benchmark_select_rectangle(
+    uint16_t sensor_width,
+    uint16_t sensor_height,
+    int32_t left,
+    int32_t bottom,
+    int32_t width,
+    int32_t height) :
+    benchmark_select_rectangle(
+        benchmark::dimensions_to_sensor(sensor_width, sensor_height).region,
+        left,
+        bottom,
+        width,
+        height) {}
+
+benchmark_select_rectangle::benchmark_select_rectangle(
+    benchmark::rectangle region,
+    int32_t left,
+    int32_t bottom,
+    int32_t width,
+    int32_t height) :
+    _left(left < 0 ? region.left : static_cast<uint16_t>(left)),
+    _right(_left + (width < 0 ? region.width : static_cast<uint16_t>(width))),
+    _bottom(bottom < 0 ? region.bottom : static_cast<uint16_t>(bottom)),
+    _top(_bottom + (height < 0 ? region.height : static_cast<uint16_t>(height))),
+    _trace_stage(benchmark::trace_stage("select_rectangle")) {}
 
 void benchmark_select_rectangle::handle_packet(caerEventPacketContainer in) {
+    benchmark::trace_scope scope(_trace_stage);
     auto packet = reinterpret_cast<caerPolarityEventPacket>(caerEventPacketContainerFindEventPacketByType(in, POLARITY_EVENT));
     if (packet) {
+        bool writable = false;
         for (int32_t index = 0; index < caerEventPacketHeaderGetEventNumber(&(packet->packetHeader)); ++index) {
     		caerPolarityEvent event = caerPolarityEventPacketGetEvent(packet, index);
     		if (caerPolarityEventIsValid(event)) {
                 const auto x = caerPolarityEventGetX(event);
                 const auto y = caerPolarityEventGetY(event);
                 if (x < _left || x >= _right || y < _bottom || y >= _top) {
+                    if (!writable) {
+                        // the packet may be shared with other modules, copy it before the first change
+                        packet = reinterpret_cast<caerPolarityEventPacket>(caerPacketPoolContainerMakeWritable(in, POLARITY_EVENT));
+                        if (!packet) {
+                            return;
+                        }
+                        event = caerPolarityEventPacketGetEvent(packet, index);
+                        writable = true;
+                    }
                     caerPolarityEventInvalidate(event, packet);
                 }
     		}
         }
+        if (writable) {
+            // move the remaining events together, so that the following modules skip the discarded ones
+            caerEventPacketCompact(&(packet->packetHeader), CAER_EVENT_PACKET_COMPACT_RATIO);
+        }
     }
 }
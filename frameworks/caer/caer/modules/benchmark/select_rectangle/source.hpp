@@ -3,17 +3,28 @@
 #include "../../../../../../common/benchmark.hpp"
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/polarity.h>
+#include <libcaer/packet_pool.h>
 
 struct benchmark_select_rectangle {
     public:
-    benchmark_select_rectangle(uint16_t left, uint16_t bottom, uint16_t width, uint16_t height);
+    /// Negative region parameters are replaced with the region scaled to the sensor (see benchmark::dimensions_to_sensor).
+    benchmark_select_rectangle(
+        uint16_t sensor_width,
+        uint16_t sensor_height,
+        int32_t left,
+        int32_t bottom,
+        int32_t width,
+        int32_t height);
 
     /// handle_packet runs the associated algorithm on the given packet.
     void handle_packet(caerEventPacketContainer in);
 
     protected:
+    benchmark_select_rectangle(benchmark::rectangle region, int32_t left, int32_t bottom, int32_t width, int32_t height);
+
     const uint16_t _left;
     const uint16_t _right;
     const uint16_t _bottom;
     const uint16_t _top;
+    const uint32_t _trace_stage;
 };
@@ -9,7 +9,7 @@ extern "C" {
 
 typedef struct benchmark_select_rectangle benchmark_select_rectangle;
 
-benchmark_select_rectangle* benchmark_select_rectangle_construct(uint16_t left, uint16_t bottom, uint16_t width, uint16_t height);
+benchmark_select_rectangle* benchmark_select_rectangle_construct(uint16_t sensor_width, uint16_t sensor_height, int32_t left, int32_t bottom, int32_t width, int32_t height);
 void benchmark_select_rectangle_destruct(benchmark_select_rectangle* benchmark_select_rectangle_instance);
 void benchmark_select_rectangle_handle_packet(benchmark_select_rectangle* benchmark_select_rectangle_instance, caerEventPacketContainer in);
 
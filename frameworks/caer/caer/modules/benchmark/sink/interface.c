@@ -37,7 +37,7 @@ static const struct caer_event_stream_in benchmark_sink_inputs[] = {{
 static const struct caer_module_info benchmark_sink_info = {
     .version = 1,
     .name = "benchmark_sink",
-    .description = "Stores events in RAM",
+    .description = "Hashes events as they arrive",
     .type = CAER_MODULE_OUTPUT,
     .memSize = sizeof(struct benchmark_sink_state_struct),
     .functions = &benchmark_sink_functions,
@@ -5,22 +5,24 @@ benchmark_sink::benchmark_sink(char* filename, std::size_t number_of_packets, st
     _filename(filename),
     _number_of_packets(number_of_packets),
     _received_packets(0),
-    _end_t(0) {
-    _events.reserve(number_of_events);
+    _end_t(0),
+    _trace_stage(benchmark::trace_stage("sink")) {
+    _output_sink.reserve(number_of_events);
 }
 
 benchmark_sink::~benchmark_sink() {
     std::ofstream output(_filename);
-    benchmark::events_to_json(output, _end_t, _events);
+    _output_sink.to_json(output, _end_t);
 }
 
 void benchmark_sink::add_packet(caerEventPacketContainer container) {
+    benchmark::trace_scope scope(_trace_stage);
     if (container) {
         auto packet = reinterpret_cast<caerPolarityEventPacket>(caerEventPacketContainerFindEventPacketByType(container, POLARITY_EVENT));
         for (int32_t index = 0; index < caerEventPacketHeaderGetEventNumber(&(packet->packetHeader)); ++index) {
     		caerPolarityEventConst event = caerPolarityEventPacketGetEventConst(packet, index);
     		if (caerPolarityEventIsValid(event)) {
-                _events.push_back({
+                _output_sink({
                     static_cast<uint64_t>(caerPolarityEventGetTimestamp64(event, packet)),
                     caerPolarityEventGetX(event),
                     caerPolarityEventGetY(event),
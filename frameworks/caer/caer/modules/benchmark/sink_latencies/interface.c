@@ -37,7 +37,7 @@ static const struct caer_event_stream_in benchmark_sink_latencies_inputs[] = {{
 static const struct caer_module_info benchmark_sink_latencies_info = {
     .version = 1,
     .name = "benchmark_sink_latencies",
-    .description = "Stores events in RAM",
+    .description = "Hashes events and measures their latencies as they arrive",
     .type = CAER_MODULE_OUTPUT,
     .memSize = sizeof(struct benchmark_sink_latencies_state_struct),
     .functions = &benchmark_sink_latencies_functions,
@@ -60,8 +60,7 @@ static bool benchmark_sink_latencies_init(caerModuleData module_data) {
     }
     state->benchmark_sink_latencies_instance = benchmark_sink_latencies_construct(
         filename,
-        benchmark_reader_latencies_number_of_packets(reader_latencies_state->benchmark_reader_latencies_instance),
-        benchmark_reader_latencies_number_of_events(reader_latencies_state->benchmark_reader_latencies_instance));
+        reader_latencies_state->benchmark_reader_latencies_instance);
     if (state->benchmark_sink_latencies_instance == NULL) {
         return false;
     }
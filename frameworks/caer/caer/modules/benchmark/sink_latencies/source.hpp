@@ -1,21 +1,23 @@
 #pragma once
 
 #include "../../../../../../common/benchmark.hpp"
+#include "../reader_latencies/source.hpp"
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/polarity.h>
 
 struct benchmark_sink_latencies {
     public:
-        benchmark_sink_latencies(char* filename, std::size_t number_of_packets, std::size_t number_of_events);
+        benchmark_sink_latencies(char* filename, benchmark_reader_latencies* reader);
         ~benchmark_sink_latencies();
 
-        /// add_packet stores the given packet.
+        /// add_packet hashes the given packet and measures its events' latencies.
         void add_packet(caerEventPacketContainer container);
 
     protected:
         std::string _filename;
+        benchmark_reader_latencies* _reader;
         std::size_t _number_of_packets;
         std::size_t _received_packets;
-        std::vector<sepia::dvs_event> _events;
-        std::vector<std::pair<uint64_t, uint64_t>> _points;
+        benchmark::latency_sink<sepia::dvs_event> _latency_sink;
+        const uint32_t _trace_stage;
 };
@@ -22,6 +22,7 @@ static const struct caer_event_stream_in benchmark_split_inputs[] = {{
     .type = POLARITY_EVENT,
     .number = 1,
     .readOnly = false,
+    .copyOnWrite = true,
 }};
 
 static const struct caer_module_info benchmark_split_info = {
@@ -1,17 +1,32 @@
 #include "source.hpp"
 
-benchmark_split::benchmark_split() {}
+benchmark_split::benchmark_split() : _trace_stage(benchmark::trace_stage("split")) {}
 
 void benchmark_split::handle_packet(caerEventPacketContainer in) {
+    benchmark::trace_scope scope(_trace_stage);
     auto packet = reinterpret_cast<caerPolarityEventPacket>(caerEventPacketContainerFindEventPacketByType(in, POLARITY_EVENT));
     if (packet) {
+        bool writable = false;
         for (int32_t index = 0; index < caerEventPacketHeaderGetEventNumber(&(packet->packetHeader)); ++index) {
     		caerPolarityEvent event = caerPolarityEventPacketGetEvent(packet, index);
     		if (caerPolarityEventIsValid(event)) {
                 if (!caerPolarityEventGetPolarity(event)) {
+                    if (!writable) {
+                        // the packet may be shared with other modules, copy it before the first change
+                        packet = reinterpret_cast<caerPolarityEventPacket>(caerPacketPoolContainerMakeWritable(in, POLARITY_EVENT));
+                        if (!packet) {
+                            return;
+                        }
+                        event = caerPolarityEventPacketGetEvent(packet, index);
+                        writable = true;
+                    }
                     caerPolarityEventInvalidate(event, packet);
                 }
     		}
         }
+        if (writable) {
+            // move the remaining events together, so that the following modules skip the discarded ones
+            caerEventPacketCompact(&(packet->packetHeader), CAER_EVENT_PACKET_COMPACT_RATIO);
+        }
     }
 }
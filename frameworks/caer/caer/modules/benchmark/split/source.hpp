@@ -3,6 +3,7 @@
 #include "../../../../../../common/benchmark.hpp"
 #include <libcaer/events/packetContainer.h>
 #include <libcaer/events/polarity.h>
+#include <libcaer/packet_pool.h>
 
 struct benchmark_split {
     public:
@@ -10,4 +11,7 @@ struct benchmark_split {
 
     /// handle_packet runs the associated algorithm on the given packet.
     void handle_packet(caerEventPacketContainer in);
+
+    protected:
+    const uint32_t _trace_stage;
 };
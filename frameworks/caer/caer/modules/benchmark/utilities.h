@@ -68,6 +68,16 @@ class* class ## _construct(argument_type_0 argument_0, argument_type_1 argument_
     return nullptr;\
 }
 
+#define BENCHMARK_WRAP_CONSTRUCT_6(class, argument_type_0, argument_type_1, argument_type_2, argument_type_3, argument_type_4, argument_type_5)\
+class* class ## _construct(argument_type_0 argument_0, argument_type_1 argument_1, argument_type_2 argument_2, argument_type_3 argument_3, argument_type_4 argument_4, argument_type_5 argument_5) {\
+    try {\
+        return new class(argument_0, argument_1, argument_2, argument_3, argument_4, argument_5);\
+    } catch (const std::exception& exception) {\
+        caerLog(CAER_LOG_ERROR, #class "_construct", "failed with C++ exception: %s", exception.what());\
+    }\
+    return nullptr;\
+}
+
 #define BENCHMARK_WRAP_DESTRUCT(class)\
 void class ## _destruct(class* class ## _instance) {\
     try {\
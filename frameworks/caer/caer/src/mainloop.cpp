@@ -9,8 +9,11 @@
 #include <boost/filesystem.hpp>
 #include <boost/format.hpp>
 #include <boost/range/join.hpp>
+#include <atomic>
 #include <chrono>
+#include <condition_variable>
 #include <csignal>
+#include <exception>
 #include <iostream>
 #include <mutex>
 #include <queue>
@@ -45,6 +48,8 @@
 
 #define MODULES_DIRECTORY "modules/"
 
+#include <libcaer/packet_pool.h>
+#include <libcaer/ringbuffer.h>
 #include <libcaercpp/libcaer.hpp>
 using namespace libcaer::log;
 
@@ -179,6 +184,13 @@ void caerMainloopRun(void) {
 
 	sshsNodeCreateBool(
 		systemNode, "running", true, SSHS_FLAGS_NORMAL | SSHS_FLAGS_NO_EXPORT, "Global system start/stop.");
+
+	sshsNodeCreateBool(systemNode, "pipelinedExecution", false, SSHS_FLAGS_NORMAL,
+		"Run each module on its own thread, with iterations flowing from one module to the next. Applied when the "
+		"mainloop starts.");
+
+	sshsNodeCreateInt(systemNode, "idleSpinTime", 0, 0, 1000000, SSHS_FLAGS_NORMAL,
+		"Time in microseconds to busy-wait for new data before the mainloop sleeps. Applied when the mainloop starts.");
 	sshsNodeAddAttributeListener(systemNode, nullptr, &caerMainloopSystemRunningListener);
 
 	// Mainloop running control.
@@ -550,7 +562,8 @@ static void updateInputDefinitionCopyNeeded(std::unordered_map<int16_t, std::vec
 			if (eventStreams[i].type == -1) {
 				for (auto &in : inputDefinition) {
 					for (auto &order : in.second) {
-						order.copyNeeded = true;
+						order.copyNeeded  = true;
+						order.copyOnWrite = eventStreams[i].copyOnWrite;
 					}
 				}
 			}
@@ -559,7 +572,8 @@ static void updateInputDefinitionCopyNeeded(std::unordered_map<int16_t, std::vec
 			for (auto &in : inputDefinition) {
 				for (auto &order : in.second) {
 					if (order.typeId == eventStreams[i].type) {
-						order.copyNeeded = true;
+						order.copyNeeded  = true;
+						order.copyOnWrite = eventStreams[i].copyOnWrite;
 					}
 				}
 			}
@@ -1162,17 +1176,19 @@ static void buildConnectivity() {
 						if (!isOutputBeingUsed(
 								sourceId, orderIn.typeId, orderIn.afterModuleId, m.get().id, m.get().name)) {
 							// Nobody else needs this data, use it directly.
-							// Update active inputs with a viable index.
-							m.get().inputs.push_back(std::make_pair(idx->index, -1));
+							// Update active inputs with a viable index. The data
+							// may still be shared with an earlier slot, so modules
+							// that don't handle copy-on-write get their own copy.
+							m.get().inputs.push_back(ModuleInput(idx->index, -1, !orderIn.copyOnWrite));
 
 							// Put combination into indexes table.
 							indexes.push_back(ModuleSlot(orderIn.typeId, m.get().id, idx->index));
 						}
 						else {
-							// Others need this data, copy it.
+							// Others need this data, share it.
 							// Update active inputs with a viable index, use the
 							// next free one and set copyFrom index to the old one.
-							m.get().inputs.push_back(std::make_pair(nextFreeSlot, idx->index));
+							m.get().inputs.push_back(ModuleInput(nextFreeSlot, idx->index, !orderIn.copyOnWrite));
 
 							// Put combination into indexes table.
 							indexes.push_back(ModuleSlot(orderIn.typeId, m.get().id, nextFreeSlot));
@@ -1181,13 +1197,19 @@ static void buildConnectivity() {
 							nextFreeSlot++;
 
 							// Globally count number of data copies needed in a run.
-							glMainloopData.copyCount++;
+							// Copy-on-write modules only copy when they modify data.
+							if (orderIn.copyOnWrite) {
+								glMainloopData.shareCount++;
+							}
+							else {
+								glMainloopData.copyCount++;
+							}
 						}
 					}
 					else {
 						// Copy not needed, just use index from indexes table.
 						// Update active inputs with a viable index.
-						m.get().inputs.push_back(std::make_pair(idx->index, -1));
+						m.get().inputs.push_back(ModuleInput(idx->index, -1, false));
 					}
 				}
 			}
@@ -1219,144 +1241,422 @@ static size_t getMaximumInputNumber() {
 	return (maxSize);
 }
 
-static void runModules(caerEventPacketContainer in) {
-	// Run through all modules in order.
-	for (const auto &m : glMainloopData.globalExecution) {
-		size_t inputsToPass        = 0;
-		size_t outputsExpectedBack = 0;
-
-		// Prepare input container. Only do if the module is running.
-		if (m.get().runtimeData->moduleStatus == CAER_MODULE_RUNNING) {
-			// Clean up container. NULL pointers, memory has been already freed
-			// previously from the global event packets storage.
-			for (int32_t i = 0; i < caerEventPacketContainerGetEventPacketsNumber(in); i++) {
-				in->eventPackets[i] = nullptr;
+/**
+ * Run one module's state machine on the packets of one mainloop iteration.
+ * The module reads its inputs from, and writes its outputs to, the given
+ * event packet slots. The input container is reused by every module.
+ */
+static void runModule(ModuleInfo &m, std::vector<caerEventPacketHeader> &eventPackets, caerEventPacketContainer in) {
+	size_t inputsToPass        = 0;
+	size_t outputsExpectedBack = 0;
+
+	// Prepare input container. Only do if the module is running.
+	if (m.runtimeData->moduleStatus == CAER_MODULE_RUNNING) {
+		// Clean up container. NULL pointers, memory has been already freed
+		// previously from the global event packets storage.
+		for (int32_t i = 0; i < caerEventPacketContainerGetEventPacketsNumber(in); i++) {
+			in->eventPackets[i] = nullptr;
+		}
+
+		// Insert new packets into container based on declared inputs.
+		// If needed, share the packet and publish the reference globally.
+		// Modules that modify data in place get their own copy right away,
+		// copy-on-write ones only when they call caerPacketPoolMakeWritable().
+		for (const auto &input : m.inputs) {
+			caerEventPacketHeader &packet = eventPackets[static_cast<size_t>(input.index)];
+
+			if (input.copyFrom != -1) {
+				packet = caerPacketPoolShare(eventPackets[static_cast<size_t>(input.copyFrom)]);
 			}
 
-			// Insert new packets into container based on declared inputs.
-			// If needed, copy the packet and publish the copy globally.
-			for (const auto &input : m.get().inputs) {
-				if (input.second == -1) {
-					// No copy needed.
-					in->eventPackets[inputsToPass] = glMainloopData.eventPackets[static_cast<size_t>(input.first)];
+			if (input.makeWritable) {
+				caerEventPacketHeader writablePacket = caerPacketPoolMakeWritable(packet);
+				if (writablePacket == nullptr) {
+					// Copy failed, the module gets no data, as with a failed eager copy.
+					caerPacketPoolRecycle(packet);
 				}
-				else {
-					// Copy is needed. Do it and update the global event packet storage.
-					caerEventPacketHeader packetCopy
-						= caerEventPacketCopyOnlyEvents(glMainloopData.eventPackets[static_cast<size_t>(input.second)]);
 
-					in->eventPackets[inputsToPass]                                = packetCopy;
-					glMainloopData.eventPackets[static_cast<size_t>(input.first)] = packetCopy;
-				}
+				packet = writablePacket;
+			}
 
-				// Only increment container size if we actually added a packet with data.
-				if (in->eventPackets[inputsToPass] != nullptr) {
-					inputsToPass++;
-				}
+			in->eventPackets[inputsToPass] = packet;
+
+			// Only increment container size if we actually added a packet with data.
+			if (in->eventPackets[inputsToPass] != nullptr) {
+				inputsToPass++;
 			}
+		}
 
-			// Reset number of contained event packets, this also updates statistics.
-			caerEventPacketContainerSetEventPacketsNumber(in, static_cast<int32_t>(inputsToPass));
+		// Reset number of contained event packets, this also updates statistics.
+		caerEventPacketContainerSetEventPacketsNumber(in, static_cast<int32_t>(inputsToPass));
 
-			// If module is running, expected outputs are as many as are defined.
-			outputsExpectedBack = m.get().outputs.size();
+		// If module is running, expected outputs are as many as are defined.
+		outputsExpectedBack = m.outputs.size();
+	}
+	else {
+		// !CAER_MODULE_RUNNING, so we need to make any side-effects of the
+		// above code happen, in this case any packet share operation, which
+		// would fill a slot with data, has to happen. The slot must be
+		// filled, because later modules in this stream might be using the
+		// data and modifying it, even if this modules obviously doesn't.
+		for (const auto &input : m.inputs) {
+			if (input.copyFrom != -1) {
+				eventPackets[static_cast<size_t>(input.index)]
+					= caerPacketPoolShare(eventPackets[static_cast<size_t>(input.copyFrom)]);
+			}
 		}
-		else {
-			// !CAER_MODULE_RUNNING, so we need to make any side-effects of the
-			// above code happen, in this case any packet copy operation, which
-			// would fill a slot with new data, has to happen. The copy must
-			// happen, because later modules in this stream might be using the
-			// data and modifying it, even if this modules obviously doesn't.
-			for (const auto &input : m.get().inputs) {
-				if (input.second != -1) {
-					glMainloopData.eventPackets[static_cast<size_t>(input.first)]
-						= caerEventPacketCopyOnlyEvents(glMainloopData.eventPackets[static_cast<size_t>(input.second)]);
-				}
+	}
+
+	// Debug logging.
+	caerModuleLog(m.runtimeData, CAER_LOG_DEBUG, "Module Input: passing %zu packets in.", inputsToPass);
+	caerModuleLog(m.runtimeData, CAER_LOG_DEBUG, "Module Output: expecting %zu packets back out.", outputsExpectedBack);
+
+	// Run module state machine.
+	caerEventPacketContainer out = nullptr;
+	caerModuleSM(m.libraryInfo->functions, m.runtimeData, m.libraryInfo->memSize, (inputsToPass > 0) ? (in) : (nullptr),
+		(outputsExpectedBack > 0) ? (&out) : (nullptr));
+
+	// Copy-on-write modules may have replaced shared input packets with
+	// their own copies, publish those globally. Empty slots were skipped
+	// when filling the container, so skip them again to stay in step.
+	size_t inputIndex = 0;
+
+	for (const auto &input : m.inputs) {
+		if (inputIndex == inputsToPass) {
+			break;
+		}
+
+		caerEventPacketHeader &packet = eventPackets[static_cast<size_t>(input.index)];
+
+		if (packet != nullptr) {
+			if (in->eventPackets[inputIndex] != nullptr) {
+				packet = in->eventPackets[inputIndex];
 			}
+
+			inputIndex++;
 		}
+	}
 
-		// Debug logging.
-		caerModuleLog(m.get().runtimeData, CAER_LOG_DEBUG, "Module Input: passing %zu packets in.", inputsToPass);
-		caerModuleLog(
-			m.get().runtimeData, CAER_LOG_DEBUG, "Module Output: expecting %zu packets back out.", outputsExpectedBack);
-
-		// Run module state machine.
-		caerEventPacketContainer out = nullptr;
-		caerModuleSM(m.get().libraryInfo->functions, m.get().runtimeData, m.get().libraryInfo->memSize,
-			(inputsToPass > 0) ? (in) : (nullptr), (outputsExpectedBack > 0) ? (&out) : (nullptr));
-
-		// Parse possible output container.
-		if (out != nullptr) {
-			caerModuleLog(m.get().runtimeData, CAER_LOG_DEBUG, "Module Output: got %" PRIi32 " packets.",
-				caerEventPacketContainerGetEventPacketsNumber(out));
-
-			// Go through all packets, put them in their right place inside
-			// the global event storage.
-			for (int32_t i = 0; i < caerEventPacketContainerGetEventPacketsNumber(out); i++) {
-				caerEventPacketHeader packet = out->eventPackets[i];
-
-				// Got a packet!
-				if (packet != nullptr) {
-					// Check that the source ID indeed comes from this module!
-					int16_t sourceId = caerEventPacketHeaderGetEventSource(packet);
-					if (sourceId != m.get().id) {
-						boost::format exMsg
-							= boost::format("Got event packet back from module '%s' (ID %d) with source ID set to %d.")
-							  % m.get().name % m.get().id % sourceId;
-						throw std::runtime_error(exMsg.str());
-					}
+	// Parse possible output container.
+	if (out != nullptr) {
+		caerModuleLog(m.runtimeData, CAER_LOG_DEBUG, "Module Output: got %" PRIi32 " packets.",
+			caerEventPacketContainerGetEventPacketsNumber(out));
 
-					int16_t typeId = caerEventPacketHeaderGetEventType(packet);
+		// Go through all packets, put them in their right place inside
+		// the global event storage.
+		for (int32_t i = 0; i < caerEventPacketContainerGetEventPacketsNumber(out); i++) {
+			caerEventPacketHeader packet = out->eventPackets[i];
 
-					ssize_t destIdx = -1;
+			// Got a packet!
+			if (packet != nullptr) {
+				// Check that the source ID indeed comes from this module!
+				int16_t sourceId = caerEventPacketHeaderGetEventSource(packet);
+				if (sourceId != m.id) {
+					boost::format exMsg
+						= boost::format("Got event packet back from module '%s' (ID %d) with source ID set to %d.")
+						  % m.name % m.id % sourceId;
+					throw std::runtime_error(exMsg.str());
+				}
 
-					try {
-						destIdx = m.get().outputs.at(typeId);
-					}
-					catch (const std::out_of_range &) {
-						// If we don't find a match for the type ID, it means
-						// that's an unexpected event packet. If this is a module
-						// with well defined outputs, this is clearly an error;
-						// forgetting to declare an output, so we re-throw the
-						// exception upwards. Else for modules with any (-1)
-						// outputs, they can internally produce whatever and we
-						// only pick what was declared in the 'moduleOutput' config.
-						if (m.get().libraryInfo->outputStreams[0].type != -1) {
-							// Type ANY (-1) is always the first one if it exists,
-							// and outputs must exist since module.outputs is
-							// populated with types we want to pick.
-							throw;
-						}
-					}
+				int16_t typeId = caerEventPacketHeaderGetEventType(packet);
 
-					if (destIdx == -1) {
-						// Deallocate packet memory if not used.
-						free(packet);
-					}
-					else {
-						glMainloopData.eventPackets[static_cast<size_t>(destIdx)] = packet;
+				ssize_t destIdx = -1;
+
+				try {
+					destIdx = m.outputs.at(typeId);
+				}
+				catch (const std::out_of_range &) {
+					// If we don't find a match for the type ID, it means
+					// that's an unexpected event packet. If this is a module
+					// with well defined outputs, this is clearly an error;
+					// forgetting to declare an output, so we re-throw the
+					// exception upwards. Else for modules with any (-1)
+					// outputs, they can internally produce whatever and we
+					// only pick what was declared in the 'moduleOutput' config.
+					if (m.libraryInfo->outputStreams[0].type != -1) {
+						// Type ANY (-1) is always the first one if it exists,
+						// and outputs must exist since module.outputs is
+						// populated with types we want to pick.
+						throw;
 					}
 				}
+
+				if (destIdx == -1) {
+					// Recycle packet memory if not used.
+					caerPacketPoolRecycle(packet);
+				}
 				else {
-					caerModuleLog(
-						m.get().runtimeData, CAER_LOG_DEBUG, "Module Output: got null packet at idx=%" PRIi32 ".", i);
+					eventPackets[static_cast<size_t>(destIdx)] = packet;
 				}
 			}
-
-			// Deallocate container memory. Packets have been handled above.
-			free(out);
+			else {
+				caerModuleLog(m.runtimeData, CAER_LOG_DEBUG, "Module Output: got null packet at idx=%" PRIi32 ".", i);
+			}
 		}
+
+		// Recycle container memory. Packets have been handled above.
+		caerPacketPoolContainerRecycle(out);
 	}
+}
 
-	// To finish a run, clean up all the leftover packet memory.
-	for (auto &p : glMainloopData.eventPackets) {
+/**
+ * Give the leftover packets of one mainloop iteration back to the pool,
+ * so that the next iteration's packets can reuse the memory without allocating.
+ */
+static void recycleEventPackets(std::vector<caerEventPacketHeader> &eventPackets) {
+	for (auto &p : eventPackets) {
 		if (p != nullptr) {
-			free(p);
+			caerPacketPoolRecycle(p);
 			p = nullptr;
 		}
 	}
 }
 
+static void runModules(caerEventPacketContainer in) {
+	// Run through all modules in order.
+	for (const auto &m : glMainloopData.globalExecution) {
+		runModule(m.get(), glMainloopData.eventPackets, in);
+	}
+
+	// To finish a run, clean up all the leftover packet memory.
+	recycleEventPackets(glMainloopData.eventPackets);
+}
+
+/**
+ * Pipelined execution: every module runs on its own thread, in global
+ * execution order. Each mainloop iteration is a frame that holds its own
+ * event packet slots and input container, and frames flow from one module
+ * to the next over lock-free ring buffers. A module can thus work on
+ * iteration N+1 while the next module still works on iteration N. Every
+ * module sees the iterations in order, with the same packets as in the
+ * sequential execution, since the global order is a topological order of
+ * the stream dependencies.
+ */
+struct PipelineFrame {
+	std::vector<caerEventPacketHeader> eventPackets;
+	caerEventPacketContainer inputContainer;
+
+	PipelineFrame(size_t slots, caerEventPacketContainer in) : eventPackets(slots, nullptr), inputContainer(in) {
+	}
+
+	~PipelineFrame() {
+		recycleEventPackets(eventPackets);
+		free(inputContainer);
+	}
+};
+
+/**
+ * Single-producer, single-consumer frame queue. The consumer sleeps on a
+ * condition variable while the ring buffer is empty.
+ */
+struct PipelineQueue {
+	caerRingBuffer ring;
+	std::mutex lock;
+	std::condition_variable wakeup;
+
+	PipelineQueue(size_t size) : ring(caerRingBufferInit(size)) {
+		if (ring == nullptr) {
+			throw std::bad_alloc();
+		}
+	}
+
+	~PipelineQueue() {
+		caerRingBufferFree(ring);
+	}
+
+	void put(PipelineFrame *frame) {
+		if (!caerRingBufferPut(ring, frame)) {
+			// The ring buffers can hold all the frames at once.
+			throw std::length_error("Pipeline queue full, this should never happen.");
+		}
+
+		// Taking the lock guarantees that a consumer which found the ring
+		// buffer empty is already waiting, and thus gets the notification.
+		{ std::lock_guard<std::mutex> guard(lock); }
+		wakeup.notify_one();
+	}
+
+	// Returns nullptr only if the queue is empty and stop is set.
+	PipelineFrame *get(const std::atomic_bool &stop) {
+		auto frame = static_cast<PipelineFrame *>(caerRingBufferGet(ring));
+		if (frame != nullptr) {
+			return (frame);
+		}
+
+		std::unique_lock<std::mutex> guard(lock);
+		wakeup.wait(guard, [this, &stop]() { return (caerRingBufferLook(ring) != nullptr || stop.load()); });
+
+		return (static_cast<PipelineFrame *>(caerRingBufferGet(ring)));
+	}
+
+	void interrupt() {
+		{ std::lock_guard<std::mutex> guard(lock); }
+		wakeup.notify_all();
+	}
+};
+
+struct Pipeline {
+	std::vector<std::unique_ptr<PipelineFrame>> frames;
+	// Queue i feeds the module at position i in the global order, the last
+	// queue brings the finished frames back to the mainloop thread.
+	std::vector<std::unique_ptr<PipelineQueue>> queues;
+	// Frames that are not in flight, only used by the mainloop thread.
+	std::vector<PipelineFrame *> idleFrames;
+	std::vector<std::thread> threads;
+	std::atomic_bool stop;
+	// First exception thrown by a module thread, rethrown on the mainloop thread.
+	std::mutex errorLock;
+	std::exception_ptr error;
+
+	Pipeline() : stop(false) {
+	}
+};
+
+/**
+ * Stop the pipeline after a module threw: the module threads finish the frames
+ * already queued and exit, the queues stop blocking, and the mainloop stops.
+ */
+static void pipelineFail(Pipeline &pipeline, std::exception_ptr error) {
+	{
+		std::lock_guard<std::mutex> guard(pipeline.errorLock);
+		if (!pipeline.error) {
+			pipeline.error = error;
+		}
+	}
+
+	pipeline.stop.store(true);
+
+	for (auto &queue : pipeline.queues) {
+		queue->interrupt();
+	}
+
+	glMainloopData.running.store(false);
+	mainloopWakeUp(glMainloopData);
+}
+
+/**
+ * Join the module threads and rethrow a module's exception on the mainloop
+ * thread, as the sequential execution would. Called when the last queue
+ * returned no frame, which only happens after pipelineFail().
+ */
+static void pipelineRethrow(Pipeline &pipeline) {
+	for (auto &thread : pipeline.threads) {
+		if (thread.joinable()) {
+			thread.join();
+		}
+	}
+
+	std::lock_guard<std::mutex> guard(pipeline.errorLock);
+	std::rethrow_exception(pipeline.error);
+}
+
+static void pipelineRunStage(Pipeline &pipeline, size_t position) {
+	ModuleInfo &m         = glMainloopData.globalExecution[position].get();
+	PipelineQueue &input  = *pipeline.queues[position];
+	PipelineQueue &output = *pipeline.queues[position + 1];
+	bool isLastStage      = (position + 1 == glMainloopData.globalExecution.size());
+
+	while (PipelineFrame *frame = input.get(pipeline.stop)) {
+		try {
+			runModule(m, frame->eventPackets, frame->inputContainer);
+		}
+		catch (...) {
+			// The frame stays owned by the pipeline, and is freed with it.
+			pipelineFail(pipeline, std::current_exception());
+			return;
+		}
+
+		if (isLastStage) {
+			// To finish an iteration, clean up all the leftover packet memory.
+			recycleEventPackets(frame->eventPackets);
+		}
+
+		output.put(frame);
+	}
+}
+
+static std::unique_ptr<Pipeline> pipelineStart() {
+	std::unique_ptr<Pipeline> pipeline(new Pipeline());
+
+	size_t stagesNumber = glMainloopData.globalExecution.size();
+
+	// Two frames per module keep every module busy even if the modules'
+	// durations vary between iterations. Ring buffer sizes must be powers of two.
+	size_t framesNumber = 1;
+	while (framesNumber < 2 * stagesNumber) {
+		framesNumber <<= 1;
+	}
+
+	for (size_t i = 0; i < framesNumber; i++) {
+		caerEventPacketContainer in
+			= caerEventPacketContainerAllocate(static_cast<int32_t>(getMaximumInputNumber()));
+		if (in == nullptr) {
+			return (nullptr);
+		}
+
+		pipeline->frames.emplace_back(new PipelineFrame(glMainloopData.eventPackets.size(), in));
+		pipeline->idleFrames.push_back(pipeline->frames.back().get());
+	}
+
+	for (size_t i = 0; i <= stagesNumber; i++) {
+		pipeline->queues.emplace_back(new PipelineQueue(framesNumber));
+	}
+
+	for (size_t i = 0; i < stagesNumber; i++) {
+		pipeline->threads.emplace_back(&pipelineRunStage, std::ref(*pipeline), i);
+	}
+
+	return (pipeline);
+}
+
+/**
+ * Start a new iteration. Blocks while all the frames are in flight.
+ */
+static void pipelinePush(Pipeline &pipeline) {
+	PipelineFrame *frame = nullptr;
+
+	if (pipeline.idleFrames.empty()) {
+		frame = pipeline.queues.back()->get(pipeline.stop);
+		if (frame == nullptr) {
+			pipelineRethrow(pipeline);
+		}
+	}
+	else {
+		frame = pipeline.idleFrames.back();
+		pipeline.idleFrames.pop_back();
+	}
+
+	pipeline.queues.front()->put(frame);
+}
+
+/**
+ * Wait for all the iterations in flight to go through every module.
+ */
+static void pipelineDrain(Pipeline &pipeline) {
+	while (pipeline.idleFrames.size() < pipeline.frames.size()) {
+		PipelineFrame *frame = pipeline.queues.back()->get(pipeline.stop);
+		if (frame == nullptr) {
+			pipelineRethrow(pipeline);
+		}
+
+		pipeline.idleFrames.push_back(frame);
+	}
+}
+
+static void pipelineStop(Pipeline &pipeline) {
+	pipelineDrain(pipeline);
+
+	pipeline.stop.store(true);
+
+	for (auto &queue : pipeline.queues) {
+		queue->interrupt();
+	}
+
+	for (auto &thread : pipeline.threads) {
+		thread.join();
+	}
+}
+
 static void cleanupGlobals() {
 	for (auto &m : glMainloopData.modules) {
 		if (m.second.libraryInfo != nullptr) {
@@ -1368,11 +1668,50 @@ static void cleanupGlobals() {
 	glMainloopData.streams.clear();
 	glMainloopData.globalExecution.clear();
 
-	glMainloopData.copyCount = 0;
+	glMainloopData.copyCount  = 0;
+	glMainloopData.shareCount = 0;
 
 	std::for_each(glMainloopData.eventPackets.begin(), glMainloopData.eventPackets.end(),
-		[](caerEventPacketHeader p) { free(p); });
+		[](caerEventPacketHeader p) { caerPacketPoolRecycle(p); });
 	glMainloopData.eventPackets.clear();
+
+	// Return the pooled memory to the system, the next mainloop may use different packet sizes.
+	caerPacketPoolRelease();
+}
+
+/**
+ * Wait until data is available, the mainloop is stopped, or the deadline is
+ * reached. Busy-wait for up to spinTime first, since going to sleep and waking
+ * up again adds latency, then sleep until an input signals new data.
+ */
+static void waitForData(std::chrono::steady_clock::time_point deadline, std::chrono::microseconds spinTime) {
+	auto dataOrStop = []() {
+		return ((glMainloopData.dataAvailable.load() > 0) || !glMainloopData.running.load(std::memory_order_relaxed));
+	};
+
+	if (spinTime.count() > 0) {
+		const auto spinEnd = std::min(std::chrono::steady_clock::now() + spinTime, deadline);
+
+		while (std::chrono::steady_clock::now() < spinEnd) {
+			if (dataOrStop()) {
+				return;
+			}
+		}
+	}
+
+	// Signal handlers cannot wake us up, so don't sleep too long at once
+	// to notice a shutdown request in time.
+	const auto sleepEnd = std::min(std::chrono::steady_clock::now() + std::chrono::milliseconds(100), deadline);
+
+	// Sequentially consistent store, paired with the load in mainloopWakeUp().
+	glMainloopData.dataWaiting.store(true);
+
+	{
+		std::unique_lock<std::mutex> lock(glMainloopData.dataWaitMutex);
+		glMainloopData.dataWaitSignal.wait_until(lock, sleepEnd, dataOrStop);
+	}
+
+	glMainloopData.dataWaiting.store(false);
 }
 
 static int caerMainloopRunner() {
@@ -1765,21 +2104,62 @@ static int caerMainloopRunner() {
 		return (EXIT_FAILURE);
 	}
 
+	// Pipelined execution (see Pipeline) is selected when the mainloop starts.
+	std::unique_ptr<Pipeline> pipeline;
+
+	if (sshsNodeGetBool(sshsGetNode(sshsGetGlobal(), "/caer/"), "pipelinedExecution")) {
+		pipeline = pipelineStart();
+		if (pipeline == nullptr) {
+			free(inputContainer);
+
+			// No module ran yet, only their runtime memory must be destroyed.
+			for (const auto &m : glMainloopData.globalExecution) {
+				caerModuleDestroy(m.get().runtimeData);
+				m.get().runtimeData = nullptr;
+			}
+
+			// Cleanup modules and streams on exit.
+			cleanupGlobals();
+
+			log(logLevel::ERROR, "Mainloop", "Failed to allocate pipeline frames.");
+
+			return (EXIT_FAILURE);
+		}
+
+		log(logLevel::INFO, "Mainloop", "Pipelined execution, %zu module threads.", pipeline->threads.size());
+	}
+
+	// Run one iteration, or start it in pipelined mode.
+	auto runIteration = [&pipeline, inputContainer]() {
+		if (pipeline) {
+			pipelinePush(*pipeline);
+		}
+		else {
+			runModules(inputContainer);
+		}
+	};
+
 	log(logLevel::INFO, "Mainloop", "Started successfully.");
 
 	// Run modules once right away to give possibility of initializing and
 	// getting some initial data (dataAvailable > 0).
-	runModules(inputContainer);
+	runIteration();
+	if (pipeline) {
+		pipelineDrain(*pipeline);
+	}
 
 	// Write config to file, at this point basic configuration is available.
 	caerConfigWriteBack();
 
-	// If no data is available, sleep for a millisecond to avoid wasting resources.
-	// Every second, run all module state machines anyway to ensure they can do
-	// operations such as opening new devices.
+	// If no data is available, sleep until an input signals new data, to avoid
+	// wasting resources. Every second, run all module state machines anyway to
+	// ensure they can do operations such as opening new devices.
 	auto currTime    = std::chrono::steady_clock::now();
 	auto lastRanTime = currTime;
 
+	const auto idleSpinTime
+		= std::chrono::microseconds(sshsNodeGetInt(sshsGetNode(sshsGetGlobal(), "/caer/"), "idleSpinTime"));
+
 	// Wait for someone to toggle the mainloop shutdown flag.
 	while (glMainloopData.running.load(std::memory_order_relaxed)) {
 		currTime         = std::chrono::steady_clock::now();
@@ -1788,16 +2168,22 @@ static int caerMainloopRunner() {
 		// Run only if data available to consume, else sleep. But make a run
 		// anyway each second, to detect new devices for example.
 		if ((glMainloopData.dataAvailable.load(std::memory_order_acquire) > 0) || (lastRanDiff.count() >= 1000)) {
-			runModules(inputContainer);
+			runIteration();
 			// TODO: handle exceptions here.
 
 			lastRanTime = currTime;
 		}
 		else {
-			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			waitForData(lastRanTime + std::chrono::seconds(1), idleSpinTime);
 		}
 	}
 
+	// Let the iterations in flight go through every module before the modules
+	// stop, as they would have in the sequential execution.
+	if (pipeline) {
+		pipelineDrain(*pipeline);
+	}
+
 	// Shutdown all modules. This makes them all go into the exit
 	// state for the next and last runModules() call.
 	for (const auto &m : glMainloopData.globalExecution) {
@@ -1805,7 +2191,11 @@ static int caerMainloopRunner() {
 	}
 
 	// Run through the loop one last time to correctly shutdown all the modules.
-	runModules(inputContainer);
+	runIteration();
+	if (pipeline) {
+		pipelineStop(*pipeline);
+		pipeline.reset();
+	}
 
 	// Destroy the runtime memory for all modules.
 	for (const auto &m : glMainloopData.globalExecution) {
@@ -1814,6 +2204,16 @@ static int caerMainloopRunner() {
 
 	free(inputContainer);
 
+	struct caer_packet_pool_statistics poolStatistics;
+	caerPacketPoolGetStatistics(&poolStatistics);
+	log(logLevel::INFO, "Mainloop",
+		"Packet pool: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " recycled, %" PRIu64 " released.",
+		poolStatistics.hits, poolStatistics.misses, poolStatistics.recycled, poolStatistics.released);
+	log(logLevel::INFO, "Mainloop",
+		"Packet sharing: %" PRIu64 " shared, %" PRIu64 " copied on write, %" PRIu64 " copies saved.",
+		poolStatistics.shared, poolStatistics.copied,
+		(poolStatistics.shared > poolStatistics.copied) ? (poolStatistics.shared - poolStatistics.copied) : (0));
+
 	// Cleanup modules and streams on exit.
 	cleanupGlobals();
 
@@ -1844,13 +2244,15 @@ static void printDebugInformation() {
 	log(logLevel::DEBUG, "Mainloop", "Global order: %s", orderPrint.str().c_str());
 
 	log(logLevel::DEBUG, "Mainloop", "Global copy count: %d", glMainloopData.copyCount);
+	log(logLevel::DEBUG, "Mainloop", "Global share count: %d", glMainloopData.shareCount);
 
 	for (const auto &m : glMainloopData.globalExecution) {
 		log(logLevel::DEBUG, "Mainloop", "Module %d: type %d - %s", m.get().id, m.get().libraryInfo->type,
 			m.get().name.c_str());
 
 		for (const auto &i : m.get().inputs) {
-			log(logLevel::DEBUG, "Mainloop", " --> IN: dest=%d - slot=%d", i.first, i.second);
+			log(logLevel::DEBUG, "Mainloop", " --> IN: dest=%d - slot=%d - writable=%d", i.index, i.copyFrom,
+				i.makeWritable);
 		}
 
 		std::vector<std::pair<int16_t, ssize_t>> orderedOutputs(m.get().outputs.cbegin(), m.get().outputs.cend());
@@ -1895,6 +2297,7 @@ static void caerMainloopSystemRunningListener(sshsNode node, void *userData, enu
 	if (event == SSHS_ATTRIBUTE_MODIFIED && changeType == SSHS_BOOL && caerStrEquals(changeKey, "running")) {
 		glMainloopData.systemRunning.store(false);
 		glMainloopData.running.store(false);
+		mainloopWakeUp(glMainloopData);
 	}
 }
 
@@ -1905,6 +2308,7 @@ static void caerMainloopRunningListener(sshsNode node, void *userData, enum sshs
 
 	if (event == SSHS_ATTRIBUTE_MODIFIED && changeType == SSHS_BOOL && caerStrEquals(changeKey, "running")) {
 		glMainloopData.running.store(changeValue.boolean);
+		mainloopWakeUp(glMainloopData);
 	}
 }
 
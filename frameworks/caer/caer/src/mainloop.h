@@ -5,8 +5,10 @@
 #include "caer-sdk/module.h"
 #include "module.h"
 
+#include <condition_variable>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -16,8 +18,9 @@ struct OrderedInput {
 	int16_t typeId;
 	int16_t afterModuleId;
 	bool copyNeeded;
+	bool copyOnWrite;
 
-	OrderedInput(int16_t t, int16_t a) : typeId(t), afterModuleId(a), copyNeeded(false) {
+	OrderedInput(int16_t t, int16_t a) : typeId(t), afterModuleId(a), copyNeeded(false), copyOnWrite(false) {
 	}
 
 	// Comparison operators.
@@ -46,6 +49,22 @@ struct OrderedInput {
 	}
 };
 
+struct ModuleInput {
+	// Global event packet slot passed to the module.
+	ssize_t index;
+	// Slot the data is shared from, -1 if the module uses the slot's own data.
+	ssize_t copyFrom;
+	// Module modifies the data in place, without going through the packet pool.
+	bool makeWritable;
+
+	ModuleInput(ssize_t i, ssize_t c, bool w) : index(i), copyFrom(c), makeWritable(w) {
+	}
+
+	bool operator<(const ModuleInput &rhs) const noexcept {
+		return (index < rhs.index || (index == rhs.index && copyFrom < rhs.copyFrom));
+	}
+};
+
 struct ModuleInfo {
 	// Module identification.
 	int16_t id;
@@ -55,7 +74,7 @@ struct ModuleInfo {
 	// Parsed moduleInput configuration.
 	std::unordered_map<int16_t, std::vector<OrderedInput>> inputDefinition;
 	// Connectivity graph (I/O).
-	std::vector<std::pair<ssize_t, ssize_t>> inputs;
+	std::vector<ModuleInput> inputs;
 	std::unordered_map<int16_t, ssize_t> outputs;
 	// Loadable module support.
 	const std::string library;
@@ -159,13 +178,34 @@ struct MainloopData {
 	atomic_bool systemRunning;
 	atomic_bool running;
 	atomic_uint_fast32_t dataAvailable;
+	// Wakes up the mainloop when data becomes available while it sleeps.
+	atomic_bool dataWaiting;
+	std::mutex dataWaitMutex;
+	std::condition_variable dataWaitSignal;
 	size_t copyCount;
+	size_t shareCount;
 	std::unordered_map<int16_t, ModuleInfo> modules;
 	std::vector<ActiveStreams> streams;
 	std::vector<std::reference_wrapper<ModuleInfo>> globalExecution;
 	std::vector<caerEventPacketHeader> eventPackets;
 };
 
+/*
+ * Wake up the mainloop if it is sleeping, so it checks for new data and
+ * for shutdown. Not async-signal-safe.
+ */
+inline void mainloopWakeUp(MainloopData &data) {
+	// Sequentially consistent load, paired with the store in the mainloop:
+	// either the mainloop sees the change before sleeping, or we see it waiting.
+	if (data.dataWaiting.load()) {
+		// Take the lock so the notification cannot fall between the mainloop
+		// checking for data and starting to wait.
+		{ std::lock_guard<std::mutex> lock(data.dataWaitMutex); }
+
+		data.dataWaitSignal.notify_one();
+	}
+}
+
 #ifdef __cplusplus
 extern "C" {
 #endif
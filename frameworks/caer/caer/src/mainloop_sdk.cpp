@@ -9,7 +9,10 @@ void caerMainloopSDKLibInit(MainloopData *setMainloopPtr) {
 void caerMainloopDataNotifyIncrease(void *p) {
 	UNUSED_ARGUMENT(p);
 
-	glMainloopDataPtr->dataAvailable.fetch_add(1, std::memory_order_release);
+	// Sequentially consistent, see mainloopWakeUp().
+	glMainloopDataPtr->dataAvailable.fetch_add(1);
+
+	mainloopWakeUp(*glMainloopDataPtr);
 }
 
 void caerMainloopDataNotifyDecrease(void *p) {
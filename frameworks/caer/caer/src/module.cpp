@@ -625,6 +625,8 @@ void caerUpdateModulesInformation() {
 					SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT, "Number of inputs of this type (-1 for any number).");
 				sshsNodeCreate(inputStreamNode, "readOnly", inputStream->readOnly,
 					SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT, "Whether this input is modified or not.");
+				sshsNodeCreate(inputStreamNode, "copyOnWrite", inputStream->copyOnWrite,
+					SSHS_FLAGS_READ_ONLY | SSHS_FLAGS_NO_EXPORT, "Whether this input is copied only when modified.");
 			}
 		}
 
@@ -683,8 +683,9 @@ static inline void caerEventPacketClean(caerEventPacketHeader packet) {
 
 	if (dest != caerIteratorElement) {
 		memcpy(dest, caerIteratorElement, (size_t) eventSize);
-		offset += (size_t) eventSize;
 	}
+
+	offset += (size_t) eventSize;
 }
 
 // Reset remaining memory, up to capacity, to zero (all events invalid).
@@ -694,6 +695,79 @@ memset(((uint8_t *) packet) + offset, 0, (size_t)((eventCapacity - eventValid) *
 caerEventPacketHeaderSetEventNumber(packet, eventValid);
 }
 
+/**
+ * Default valid events ratio for caerEventPacketCompact().
+ * Below it, compacting once costs less than having every following
+ * consumer of the packet skip the invalid events.
+ */
+#define CAER_EVENT_PACKET_COMPACT_RATIO 0.75f
+
+/**
+ * Clean a packet, as caerEventPacketClean() does, but only if the
+ * ratio of valid events to total events fell below a threshold.
+ * Filters that invalidate events in place should call this once they
+ * are done, so that later modules iterate only over the events that
+ * are left, while packets with few invalid events are not moved around.
+ * Runs of consecutive valid events are moved at once, and only the
+ * memory up to the old event number is cleared.
+ * The packet's capacity doesn't change.
+ *
+ * @param packet an event packet to compact.
+ * @param validRatio compact if eventValid < validRatio * eventNumber,
+ *                   see CAER_EVENT_PACKET_COMPACT_RATIO.
+ *
+ * @return true if the packet was compacted.
+ */
+static inline bool caerEventPacketCompact(caerEventPacketHeader packet, float validRatio) {
+	// Handle empty event packets.
+	if (packet == NULL) {
+		return (false);
+	}
+
+	int32_t eventValid  = caerEventPacketHeaderGetEventValid(packet);
+	int32_t eventNumber = caerEventPacketHeaderGetEventNumber(packet);
+
+	if (eventValid == eventNumber || (float) eventValid >= validRatio * (float) eventNumber) {
+		return (false);
+	}
+
+	size_t eventSize = (size_t) caerEventPacketHeaderGetEventSize(packet);
+	uint8_t *events  = ((uint8_t *) packet) + CAER_EVENT_PACKET_HEADER_SIZE;
+
+	size_t destOffset = 0;
+	int32_t index     = 0;
+
+	while (index < eventNumber) {
+		// Skip invalid events.
+		while (index < eventNumber && !caerGenericEventIsValid(events + ((size_t) index * eventSize))) {
+			index++;
+		}
+
+		// Find the end of the run of valid events, and move it in one go.
+		int32_t runStart = index;
+
+		while (index < eventNumber && caerGenericEventIsValid(events + ((size_t) index * eventSize))) {
+			index++;
+		}
+
+		size_t runSize = (size_t)(index - runStart) * eventSize;
+
+		if (runSize > 0 && destOffset != ((size_t) runStart * eventSize)) {
+			memmove(events + destOffset, events + ((size_t) runStart * eventSize), runSize);
+		}
+
+		destOffset += runSize;
+	}
+
+	// Reset the memory freed up, up to the old event number, to zero (all events invalid).
+	// The rest up to capacity is by definition already zeroed out.
+	memset(events + destOffset, 0, ((size_t) eventNumber * eventSize) - destOffset);
+
+	caerEventPacketHeaderSetEventNumber(packet, eventValid);
+
+	return (true);
+}
+
 /**
  * Resize an event packet.
  * First, the packet is cleaned (all invalid events removed), then:
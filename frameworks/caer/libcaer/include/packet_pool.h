@@ -0,0 +1,241 @@
+/**
+ * @file packet_pool.h
+ *
+ * Recycling allocator for event packets and event packet containers.
+ * Event packets are grouped in size classes (event size and a power of
+ * two capacity), and the memory of recycled packets is handed out again
+ * instead of being returned to the system, so that a pipeline in steady
+ * state does not allocate.
+ * Pooled packets and containers are regular heap blocks: calling free()
+ * on them is always correct, it only bypasses the pool. Conversely, any
+ * packet allocated by the functions in 'events/common.h' can be recycled.
+ * Recycling relies on the libcaer invariant that events at and beyond
+ * eventNumber are zeroed (invalid), and only clears the used events.
+ * A packet can also be shared between several holders, each of which
+ * gives its reference back with caerPacketPoolRecycle(). A holder that
+ * wants to modify a shared packet must first get its own copy with
+ * caerPacketPoolMakeWritable(), the copy is only made at that point.
+ * Shared packets must not be passed to free().
+ * All functions are thread-safe.
+ */
+
+#ifndef LIBCAER_PACKET_POOL_H_
+#define LIBCAER_PACKET_POOL_H_
+
+#include "events/packetContainer.h"
+#include "events/point2d.h"
+#include "events/point3d.h"
+#include "events/polarity.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Maximum number of free blocks kept per size class.
+ * Recycled blocks beyond this number are freed.
+ */
+#define CAER_PACKET_POOL_CLASS_DEPTH 32
+
+/**
+ * Largest pooled event capacity. Larger packets are allocated and freed
+ * directly, and count as misses.
+ */
+#define CAER_PACKET_POOL_MAX_CAPACITY (1 << 24)
+
+/**
+ * Largest pooled container size, in number of event packet pointers.
+ */
+#define CAER_PACKET_POOL_MAX_CONTAINER_PACKETS 16
+
+/**
+ * Packet pool usage counters, cumulative since the program started.
+ */
+struct caer_packet_pool_statistics {
+	/// Number of allocations served from a recycled block.
+	uint64_t hits;
+	/// Number of allocations that required a new heap block.
+	uint64_t misses;
+	/// Number of blocks put back in the pool.
+	uint64_t recycled;
+	/// Number of blocks freed because their class was full or they could not be pooled.
+	uint64_t released;
+	/// Number of references added to packets by caerPacketPoolShare().
+	uint64_t shared;
+	/// Number of packet copies made because a shared packet was modified.
+	/// Copies saved by sharing are the difference between shared and copied.
+	uint64_t copied;
+};
+
+/**
+ * Get an event packet from the pool, or allocate a new one if the pool
+ * has no free block in the matching size class.
+ * The packet is zeroed (all events invalid) and its header filled in.
+ * Its capacity is rounded up to the next power of two, do not shrink it
+ * if the packet is to be recycled efficiently.
+ *
+ * @param eventCapacity the minimum number of events this packet will hold.
+ * @param eventSource the unique ID representing the source/generator of this packet.
+ * @param tsOverflow the current timestamp overflow counter value for this packet.
+ * @param eventType the numerical type ID of the events.
+ * @param eventSize the size of one event in bytes.
+ * @param eventTSOffset the offset of the main timestamp in an event, in bytes.
+ *
+ * @return memory for an event packet, NULL on error.
+ */
+caerEventPacketHeader caerPacketPoolAllocate(int32_t eventCapacity, int16_t eventSource, int32_t tsOverflow,
+	int16_t eventType, int32_t eventSize, int32_t eventTSOffset);
+
+/**
+ * Make a copy of an event packet using pooled memory, including only
+ * the currently present events (eventNumber, valid+invalid).
+ * This is the pooled equivalent of caerEventPacketCopyOnlyEvents().
+ *
+ * @param packet an event packet to copy.
+ *
+ * @return a copy of the event packet, NULL if the packet is empty or on error.
+ */
+caerEventPacketHeader caerPacketPoolCopyOnlyEvents(caerEventPacketHeaderConst packet);
+
+/**
+ * Give an event packet back to the pool. The packet must not be used
+ * afterwards. NULL is accepted and ignored.
+ *
+ * @param packet an event packet allocated by libcaer, pooled or not.
+ */
+void caerPacketPoolRecycle(caerEventPacketHeader packet);
+
+/**
+ * Add a holder to an event packet. The packet is only freed or recycled
+ * once every holder has called caerPacketPoolRecycle() on it.
+ * NULL is accepted and returned.
+ *
+ * @param packet an event packet allocated by libcaer, pooled or not.
+ *
+ * @return the packet itself, or a copy of it if the new reference could
+ *         not be recorded (NULL on error).
+ */
+caerEventPacketHeader caerPacketPoolShare(caerEventPacketHeader packet);
+
+/**
+ * Make sure the caller is the only holder of an event packet before
+ * modifying it. If the packet is shared, the caller's reference is given
+ * back and a private copy (only the present events, or an empty packet of
+ * the same type if there are none) is returned instead. Otherwise, the
+ * packet is returned as is.
+ *
+ * @param packet an event packet held by the caller.
+ *
+ * @return a packet that can be modified, NULL on error (the caller then
+ *         still holds the original packet, unmodified).
+ */
+caerEventPacketHeader caerPacketPoolMakeWritable(caerEventPacketHeader packet);
+
+/**
+ * Find the first event packet of the given type in a container, make it
+ * writable with caerPacketPoolMakeWritable(), and replace it in the container.
+ * Use this instead of caerEventPacketContainerFindEventPacketByType() on
+ * inputs a module modifies.
+ *
+ * @param container the event packet container holding the module's inputs.
+ * @param typeID the event type to search for.
+ *
+ * @return a packet that can be modified, NULL if no packet of this type
+ *         was found or on error.
+ */
+caerEventPacketHeader caerPacketPoolContainerMakeWritable(caerEventPacketContainer container, int16_t typeID);
+
+/**
+ * Get an event packet container from the pool, or allocate a new one.
+ * All packet pointers are NULL, as with caerEventPacketContainerAllocate().
+ *
+ * @param eventPacketsNumber the maximum number of EventPacket pointers
+ *                           that can be stored in this container.
+ *
+ * @return a valid EventPacketContainer handle or NULL on error.
+ */
+caerEventPacketContainer caerPacketPoolContainerAllocate(int32_t eventPacketsNumber);
+
+/**
+ * Give an event packet container back to the pool. The contained event
+ * packets are NOT recycled, see caerPacketPoolContainerRecycleAll().
+ * NULL is accepted and ignored.
+ *
+ * @param container an event packet container allocated by libcaer, pooled or not.
+ */
+void caerPacketPoolContainerRecycle(caerEventPacketContainer container);
+
+/**
+ * Give an event packet container and all its event packets back to
+ * the pool. This is the pooled equivalent of caerEventPacketContainerFree().
+ *
+ * @param container an event packet container allocated by libcaer, pooled or not.
+ */
+void caerPacketPoolContainerRecycleAll(caerEventPacketContainer container);
+
+/**
+ * Free all the blocks currently held by the pool.
+ * The statistics are not reset.
+ */
+void caerPacketPoolRelease(void);
+
+/**
+ * Read the pool usage counters.
+ *
+ * @param statistics the structure to fill. Cannot be NULL.
+ */
+void caerPacketPoolGetStatistics(struct caer_packet_pool_statistics *statistics);
+
+/**
+ * Get a polarity events packet from the pool.
+ * Give it back with caerPacketPoolRecycle().
+ *
+ * @param eventCapacity the minimum number of events this packet will hold.
+ * @param eventSource the unique ID representing the source/generator of this packet.
+ * @param tsOverflow the current timestamp overflow counter value for this packet.
+ *
+ * @return a valid PolarityEventPacket handle or NULL on error.
+ */
+static inline caerPolarityEventPacket caerPacketPoolPolarityAllocate(
+	int32_t eventCapacity, int16_t eventSource, int32_t tsOverflow) {
+	return ((caerPolarityEventPacket) caerPacketPoolAllocate(eventCapacity, eventSource, tsOverflow, POLARITY_EVENT,
+		sizeof(struct caer_polarity_event), offsetof(struct caer_polarity_event, timestamp)));
+}
+
+/**
+ * Get a Point2D events packet from the pool.
+ * Give it back with caerPacketPoolRecycle().
+ *
+ * @param eventCapacity the minimum number of events this packet will hold.
+ * @param eventSource the unique ID representing the source/generator of this packet.
+ * @param tsOverflow the current timestamp overflow counter value for this packet.
+ *
+ * @return a valid Point2DEventPacket handle or NULL on error.
+ */
+static inline caerPoint2DEventPacket caerPacketPoolPoint2DAllocate(
+	int32_t eventCapacity, int16_t eventSource, int32_t tsOverflow) {
+	return ((caerPoint2DEventPacket) caerPacketPoolAllocate(eventCapacity, eventSource, tsOverflow, POINT2D_EVENT,
+		sizeof(struct caer_point2d_event), offsetof(struct caer_point2d_event, timestamp)));
+}
+
+/**
+ * Get a Point3D events packet from the pool.
+ * Give it back with caerPacketPoolRecycle().
+ *
+ * @param eventCapacity the minimum number of events this packet will hold.
+ * @param eventSource the unique ID representing the source/generator of this packet.
+ * @param tsOverflow the current timestamp overflow counter value for this packet.
+ *
+ * @return a valid Point3DEventPacket handle or NULL on error.
+ */
+static inline caerPoint3DEventPacket caerPacketPoolPoint3DAllocate(
+	int32_t eventCapacity, int16_t eventSource, int32_t tsOverflow) {
+	return ((caerPoint3DEventPacket) caerPacketPoolAllocate(eventCapacity, eventSource, tsOverflow, POINT3D_EVENT,
+		sizeof(struct caer_point3d_event), offsetof(struct caer_point3d_event, timestamp)));
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* LIBCAER_PACKET_POOL_H_ */
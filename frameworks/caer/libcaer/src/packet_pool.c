@@ -0,0 +1,522 @@
+#include "packet_pool.h"
+#include "c11threads_posix.h"
+#include <stdatomic.h>
+
+// Size classes are created on demand, the number of distinct event sizes
+// times the number of capacities used by a program is small.
+#define PACKET_CLASSES_MAX 64
+
+struct packet_pool_block {
+	struct packet_pool_block *next;
+};
+
+// Holders of a shared packet. Only packets with more than one holder are
+// listed, so the table stays as small as the number of shared slots.
+struct packet_pool_reference {
+	const void *packet;
+	size_t holders;
+};
+
+struct packet_pool_class {
+	int32_t eventSize;
+	int32_t eventCapacity;
+	struct packet_pool_block *head;
+	size_t count;
+};
+
+struct packet_pool {
+	once_flag initialized;
+	mtx_t lock;
+	size_t packetClassesNumber;
+	struct packet_pool_class packetClasses[PACKET_CLASSES_MAX];
+	struct packet_pool_block *containerHeads[CAER_PACKET_POOL_MAX_CONTAINER_PACKETS];
+	size_t containerCounts[CAER_PACKET_POOL_MAX_CONTAINER_PACKETS];
+	struct packet_pool_reference *references;
+	size_t referencesNumber;
+	size_t referencesCapacity;
+	atomic_size_t sharedPackets;
+	atomic_uint_fast64_t hits;
+	atomic_uint_fast64_t misses;
+	atomic_uint_fast64_t recycled;
+	atomic_uint_fast64_t released;
+	atomic_uint_fast64_t shared;
+	atomic_uint_fast64_t copied;
+};
+
+static struct packet_pool pool = {.initialized = ONCE_FLAG_INIT};
+
+static void packetPoolInitialize(void) {
+	if (mtx_init(&pool.lock, mtx_plain) != thrd_success) {
+		// Critical error, the pool cannot be used without its lock -> exit!
+		exit(EXIT_FAILURE);
+	}
+}
+
+static inline void packetPoolLock(void) {
+	call_once(&pool.initialized, &packetPoolInitialize);
+	mtx_lock(&pool.lock);
+}
+
+static inline void packetPoolUnlock(void) {
+	mtx_unlock(&pool.lock);
+}
+
+// Free-list operations, must be called with the lock held.
+// Blocks come from malloc(), so they are suitably aligned for the link.
+static inline void pushBlock(struct packet_pool_block **head, void *memory) {
+	struct packet_pool_block *block = memory;
+	block->next                     = *head;
+	*head                           = block;
+}
+
+static inline void *popBlock(struct packet_pool_block **head) {
+	struct packet_pool_block *block = *head;
+	*head                           = block->next;
+	return (block);
+}
+
+// Smallest power of two larger than or equal to value (value > 0).
+static inline int32_t ceilPowerOfTwo(int32_t value) {
+	int32_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return (result);
+}
+
+// Largest power of two smaller than or equal to value (value > 0).
+static inline int32_t floorPowerOfTwo(int32_t value) {
+	int32_t result = 1;
+	while (result <= (value >> 1)) {
+		result <<= 1;
+	}
+	return (result);
+}
+
+// Must be called with the lock held. Returns NULL if the class table is full.
+static struct packet_pool_class *findPacketClass(int32_t eventSize, int32_t eventCapacity, bool create) {
+	for (size_t i = 0; i < pool.packetClassesNumber; i++) {
+		if (pool.packetClasses[i].eventSize == eventSize && pool.packetClasses[i].eventCapacity == eventCapacity) {
+			return (&pool.packetClasses[i]);
+		}
+	}
+
+	if (!create || pool.packetClassesNumber == PACKET_CLASSES_MAX) {
+		return (NULL);
+	}
+
+	struct packet_pool_class *packetClass = &pool.packetClasses[pool.packetClassesNumber];
+	packetClass->eventSize                = eventSize;
+	packetClass->eventCapacity            = eventCapacity;
+	packetClass->head                     = NULL;
+	packetClass->count                    = 0;
+	pool.packetClassesNumber++;
+
+	return (packetClass);
+}
+
+caerEventPacketHeader caerPacketPoolAllocate(int32_t eventCapacity, int16_t eventSource, int32_t tsOverflow,
+	int16_t eventType, int32_t eventSize, int32_t eventTSOffset) {
+	if ((eventCapacity <= 0) || (eventSource < 0) || (tsOverflow < 0) || (eventType < 0) || (eventSize <= 0)
+		|| (eventTSOffset < 0)) {
+		return (NULL);
+	}
+
+	if (eventCapacity > CAER_PACKET_POOL_MAX_CAPACITY) {
+		atomic_fetch_add_explicit(&pool.misses, 1, memory_order_relaxed);
+		return (caerEventPacketAllocate(eventCapacity, eventSource, tsOverflow, eventType, eventSize, eventTSOffset));
+	}
+
+	int32_t classCapacity = ceilPowerOfTwo(eventCapacity);
+
+	caerEventPacketHeader packet = NULL;
+
+	packetPoolLock();
+
+	struct packet_pool_class *packetClass = findPacketClass(eventSize, classCapacity, false);
+	if (packetClass != NULL && packetClass->head != NULL) {
+		packet = popBlock(&packetClass->head);
+		packetClass->count--;
+	}
+
+	packetPoolUnlock();
+
+	if (packet == NULL) {
+		atomic_fetch_add_explicit(&pool.misses, 1, memory_order_relaxed);
+		return (caerEventPacketAllocate(classCapacity, eventSource, tsOverflow, eventType, eventSize, eventTSOffset));
+	}
+
+	atomic_fetch_add_explicit(&pool.hits, 1, memory_order_relaxed);
+
+	// Events were cleared on recycling, only the free-list link remains in the header.
+	memset(packet, 0, CAER_EVENT_PACKET_HEADER_SIZE);
+
+	caerEventPacketHeaderSetEventType(packet, eventType);
+	caerEventPacketHeaderSetEventSource(packet, eventSource);
+	caerEventPacketHeaderSetEventSize(packet, eventSize);
+	caerEventPacketHeaderSetEventTSOffset(packet, eventTSOffset);
+	caerEventPacketHeaderSetEventTSOverflow(packet, tsOverflow);
+	caerEventPacketHeaderSetEventCapacity(packet, classCapacity);
+
+	return (packet);
+}
+
+caerEventPacketHeader caerPacketPoolCopyOnlyEvents(caerEventPacketHeaderConst packet) {
+	// Handle empty event packets.
+	if (packet == NULL) {
+		return (NULL);
+	}
+
+	int32_t eventNumber = caerEventPacketHeaderGetEventNumber(packet);
+
+	if (eventNumber == 0) {
+		// No copy possible if result is empty (capacity=0).
+		return (NULL);
+	}
+
+	caerEventPacketHeader packetCopy = caerPacketPoolAllocate(eventNumber, caerEventPacketHeaderGetEventSource(packet),
+		caerEventPacketHeaderGetEventTSOverflow(packet), caerEventPacketHeaderGetEventType(packet),
+		caerEventPacketHeaderGetEventSize(packet), caerEventPacketHeaderGetEventTSOffset(packet));
+	if (packetCopy == NULL) {
+		return (NULL);
+	}
+
+	// Copy the events over, the remaining capacity is already zeroed.
+	int32_t classCapacity = caerEventPacketHeaderGetEventCapacity(packetCopy);
+	memcpy(packetCopy, packet,
+		CAER_EVENT_PACKET_HEADER_SIZE + ((size_t) eventNumber * (size_t) caerEventPacketHeaderGetEventSize(packet)));
+	caerEventPacketHeaderSetEventCapacity(packetCopy, classCapacity);
+
+	return (packetCopy);
+}
+
+// Must be called with the lock held. Returns NULL if the packet has a single holder.
+static struct packet_pool_reference *findReference(const void *packet) {
+	for (size_t i = 0; i < pool.referencesNumber; i++) {
+		if (pool.references[i].packet == packet) {
+			return (&pool.references[i]);
+		}
+	}
+
+	return (NULL);
+}
+
+// Drop one holder of a shared packet. Returns false if the packet was not
+// shared, in which case the caller holds the only reference to it.
+static bool dropReference(const void *packet) {
+	// Nothing is shared, skip the lock. A packet being shared by another
+	// thread cannot be the one we are releasing, since we hold it.
+	if (atomic_load_explicit(&pool.sharedPackets, memory_order_acquire) == 0) {
+		return (false);
+	}
+
+	bool dropped = false;
+
+	packetPoolLock();
+
+	struct packet_pool_reference *reference = findReference(packet);
+	if (reference != NULL) {
+		reference->holders--;
+
+		if (reference->holders == 1) {
+			*reference = pool.references[pool.referencesNumber - 1];
+			pool.referencesNumber--;
+			atomic_fetch_sub_explicit(&pool.sharedPackets, 1, memory_order_release);
+		}
+
+		dropped = true;
+	}
+
+	packetPoolUnlock();
+
+	return (dropped);
+}
+
+caerEventPacketHeader caerPacketPoolShare(caerEventPacketHeader packet) {
+	if (packet == NULL) {
+		return (NULL);
+	}
+
+	bool added = false;
+
+	packetPoolLock();
+
+	struct packet_pool_reference *reference = findReference(packet);
+	if (reference != NULL) {
+		reference->holders++;
+		added = true;
+	}
+	else {
+		if (pool.referencesNumber == pool.referencesCapacity) {
+			size_t newCapacity = (pool.referencesCapacity == 0) ? (16) : (pool.referencesCapacity * 2);
+
+			struct packet_pool_reference *newReferences
+				= realloc(pool.references, newCapacity * sizeof(struct packet_pool_reference));
+			if (newReferences != NULL) {
+				pool.references         = newReferences;
+				pool.referencesCapacity = newCapacity;
+			}
+		}
+
+		if (pool.referencesNumber < pool.referencesCapacity) {
+			pool.references[pool.referencesNumber].packet  = packet;
+			pool.references[pool.referencesNumber].holders = 2;
+			pool.referencesNumber++;
+			atomic_fetch_add_explicit(&pool.sharedPackets, 1, memory_order_release);
+			added = true;
+		}
+	}
+
+	packetPoolUnlock();
+
+	if (!added) {
+		// Could not record the new holder, fall back to an eager copy.
+		atomic_fetch_add_explicit(&pool.copied, 1, memory_order_relaxed);
+		return (caerPacketPoolCopyOnlyEvents(packet));
+	}
+
+	atomic_fetch_add_explicit(&pool.shared, 1, memory_order_relaxed);
+
+	return (packet);
+}
+
+caerEventPacketHeader caerPacketPoolMakeWritable(caerEventPacketHeader packet) {
+	if (packet == NULL) {
+		return (NULL);
+	}
+
+	if (atomic_load_explicit(&pool.sharedPackets, memory_order_acquire) == 0) {
+		return (packet);
+	}
+
+	packetPoolLock();
+	bool shared = (findReference(packet) != NULL);
+	packetPoolUnlock();
+
+	if (!shared) {
+		return (packet);
+	}
+
+	// Copy first, so that on failure the caller still holds its reference.
+	// Empty packets cannot be copied, a private empty packet of the same type
+	// is handed out instead, never the shared one.
+	caerEventPacketHeader packetCopy;
+	if (caerEventPacketHeaderGetEventNumber(packet) == 0) {
+		packetCopy = caerPacketPoolAllocate(1, caerEventPacketHeaderGetEventSource(packet),
+			caerEventPacketHeaderGetEventTSOverflow(packet), caerEventPacketHeaderGetEventType(packet),
+			caerEventPacketHeaderGetEventSize(packet), caerEventPacketHeaderGetEventTSOffset(packet));
+	}
+	else {
+		packetCopy = caerPacketPoolCopyOnlyEvents(packet);
+	}
+	if (packetCopy == NULL) {
+		return (NULL);
+	}
+
+	atomic_fetch_add_explicit(&pool.copied, 1, memory_order_relaxed);
+
+	// Another holder may have released the packet in the meantime, in which
+	// case our reference became the last one and must be recycled normally.
+	caerPacketPoolRecycle(packet);
+
+	return (packetCopy);
+}
+
+void caerPacketPoolRecycle(caerEventPacketHeader packet) {
+	if (packet == NULL) {
+		return;
+	}
+
+	if (dropReference(packet)) {
+		return;
+	}
+
+	int32_t eventSize     = caerEventPacketHeaderGetEventSize(packet);
+	int32_t eventCapacity = caerEventPacketHeaderGetEventCapacity(packet);
+	int32_t eventNumber   = caerEventPacketHeaderGetEventNumber(packet);
+
+	// The block is at least as large as its header says, so packets that
+	// were not allocated by the pool go to the class just below their capacity.
+	if ((eventSize <= 0) || (eventCapacity <= 0) || (eventCapacity > CAER_PACKET_POOL_MAX_CAPACITY)
+		|| (eventNumber < 0) || (eventNumber > eventCapacity)) {
+		atomic_fetch_add_explicit(&pool.released, 1, memory_order_relaxed);
+		free(packet);
+		return;
+	}
+
+	int32_t classCapacity = floorPowerOfTwo(eventCapacity);
+
+	// Clear the used events outside of the lock, the rest of the block is already zeroed.
+	memset(((uint8_t *) packet) + CAER_EVENT_PACKET_HEADER_SIZE, 0, (size_t) eventNumber * (size_t) eventSize);
+
+	bool pooled = false;
+
+	packetPoolLock();
+
+	struct packet_pool_class *packetClass = findPacketClass(eventSize, classCapacity, true);
+	if (packetClass != NULL && packetClass->count < CAER_PACKET_POOL_CLASS_DEPTH) {
+		pushBlock(&packetClass->head, packet);
+		packetClass->count++;
+		pooled = true;
+	}
+
+	packetPoolUnlock();
+
+	if (pooled) {
+		atomic_fetch_add_explicit(&pool.recycled, 1, memory_order_relaxed);
+	}
+	else {
+		atomic_fetch_add_explicit(&pool.released, 1, memory_order_relaxed);
+		free(packet);
+	}
+}
+
+caerEventPacketHeader caerPacketPoolContainerMakeWritable(caerEventPacketContainer container, int16_t typeID) {
+	int32_t eventPacketsNum = caerEventPacketContainerGetEventPacketsNumber(container);
+
+	for (int32_t i = 0; i < eventPacketsNum; i++) {
+		caerEventPacketHeader packet = caerEventPacketContainerGetEventPacket(container, i);
+
+		if (packet != NULL && caerEventPacketHeaderGetEventType(packet) == typeID) {
+			caerEventPacketHeader writablePacket = caerPacketPoolMakeWritable(packet);
+			if (writablePacket != NULL) {
+				caerEventPacketContainerSetEventPacket(container, i, writablePacket);
+			}
+
+			return (writablePacket);
+		}
+	}
+
+	return (NULL);
+}
+
+caerEventPacketContainer caerPacketPoolContainerAllocate(int32_t eventPacketsNumber) {
+	if (eventPacketsNumber <= 0) {
+		return (NULL);
+	}
+
+	if (eventPacketsNumber > CAER_PACKET_POOL_MAX_CONTAINER_PACKETS) {
+		atomic_fetch_add_explicit(&pool.misses, 1, memory_order_relaxed);
+		return (caerEventPacketContainerAllocate(eventPacketsNumber));
+	}
+
+	size_t index = (size_t)(eventPacketsNumber - 1);
+
+	caerEventPacketContainer container = NULL;
+
+	packetPoolLock();
+
+	if (pool.containerHeads[index] != NULL) {
+		container = popBlock(&pool.containerHeads[index]);
+		pool.containerCounts[index]--;
+	}
+
+	packetPoolUnlock();
+
+	if (container == NULL) {
+		atomic_fetch_add_explicit(&pool.misses, 1, memory_order_relaxed);
+		return (caerEventPacketContainerAllocate(eventPacketsNumber));
+	}
+
+	atomic_fetch_add_explicit(&pool.hits, 1, memory_order_relaxed);
+
+	memset(container, 0,
+		sizeof(struct caer_event_packet_container) + ((size_t) eventPacketsNumber * sizeof(caerEventPacketHeader)));
+	container->eventPacketsNumber    = eventPacketsNumber;
+	container->lowestEventTimestamp  = -1;
+	container->highestEventTimestamp = -1;
+
+	return (container);
+}
+
+void caerPacketPoolContainerRecycle(caerEventPacketContainer container) {
+	if (container == NULL) {
+		return;
+	}
+
+	int32_t eventPacketsNumber = caerEventPacketContainerGetEventPacketsNumber(container);
+
+	if ((eventPacketsNumber <= 0) || (eventPacketsNumber > CAER_PACKET_POOL_MAX_CONTAINER_PACKETS)) {
+		atomic_fetch_add_explicit(&pool.released, 1, memory_order_relaxed);
+		free(container);
+		return;
+	}
+
+	size_t index = (size_t)(eventPacketsNumber - 1);
+
+	bool pooled = false;
+
+	packetPoolLock();
+
+	if (pool.containerCounts[index] < CAER_PACKET_POOL_CLASS_DEPTH) {
+		pushBlock(&pool.containerHeads[index], container);
+		pool.containerCounts[index]++;
+		pooled = true;
+	}
+
+	packetPoolUnlock();
+
+	if (pooled) {
+		atomic_fetch_add_explicit(&pool.recycled, 1, memory_order_relaxed);
+	}
+	else {
+		atomic_fetch_add_explicit(&pool.released, 1, memory_order_relaxed);
+		free(container);
+	}
+}
+
+void caerPacketPoolContainerRecycleAll(caerEventPacketContainer container) {
+	if (container == NULL) {
+		return;
+	}
+
+	int32_t eventPacketsNum = caerEventPacketContainerGetEventPacketsNumber(container);
+
+	for (int32_t i = 0; i < eventPacketsNum; i++) {
+		caerPacketPoolRecycle(caerEventPacketContainerGetEventPacket(container, i));
+	}
+
+	caerPacketPoolContainerRecycle(container);
+}
+
+static void freeBlocks(struct packet_pool_block *head) {
+	while (head != NULL) {
+		struct packet_pool_block *next = head->next;
+		free(head);
+		head = next;
+	}
+}
+
+void caerPacketPoolRelease(void) {
+	packetPoolLock();
+
+	for (size_t i = 0; i < pool.packetClassesNumber; i++) {
+		freeBlocks(pool.packetClasses[i].head);
+	}
+	pool.packetClassesNumber = 0;
+
+	for (size_t i = 0; i < CAER_PACKET_POOL_MAX_CONTAINER_PACKETS; i++) {
+		freeBlocks(pool.containerHeads[i]);
+		pool.containerHeads[i]  = NULL;
+		pool.containerCounts[i] = 0;
+	}
+
+	// Shared packets are still held by their users and must stay listed,
+	// the table itself goes away once nothing is shared anymore.
+	if (pool.referencesNumber == 0) {
+		free(pool.references);
+		pool.references         = NULL;
+		pool.referencesCapacity = 0;
+	}
+
+	packetPoolUnlock();
+}
+
+void caerPacketPoolGetStatistics(struct caer_packet_pool_statistics *statistics) {
+	statistics->hits     = atomic_load_explicit(&pool.hits, memory_order_relaxed);
+	statistics->misses   = atomic_load_explicit(&pool.misses, memory_order_relaxed);
+	statistics->recycled = atomic_load_explicit(&pool.recycled, memory_order_relaxed);
+	statistics->released = atomic_load_explicit(&pool.released, memory_order_relaxed);
+	statistics->shared   = atomic_load_explicit(&pool.shared, memory_order_relaxed);
+	statistics->copied   = atomic_load_explicit(&pool.copied, memory_order_relaxed);
+}
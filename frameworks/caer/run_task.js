@@ -9,7 +9,7 @@ const pipeline_to_experiment_to_parameters = {
         duration: {
             configuration: 'mask.xml',
             reader_and_sink_to_json: (reader, sink) => JSON.stringify({
-                duration: delta(reader, sink[0]),
+                duration: delta(reader[0], sink[0]),
                 hashes: {
                     events: sink[1],
                     increases: sink[2],
@@ -17,6 +17,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[4],
                     y_hash: sink[5],
                 },
+                counters: reader[1],
+                pool: reader[2],
             }),
         },
         latencies: {
@@ -29,7 +31,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[3],
                     y_hash: sink[4],
                 },
-                points: sink[5].map(([t, time]) => [t, delta(reader, time)]),
+                latencies: sink[5],
+                points: sink[6].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -37,7 +40,7 @@ const pipeline_to_experiment_to_parameters = {
         duration: {
             configuration: 'flow.xml',
             reader_and_sink_to_json: (reader, sink) => JSON.stringify({
-                duration: delta(reader, sink[0]),
+                duration: delta(reader[0], sink[0]),
                 hashes: {
                     events: sink[1],
                     t_hash: sink[2],
@@ -46,6 +49,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[5],
                     y_hash: sink[6],
                 },
+                counters: reader[1],
+                pool: reader[2],
             }),
         },
         latencies: {
@@ -59,7 +64,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[4],
                     y_hash: sink[5],
                 },
-                points: sink[6].map(([t, time]) => [t, delta(reader, time)]),
+                latencies: sink[6],
+                points: sink[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -67,7 +73,7 @@ const pipeline_to_experiment_to_parameters = {
         duration: {
             configuration: 'denoised_flow.xml',
             reader_and_sink_to_json: (reader, sink) => JSON.stringify({
-                duration: delta(reader, sink[0]),
+                duration: delta(reader[0], sink[0]),
                 hashes: {
                     events: sink[1],
                     t_hash: sink[2],
@@ -76,6 +82,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[5],
                     y_hash: sink[6],
                 },
+                counters: reader[1],
+                pool: reader[2],
             }),
         },
         latencies: {
@@ -89,7 +97,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[4],
                     y_hash: sink[5],
                 },
-                points: sink[6].map(([t, time]) => [t, delta(reader, time)]),
+                latencies: sink[6],
+                points: sink[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -97,7 +106,7 @@ const pipeline_to_experiment_to_parameters = {
         duration: {
             configuration: 'masked_denoised_flow.xml',
             reader_and_sink_to_json: (reader, sink) => JSON.stringify({
-                duration: delta(reader, sink[0]),
+                duration: delta(reader[0], sink[0]),
                 hashes: {
                     events: sink[1],
                     t_hash: sink[2],
@@ -106,6 +115,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[5],
                     y_hash: sink[6],
                 },
+                counters: reader[1],
+                pool: reader[2],
             }),
         },
         latencies: {
@@ -119,7 +130,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[4],
                     y_hash: sink[5],
                 },
-                points: sink[6].map(([t, time]) => [t, delta(reader, time)]),
+                latencies: sink[6],
+                points: sink[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -127,7 +139,7 @@ const pipeline_to_experiment_to_parameters = {
         duration: {
             configuration: 'masked_denoised_flow_activity.xml',
             reader_and_sink_to_json: (reader, sink) => JSON.stringify({
-                duration: delta(reader, sink[0]),
+                duration: delta(reader[0], sink[0]),
                 hashes: {
                     events: sink[1],
                     t_hash: sink[2],
@@ -135,6 +147,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[4],
                     y_hash: sink[5],
                 },
+                counters: reader[1],
+                pool: reader[2],
             }),
         },
         latencies: {
@@ -147,7 +161,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: sink[3],
                     y_hash: sink[4],
                 },
-                points: sink[5].map(([t, time]) => [t, delta(reader, time)]),
+                latencies: sink[5],
+                points: sink[6].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -160,8 +175,8 @@ const template = (input, parameters, output) => {
     }
     fs.writeFileSync(output, content);
 }
-if (process.argv.length != 5) {
-    console.error('3 arguments are expected (a pipeline name, an experiment name and an Event Stream filename)');
+if (process.argv.length != 5 && process.argv.length != 6) {
+    console.error('3 or 4 arguments are expected (a pipeline name, an experiment name, an Event Stream filename and an optional speed factor)');
     process.exit(1);
 }
 const experiment_to_parameters = pipeline_to_experiment_to_parameters[process.argv[2]];
@@ -174,6 +189,11 @@ if (parameters == null) {
     console.error(`unknown experiment ${process.argv[3]}`);
     process.exit(1);
 }
+const speed = process.argv.length > 5 ? process.argv[5] : null;
+if (speed != null && process.argv[3] !== 'latencies') {
+    console.error('the speed factor is only supported by the latencies experiment');
+    process.exit(1);
+}
 template(
     `${__dirname}/configurations/${parameters.configuration}`,
     {
@@ -181,7 +201,9 @@ template(
         modules: `${__dirname}/usr/share/caer/modules/`,
         filename: path.resolve(process.argv[4]),
         reader_output: `${__dirname}/temporary/reader.json`,
-        sink_output: `${__dirname}/temporary/sink.json`
+        sink_output: `${__dirname}/temporary/sink.json`,
+        speed: speed == null ? '1' : speed,
+        pipelined: process.env.CAER_PIPELINED_EXECUTION === '1' ? 'true' : 'false',
     },
     `${__dirname}/temporary/configuration.xml`);
 try {
@@ -9,117 +9,267 @@ namespace benchmark {
     /// check validates the number of program arguments.
     void check(int argc) {
         if (argc != 2) {
-            throw std::runtime_error("Syntax: ./run_task /path/to/input.es");
+            throw std::runtime_error("Syntax: ./run_task [--stream] /path/to/input.es");
         }
     }
 
+    /// check_latencies validates the number of latencies program arguments, the speed factor is optional.
+    void check_latencies(int argc) {
+        if (argc != 2 && argc != 3) {
+            throw std::runtime_error("Syntax: ./run_task [--stream] /path/to/input.es [speed factor]");
+        }
+    }
+
+    /// speed returns the speed factor passed as the given argument, or 1 if there is no such argument.
+    double speed(int argc, char* argv[], int index) {
+        return index < argc ? speed_from_string(argv[index]) : 1.0;
+    }
+
+    /// stream removes the --stream flag from the program arguments, and returns whether it was given.
+    /// The readers decode the file on a producer thread (see packet_stream) instead of loading it when the flag is set.
+    bool stream(int& argc, char* argv[]) {
+        for (int index = 1; index < argc; ++index) {
+            if (std::string(argv[index]) == "--stream") {
+                std::copy(argv + index + 1, argv + argc + 1, argv + index);
+                --argc;
+                return true;
+            }
+        }
+        return false;
+    }
+
     /// reader wraps file reading in a kAER producer.
+    /// kAER buffers are time slices rather than packets, hence the reader tags each slice with the index of the
+    /// first packet that it dispatches (see trace_packet), and the downstream stages inherit this tag.
     class reader : public Producer {
         public:
-        reader(const std::string& filename) :
-            _event_stream(filename_to_event_stream(filename)),
-            _is_done(false) {
-            _packet_iterator = _event_stream.packets.begin();
-            _event_iterator = _packet_iterator->begin();
+        reader(const std::string& filename, bool stream = false) :
+            _event_stream(stream ? columnar_event_stream{} : filename_to_columnar_event_stream(filename)),
+            _packet_stream(stream ? new packet_stream(filename) : nullptr),
+            _packet(nullptr),
+            _is_done(false),
+            _packet_index(0),
+            _event_index(0),
+            _trace_stage(trace_stage("reader")) {
+            if (_packet_stream) {
+                _packet_stream->fill();
+            }
         }
         virtual ~reader() {}
         void update_output(timestamp t, int buffer_id, bool analog_output_needed) override {
+            trace_packet(_packet_index);
+            trace_scope scope(_trace_stage);
             auto output_buffer = buffers_[buffer_id];
             output_buffer->clear();
-            while (_packet_iterator != _event_stream.packets.end()) {
-                for (; _event_iterator != _packet_iterator->end(); ++_event_iterator) {
-                    if (_event_iterator->t >= t) {
+            while (_packet_index < number_of_packets()) {
+                if (_packet_stream) {
+                    if (!push_streamed_events(t, output_buffer)) {
+                        break;
+                    }
+                } else {
+                    const auto packet_end = _event_stream.packets_offsets[_packet_index + 1];
+                    for (; _event_index < packet_end; ++_event_index) {
+                        if (_event_stream.ts[_event_index] >= t) {
+                            break;
+                        }
+                        Event2d event(
+                            _event_stream.xs[_event_index],
+                            _event_stream.ys[_event_index],
+                            _event_stream.is_increases[_event_index] == 1,
+                            _event_stream.ts[_event_index]);
+                        output_buffer->push_back(&event);
+                    }
+                    if (_event_index != packet_end) {
                         break;
                     }
-                    Event2d event(_event_iterator->x, _event_iterator->y, _event_iterator->is_increase, _event_iterator->t);
-                    output_buffer->push_back(&event);
-                }
-                if (_event_iterator != _packet_iterator->end()) {
-                    break;
                 }
-                ++_packet_iterator;
-                if (_packet_iterator == _event_stream.packets.end()) {
+                ++_packet_index;
+                if (_packet_index == number_of_packets()) {
                     _is_done = true;
                     break;
                 }
-                _event_iterator = _packet_iterator->begin();
             }
         }
         bool is_done() override {
             return _is_done;
         }
 
+        /// number_of_packets returns the number of packets loaded.
+        std::size_t number_of_packets() const {
+            return _packet_stream ? _packet_stream->number_of_packets() : _event_stream.number_of_packets();
+        }
+
         /// number_of_events returns the number of events loaded.
         std::size_t number_of_events() const {
-            return _event_stream.number_of_events;
+            return _packet_stream ? _packet_stream->number_of_events() : _event_stream.number_of_events;
+        }
+
+        /// stalls_to_json writes the packet stream's stall statistics, followed by a new line, if the reader streams.
+        void stalls_to_json(std::ostream& output) const {
+            if (_packet_stream) {
+                benchmark::stalls_to_json(output, *_packet_stream);
+                output << std::endl;
+            }
         }
 
         protected:
-        event_stream _event_stream;
+        /// push_streamed_events pushes the streamed packet's events which are older than t to the output buffer,
+        /// and returns true if the packet is complete.
+        template <typename OutputBuffer>
+        bool push_streamed_events(timestamp t, OutputBuffer output_buffer) {
+            if (_packet == nullptr) {
+                _packet = _packet_stream->next();
+                _event_index = 0;
+            }
+            for (; _event_index < _packet->size(); ++_event_index) {
+                const auto& dvs_event = (*_packet)[_event_index];
+                if (dvs_event.t >= t) {
+                    return false;
+                }
+                Event2d event(dvs_event.x, dvs_event.y, dvs_event.is_increase, dvs_event.t);
+                output_buffer->push_back(&event);
+            }
+            _packet = nullptr;
+            return true;
+        }
+
+        columnar_event_stream _event_stream;
+        std::unique_ptr<packet_stream> _packet_stream;
+        const std::vector<sepia::dvs_event>* _packet;
         bool _is_done;
-        std::vector<std::vector<sepia::dvs_event>>::iterator _packet_iterator;
-        std::vector<sepia::dvs_event>::iterator _event_iterator;
+        std::size_t _packet_index;
+        std::size_t _event_index;
+        const uint32_t _trace_stage;
     };
 
     /// reader_latencies wraps file reading in a kAER producer for the latencies benchmark.
     class reader_latencies : public Producer {
         public:
-        reader_latencies(const std::string& filename) :
-            _event_stream(filename_to_event_stream(filename)),
-            _is_done(false) {
-            _packet_iterator = _event_stream.packets.begin();
-            _event_iterator = _packet_iterator->begin();
-            _t_0 = _event_stream.packets_ts.front();
+        reader_latencies(const std::string& filename, double speed = 1.0, bool stream = false) :
+            _event_stream(stream ? columnar_event_stream{} : filename_to_columnar_event_stream(filename)),
+            _packet_stream(stream ? new packet_stream(filename) : nullptr),
+            _packet(nullptr),
+            _speed(speed),
+            _is_done(false),
+            _packet_index(0),
+            _event_index(0),
+            _trace_stage(trace_stage("reader")),
+            _time_0(0) {
+            _t_0 = packets_ts().front();
+            if (_packet_stream) {
+                _packet_stream->fill();
+            }
         }
         virtual ~reader_latencies() {}
         void update_output(timestamp t, int buffer_id, bool analog_output_needed) override {
-            if (_packet_iterator == _event_stream.packets.begin() && _event_iterator == _packet_iterator->begin()) {
-                _time_point_0 = std::chrono::high_resolution_clock::now();
+            trace_packet(_packet_index);
+            if (_packet_index == 0 && _event_index == 0) {
+                _time_0 = calibrated_clock().now();
             }
+            trace_scope scope(_trace_stage);
             auto output_buffer = buffers_[buffer_id];
             output_buffer->clear();
-            while (_packet_iterator != _event_stream.packets.end()) {
-                for (; _event_iterator != _packet_iterator->end(); ++_event_iterator) {
-                    if (_event_iterator->t >= t) {
+            while (_packet_index < number_of_packets()) {
+                if (_packet_stream) {
+                    if (!push_streamed_events(t, output_buffer)) {
+                        break;
+                    }
+                } else {
+                    const auto packet_end = _event_stream.packets_offsets[_packet_index + 1];
+                    for (; _event_index < packet_end; ++_event_index) {
+                        if (_event_stream.ts[_event_index] >= t) {
+                            break;
+                        }
+                        Event2d event(
+                            _event_stream.xs[_event_index],
+                            _event_stream.ys[_event_index],
+                            _event_stream.is_increases[_event_index] == 1,
+                            _event_stream.ts[_event_index]);
+                        output_buffer->push_back(&event);
+                    }
+                    if (_event_index != packet_end) {
                         break;
                     }
-                    Event2d event(_event_iterator->x, _event_iterator->y, _event_iterator->is_increase, _event_iterator->t);
-                    output_buffer->push_back(&event);
-                }
-                if (_event_iterator != _packet_iterator->end()) {
-                    break;
                 }
-                ++_packet_iterator;
-                busy_sleep_until(_time_point_0 + std::chrono::microseconds(
-                    _event_stream.packets_ts[std::distance(_event_stream.packets.begin(), _packet_iterator)] - _t_0));
-                if (_packet_iterator == _event_stream.packets.end()) {
+                ++_packet_index;
+                if (_packet_index == number_of_packets()) {
                     _is_done = true;
                     break;
                 }
-                _event_iterator = _packet_iterator->begin();
+                calibrated_clock().busy_sleep_until(
+                    _time_0
+                    + static_cast<uint64_t>(
+                        dispatch_offset(packets_ts()[_packet_index] - _t_0, _speed).count()));
             }
         }
         bool is_done() override {
             return _is_done;
         }
 
+        /// number_of_packets returns the number of packets loaded.
+        std::size_t number_of_packets() const {
+            return _packet_stream ? _packet_stream->number_of_packets() : _event_stream.number_of_packets();
+        }
+
         /// number_of_events returns the number of events loaded.
         std::size_t number_of_events() const {
-            return _event_stream.number_of_events;
+            return _packet_stream ? _packet_stream->number_of_events() : _event_stream.number_of_events;
         }
 
-        /// time_0 returns the wall clock time read when the first packet was dispatched.
+        /// time_0 returns the calibrated_clock time read when the first packet was dispatched.
         uint64_t time_0() const {
-            return time_point_to_uint64(_time_point_0);
+            return _time_0;
+        }
+
+        /// packets_ts returns each packet's last event timestamp.
+        const std::vector<uint64_t>& packets_ts() const {
+            return _packet_stream ? _packet_stream->packets_ts() : _event_stream.packets_ts;
+        }
+
+        /// speed returns the replay speed factor.
+        double speed() const {
+            return _speed;
+        }
+
+        /// stalls_to_json writes the packet stream's stall statistics, followed by a new line, if the reader streams.
+        void stalls_to_json(std::ostream& output) const {
+            if (_packet_stream) {
+                benchmark::stalls_to_json(output, *_packet_stream);
+                output << std::endl;
+            }
         }
 
         protected:
-        event_stream _event_stream;
+        /// push_streamed_events pushes the streamed packet's events which are older than t to the output buffer,
+        /// and returns true if the packet is complete.
+        template <typename OutputBuffer>
+        bool push_streamed_events(timestamp t, OutputBuffer output_buffer) {
+            if (_packet == nullptr) {
+                _packet = _packet_stream->next();
+                _event_index = 0;
+            }
+            for (; _event_index < _packet->size(); ++_event_index) {
+                const auto& dvs_event = (*_packet)[_event_index];
+                if (dvs_event.t >= t) {
+                    return false;
+                }
+                Event2d event(dvs_event.x, dvs_event.y, dvs_event.is_increase, dvs_event.t);
+                output_buffer->push_back(&event);
+            }
+            _packet = nullptr;
+            return true;
+        }
+
+        columnar_event_stream _event_stream;
+        std::unique_ptr<packet_stream> _packet_stream;
+        const std::vector<sepia::dvs_event>* _packet;
+        double _speed;
         bool _is_done;
-        std::vector<std::vector<sepia::dvs_event>>::iterator _packet_iterator;
-        std::vector<sepia::dvs_event>::iterator _event_iterator;
+        std::size_t _packet_index;
+        std::size_t _event_index;
+        const uint32_t _trace_stage;
         uint64_t _t_0;
-        std::chrono::high_resolution_clock::time_point _time_point_0;
+        uint64_t _time_0;
     };
 
     /// sink wraps output checks in a kAER producer.
@@ -128,26 +278,29 @@ namespace benchmark {
         public:
         sink(Producer* source, std::size_t number_of_events, KaerEventToEvent kaer_event_to_event) :
             _source(source),
-            _kaer_event_to_event(std::forward<KaerEventToEvent>(kaer_event_to_event)) {
-            _events.reserve(number_of_events);
+            _kaer_event_to_event(std::forward<KaerEventToEvent>(kaer_event_to_event)),
+            _trace_stage(trace_stage("sink")) {
+            _output_sink.reserve(number_of_events);
         }
         virtual ~sink() {}
         void update(timestamp t) {
+            trace_scope scope(_trace_stage);
             auto buffer = get_input(_source->get_id(), t);
             for (unsigned int index = 0; index < buffer->size(); ++index) {
-                _events.push_back(_kaer_event_to_event(*buffer->template get_unsafe<KaerEvent>(index)));
+                _output_sink(_kaer_event_to_event(*buffer->template get_unsafe<KaerEvent>(index)));
             }
         }
 
-        /// events returns the output events.
-        const std::vector<Event>& events() const {
-            return _events;
+        /// to_json writes the duration, the number of output events, their hashes and the performance counters.
+        void to_json(std::ostream& output, uint64_t t, const perf_counters& counters) const {
+            _output_sink.to_json(output, t, counters);
         }
 
         protected:
         Producer* _source;
-        std::vector<Event> _events;
+        output_sink<Event> _output_sink;
         KaerEventToEvent _kaer_event_to_event;
+        const uint32_t _trace_stage;
     };
     template <typename KaerEvent, typename Event, typename KaerEventToEvent>
     sink<KaerEvent, Event, KaerEventToEvent>* make_sink(Producer* source, std::size_t number_of_events, KaerEventToEvent kaer_event_to_event) {
@@ -158,46 +311,44 @@ namespace benchmark {
     template <typename KaerEvent, typename Event, typename KaerEventToEvent>
     class sink_latencies : public Consumer {
         public:
-        sink_latencies(Producer* source, std::size_t number_of_events, KaerEventToEvent kaer_event_to_event) :
+        sink_latencies(Producer* source, const reader_latencies* reader, KaerEventToEvent kaer_event_to_event) :
             _source(source),
-            _kaer_event_to_event(std::forward<KaerEventToEvent>(kaer_event_to_event)) {
-            _events.reserve(number_of_events);
-            _points.reserve(number_of_events);
+            _reader(reader),
+            _kaer_event_to_event(std::forward<KaerEventToEvent>(kaer_event_to_event)),
+            _trace_stage(trace_stage("sink")) {
+            _latency_sink.reserve(reader->number_of_events());
         }
         virtual ~sink_latencies() {}
         void update(timestamp t) {
+            trace_scope scope(_trace_stage);
             auto buffer = get_input(_source->get_id(), t);
+            if (buffer->size() > 0 && !_latency_sink.started()) {
+                _latency_sink.start(_reader->packets_ts(), _reader->time_0(), _reader->speed());
+            }
             for (unsigned int index = 0; index < buffer->size(); ++index) {
-                const auto event = *buffer->template get_unsafe<KaerEvent>(index);
-                _events.push_back(_kaer_event_to_event(event));
-                _points.emplace_back(static_cast<uint64_t>(event.t), now());
+                _latency_sink(_kaer_event_to_event(*buffer->template get_unsafe<KaerEvent>(index)));
             }
         }
 
-        /// events returns the output events.
-        const std::vector<Event>& events() const {
-            return _events;
+        /// to_json writes the number of output events, their hashes, the latencies percentiles and the sampled points.
+        void to_json(std::ostream& output) const {
+            _latency_sink.to_json(output);
         }
 
-        /// points returns the measured wall clock times.
-        /// time_0 (wall clock time in nanoseconds) is used to normalize wall clock times.
-        std::vector<std::pair<uint64_t, uint64_t>> points(uint64_t time_0) const {
-            std::vector<std::pair<uint64_t, uint64_t>> result(_points.size());
-            std::transform(_points.begin(), _points.end(), result.begin(), [&](std::pair<uint64_t, uint64_t> point) {
-                point.second -= time_0;
-                return point;
-            });
-            return result;
+        /// write_points writes the sampled points to the points file, if BENCHMARK_POINTS_FILENAME is set.
+        void write_points() const {
+            _latency_sink.write_points();
         }
 
         protected:
         Producer* _source;
-        std::vector<Event> _events;
+        const reader_latencies* _reader;
         KaerEventToEvent _kaer_event_to_event;
-        std::vector<std::pair<uint64_t, uint64_t>> _points;
+        latency_sink<Event> _latency_sink;
+        const uint32_t _trace_stage;
     };
     template <typename KaerEvent, typename Event, typename KaerEventToEvent>
-    sink_latencies<KaerEvent, Event, KaerEventToEvent>* make_sink_latencies(Producer* source, std::size_t number_of_events, KaerEventToEvent kaer_event_to_event) {
-        return new sink_latencies<KaerEvent, Event, KaerEventToEvent>(source, number_of_events, std::forward<KaerEventToEvent>(kaer_event_to_event));
+    sink_latencies<KaerEvent, Event, KaerEventToEvent>* make_sink_latencies(Producer* source, const reader_latencies* reader, KaerEventToEvent kaer_event_to_event) {
+        return new sink_latencies<KaerEvent, Event, KaerEventToEvent>(source, reader, std::forward<KaerEventToEvent>(kaer_event_to_event));
     }
 }
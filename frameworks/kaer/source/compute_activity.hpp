@@ -2,6 +2,7 @@
 
 #include "combined_filter.h" // requires kAER
 #include "timestamp.h" // requires kAER
+#include "benchmark.hpp"
 
 class compute_activity : public CombinedFilter {
     public:
@@ -9,12 +10,14 @@ class compute_activity : public CombinedFilter {
             _source(source),
             _width(width),
             _decay(decay),
-            _potentials_and_ts(width * height, {0.0f, 0}) {}
+            _potentials_and_ts(width * height, {0.0f, 0}),
+            _trace_stage(benchmark::trace_stage("compute_activity")) {}
         virtual ~compute_activity() {}
         void update(timestamp t) override {
             _input_buffer = get_input(_source->get_id(), t);
         }
         void update_output(timestamp t, int buffer_id, bool analog_output_needed) override {
+            benchmark::trace_scope scope(_trace_stage);
             auto output_buffer = buffers_[buffer_id];
             output_buffer->clear();
             for (unsigned int buffer_index = 0; buffer_index < _input_buffer->size(); ++buffer_index) {
@@ -44,4 +47,5 @@ class compute_activity : public CombinedFilter {
         const uint16_t _width;
         const float _decay;
         std::vector<std::pair<float, uint64_t>> _potentials_and_ts;
+        const uint32_t _trace_stage;
 };
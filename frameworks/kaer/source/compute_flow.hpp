@@ -2,6 +2,7 @@
 
 #include "combined_filter.h" // requires kAER
 #include "timestamp.h" // requires kAER
+#include "benchmark.hpp"
 
 class compute_flow : public CombinedFilter {
     public:
@@ -18,12 +19,14 @@ class compute_flow : public CombinedFilter {
             _spatial_window(spatial_window),
             _temporal_window(temporal_window),
             _minimum_number_of_events(minimum_number_of_events),
-            _ts(width * height, 0) {}
+            _ts(width * height, 0),
+            _trace_stage(benchmark::trace_stage("compute_flow")) {}
         virtual ~compute_flow() {}
         void update(timestamp t) override {
             _input_buffer = get_input(_source->get_id(), t);
         }
         void update_output(timestamp t, int buffer_id, bool analog_output_needed) override {
+            benchmark::trace_scope scope(_trace_stage);
             auto output_buffer = buffers_[buffer_id];
             output_buffer->clear();
             for (unsigned int buffer_index = 0; buffer_index < _input_buffer->size(); ++buffer_index) {
@@ -110,4 +113,5 @@ class compute_flow : public CombinedFilter {
         const uint64_t _temporal_window;
         const std::size_t _minimum_number_of_events;
         std::vector<timestamp> _ts;
+        const uint32_t _trace_stage;
 };
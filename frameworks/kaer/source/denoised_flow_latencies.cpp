@@ -6,19 +6,21 @@
 #include "mask_isolated.hpp"
 
 int main(int argc, char* argv[]) {
-    benchmark::check(argc);
+    const auto stream = benchmark::stream(argc, argv);
+    benchmark::check_latencies(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
     auto controller = new Controller(false);
-    auto pipeline_reader_latencies = new benchmark::reader_latencies(argv[1]);
+    auto pipeline_reader_latencies = new benchmark::reader_latencies(argv[1], benchmark::speed(argc, argv, 2), stream);
     controller->add_component(pipeline_reader_latencies);
     auto pipeline_split = new split(pipeline_reader_latencies);
     controller->add_component(pipeline_split);
-    auto pipeline_mask_isolated = new mask_isolated(pipeline_split, 304, 240, 1e3);
+    auto pipeline_mask_isolated = new mask_isolated(pipeline_split, sensor.width, sensor.height, 1e3);
     controller->add_component(pipeline_mask_isolated);
-    auto pipeline_compute_flow = new compute_flow(pipeline_mask_isolated, 304, 240, 3, 1e4, 8);
+    auto pipeline_compute_flow = new compute_flow(pipeline_mask_isolated, sensor.width, sensor.height, 3, 1e4, 8);
     controller->add_component(pipeline_compute_flow);
     auto pipeline_sink_latencies = benchmark::make_sink_latencies<Event2dVec, benchmark::flow>(
         pipeline_compute_flow,
-        pipeline_reader_latencies->number_of_events(),
+        pipeline_reader_latencies,
         [](Event2dVec event) -> benchmark::flow {
             return {static_cast<uint64_t>(event.t), event.vx_, event.vy_, event.x, event.y};
         });
@@ -29,9 +31,8 @@ int main(int argc, char* argv[]) {
             break;
         }
     }
-    benchmark::flows_latencies_to_json(
-        std::cout,
-        pipeline_sink_latencies->events(),
-        pipeline_sink_latencies->points(pipeline_reader_latencies->time_0()));
+    pipeline_sink_latencies->to_json(std::cout);
+    pipeline_sink_latencies->write_points();
+    pipeline_reader_latencies->stalls_to_json(std::cerr);
     return 0;
 }
@@ -5,13 +5,15 @@
 #include "compute_flow.hpp"
 
 int main(int argc, char* argv[]) {
+    const auto stream = benchmark::stream(argc, argv);
     benchmark::check(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
     auto controller = new Controller(false);
-    auto pipeline_reader = new benchmark::reader(argv[1]);
+    auto pipeline_reader = new benchmark::reader(argv[1], stream);
     controller->add_component(pipeline_reader);
     auto pipeline_split = new split(pipeline_reader);
     controller->add_component(pipeline_split);
-    auto pipeline_compute_flow = new compute_flow(pipeline_split, 304, 240, 3, 1e4, 8);
+    auto pipeline_compute_flow = new compute_flow(pipeline_split, sensor.width, sensor.height, 3, 1e4, 8);
     controller->add_component(pipeline_compute_flow);
     auto pipeline_sink = benchmark::make_sink<Event2dVec, benchmark::flow>(
         pipeline_compute_flow,
@@ -20,6 +22,8 @@ int main(int argc, char* argv[]) {
             return {static_cast<uint64_t>(event.t), event.vx_, event.vy_, event.x, event.y};
         });
     controller->add_component(pipeline_sink);
+    benchmark::perf_counters counters;
+    counters.start();
     const auto begin_t = benchmark::now();
     for (timestamp t = 0; ; t += 10000) {
         controller->run(10000, t, false);
@@ -28,6 +32,8 @@ int main(int argc, char* argv[]) {
         }
     }
     const auto end_t = benchmark::now();
-    benchmark::flows_to_json(std::cout, end_t - begin_t, pipeline_sink->events());
+    counters.stop();
+    pipeline_sink->to_json(std::cout, end_t - begin_t, counters);
+    pipeline_reader->stalls_to_json(std::cerr);
     return 0;
 }
@@ -4,11 +4,14 @@
 #include "select_rectangle.hpp"
 
 int main(int argc, char* argv[]) {
+    const auto stream = benchmark::stream(argc, argv);
     benchmark::check(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
     auto controller = new Controller(false);
-    auto pipeline_reader = new benchmark::reader(argv[1]);
+    auto pipeline_reader = new benchmark::reader(argv[1], stream);
     controller->add_component(pipeline_reader);
-    auto pipeline_select_rectangle = new select_rectangle(pipeline_reader, 102, 70, 100, 100);
+    auto pipeline_select_rectangle = new select_rectangle(
+        pipeline_reader, sensor.region.left, sensor.region.bottom, sensor.region.width, sensor.region.height);
     controller->add_component(pipeline_select_rectangle);
     auto pipeline_sink = benchmark::make_sink<Event2d, sepia::dvs_event>(
         pipeline_select_rectangle,
@@ -17,6 +20,8 @@ int main(int argc, char* argv[]) {
             return sepia::dvs_event{static_cast<uint64_t>(event.t), event.x, event.y, event.p == 1};
         });
     controller->add_component(pipeline_sink);
+    benchmark::perf_counters counters;
+    counters.start();
     const auto begin_t = benchmark::now();
     for (timestamp t = 0; ; t += 10000) {
         controller->run(10000, t, false);
@@ -25,6 +30,8 @@ int main(int argc, char* argv[]) {
         }
     }
     const auto end_t = benchmark::now();
-    benchmark::events_to_json(std::cout, end_t - begin_t, pipeline_sink->events());
+    counters.stop();
+    pipeline_sink->to_json(std::cout, end_t - begin_t, counters);
+    pipeline_reader->stalls_to_json(std::cerr);
     return 0;
 }
@@ -2,6 +2,7 @@
 
 #include "combined_filter.h" // requires kAER
 #include "timestamp.h" // requires kAER
+#include "benchmark.hpp"
 
 class mask_isolated : public CombinedFilter {
     public:
@@ -14,12 +15,14 @@ class mask_isolated : public CombinedFilter {
             _width(width),
             _height(height),
             _temporal_window(temporal_window),
-            _ts(width * height, 0) {}
+            _ts(width * height, 0),
+            _trace_stage(benchmark::trace_stage("mask_isolated")) {}
         virtual ~mask_isolated() {}
         void update(timestamp t) override {
             _input_buffer = get_input(_source->get_id(), t);
         }
         void update_output(timestamp t, int buffer_id, bool analog_output_needed) override {
+            benchmark::trace_scope scope(_trace_stage);
             auto output_buffer = buffers_[buffer_id];
             output_buffer->clear();
             for (unsigned int buffer_index = 0; buffer_index < _input_buffer->size(); ++buffer_index) {
@@ -41,4 +44,5 @@ class mask_isolated : public CombinedFilter {
         const uint16_t _height;
         const uint64_t _temporal_window;
         std::vector<timestamp> _ts;
+        const uint32_t _trace_stage;
 };
@@ -4,15 +4,18 @@
 #include "select_rectangle.hpp"
 
 int main(int argc, char* argv[]) {
-    benchmark::check(argc);
+    const auto stream = benchmark::stream(argc, argv);
+    benchmark::check_latencies(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
     auto controller = new Controller(false);
-    auto pipeline_reader_latencies = new benchmark::reader_latencies(argv[1]);
+    auto pipeline_reader_latencies = new benchmark::reader_latencies(argv[1], benchmark::speed(argc, argv, 2), stream);
     controller->add_component(pipeline_reader_latencies);
-    auto pipeline_select_rectangle = new select_rectangle(pipeline_reader_latencies, 102, 70, 100, 100);
+    auto pipeline_select_rectangle = new select_rectangle(
+        pipeline_reader_latencies, sensor.region.left, sensor.region.bottom, sensor.region.width, sensor.region.height);
     controller->add_component(pipeline_select_rectangle);
     auto pipeline_sink_latencies = benchmark::make_sink_latencies<Event2d, sepia::dvs_event>(
         pipeline_select_rectangle,
-        pipeline_reader_latencies->number_of_events(),
+        pipeline_reader_latencies,
         [](Event2d event) {
             return sepia::dvs_event{static_cast<uint64_t>(event.t), event.x, event.y, event.p == 1};
         });
@@ -23,10 +26,8 @@ int main(int argc, char* argv[]) {
             break;
         }
     }
-    const auto& events = pipeline_sink_latencies->events();
-    benchmark::events_latencies_to_json(
-        std::cout,
-        pipeline_sink_latencies->events(),
-        pipeline_sink_latencies->points(pipeline_reader_latencies->time_0()));
+    pipeline_sink_latencies->to_json(std::cout);
+    pipeline_sink_latencies->write_points();
+    pipeline_reader_latencies->stalls_to_json(std::cerr);
     return 0;
 }
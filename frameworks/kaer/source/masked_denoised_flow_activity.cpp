@@ -8,19 +8,22 @@
 #include "compute_activity.hpp"
 
 int main(int argc, char* argv[]) {
+    const auto stream = benchmark::stream(argc, argv);
     benchmark::check(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
     auto controller = new Controller(false);
-    auto pipeline_reader = new benchmark::reader(argv[1]);
+    auto pipeline_reader = new benchmark::reader(argv[1], stream);
     controller->add_component(pipeline_reader);
     auto pipeline_split = new split(pipeline_reader);
     controller->add_component(pipeline_split);
-    auto pipeline_select_rectangle = new select_rectangle(pipeline_split, 102, 70, 100, 100);
+    auto pipeline_select_rectangle = new select_rectangle(
+        pipeline_split, sensor.region.left, sensor.region.bottom, sensor.region.width, sensor.region.height);
     controller->add_component(pipeline_select_rectangle);
-    auto pipeline_mask_isolated = new mask_isolated(pipeline_select_rectangle, 304, 240, 1e3);
+    auto pipeline_mask_isolated = new mask_isolated(pipeline_select_rectangle, sensor.width, sensor.height, 1e3);
     controller->add_component(pipeline_mask_isolated);
-    auto pipeline_compute_flow = new compute_flow(pipeline_mask_isolated, 304, 240, 3, 1e4, 8);
+    auto pipeline_compute_flow = new compute_flow(pipeline_mask_isolated, sensor.width, sensor.height, 3, 1e4, 8);
     controller->add_component(pipeline_compute_flow);
-    auto pipeline_compute_activity = new compute_activity(pipeline_compute_flow, 304, 240, 1e5);
+    auto pipeline_compute_activity = new compute_activity(pipeline_compute_flow, sensor.width, sensor.height, 1e5);
     controller->add_component(pipeline_compute_activity);
     auto pipeline_sink = benchmark::make_sink<Event2dVec, benchmark::activity>(
         pipeline_compute_activity,
@@ -29,6 +32,8 @@ int main(int argc, char* argv[]) {
             return {static_cast<uint64_t>(event.t), event.vx_, event.x, event.y};
         });
     controller->add_component(pipeline_sink);
+    benchmark::perf_counters counters;
+    counters.start();
     const auto begin_t = benchmark::now();
     for (timestamp t = 0; ; t += 10000) {
         controller->run(10000, t, false);
@@ -37,6 +42,8 @@ int main(int argc, char* argv[]) {
         }
     }
     const auto end_t = benchmark::now();
-    benchmark::activities_to_json(std::cout, end_t - begin_t, pipeline_sink->events());
+    counters.stop();
+    pipeline_sink->to_json(std::cout, end_t - begin_t, counters);
+    pipeline_reader->stalls_to_json(std::cerr);
     return 0;
 }
@@ -2,6 +2,7 @@
 
 #include "combined_filter.h" // requires kAER
 #include "timestamp.h" // requires kAER
+#include "benchmark.hpp"
 
 class select_rectangle : public CombinedFilter {
     public:
@@ -10,12 +11,14 @@ class select_rectangle : public CombinedFilter {
             _left(left),
             _bottom(bottom),
             _right(left + width),
-            _top(bottom + height) {}
+            _top(bottom + height),
+            _trace_stage(benchmark::trace_stage("select_rectangle")) {}
         virtual ~select_rectangle() {}
         void update(timestamp t) override {
             _input_buffer = get_input(_source->get_id(), t);
         }
         void update_output(timestamp t, int buffer_id, bool analog_output_needed) override {
+            benchmark::trace_scope scope(_trace_stage);
             auto output_buffer = buffers_[buffer_id];
             output_buffer->clear();
             for (unsigned int buffer_index = 0; buffer_index < _input_buffer->size(); ++buffer_index) {
@@ -33,4 +36,5 @@ class select_rectangle : public CombinedFilter {
         const uint16_t _bottom;
         const uint16_t _right;
         const uint16_t _top;
+        const uint32_t _trace_stage;
 };
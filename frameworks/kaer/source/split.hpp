@@ -2,15 +2,17 @@
 
 #include "combined_filter.h" // requires kAER
 #include "timestamp.h" // requires kAER
+#include "benchmark.hpp"
 
 class split : public CombinedFilter {
     public:
-        split(Producer* source) : _source(source) {}
+        split(Producer* source) : _source(source), _trace_stage(benchmark::trace_stage("split")) {}
         virtual ~split() {}
         void update(timestamp t) override {
             _input_buffer = get_input(_source->get_id(), t);
         }
         void update_output(timestamp t, int buffer_id, bool analog_output_needed) override {
+            benchmark::trace_scope scope(_trace_stage);
             auto output_buffer = buffers_[buffer_id];
             output_buffer->clear();
             for (unsigned int buffer_index = 0; buffer_index < _input_buffer->size(); ++buffer_index) {
@@ -24,4 +26,5 @@ class split : public CombinedFilter {
      protected:
         Producer* _source;
         EventBuffer* _input_buffer;
+        const uint32_t _trace_stage;
 };
@@ -36,3 +36,16 @@ solution 'benchmark'
     benchmark_project 'masked_denoised_flow_latencies'
     benchmark_project 'masked_denoised_flow_activity'
     benchmark_project 'masked_denoised_flow_activity_latencies'
+    benchmark_project 'static_mask'
+    benchmark_project 'static_mask_latencies'
+    benchmark_project 'static_flow'
+    benchmark_project 'static_flow_latencies'
+    benchmark_project 'static_denoised_flow'
+    benchmark_project 'static_denoised_flow_latencies'
+    benchmark_project 'static_masked_denoised_flow'
+    benchmark_project 'static_masked_denoised_flow_latencies'
+    benchmark_project 'static_masked_denoised_flow_activity'
+    benchmark_project 'static_masked_denoised_flow_activity_latencies'
+    benchmark_project 'layouts'
+    benchmark_project 'decays'
+    benchmark_project 'partitions'
@@ -13,6 +13,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
+                counters: result[6],
             }),
         },
         latencies: {
@@ -25,7 +26,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[3],
                     y_hash: result[4],
                 },
-                points: result[5].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[5],
+                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -42,6 +44,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[5],
                     y_hash: result[6],
                 },
+                counters: result[7],
             }),
         },
         latencies: {
@@ -55,7 +58,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
-                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[6],
+                points: result[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -72,6 +76,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[5],
                     y_hash: result[6],
                 },
+                counters: result[7],
             }),
         },
         latencies: {
@@ -85,7 +90,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
-                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[6],
+                points: result[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -102,6 +108,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[5],
                     y_hash: result[6],
                 },
+                counters: result[7],
             }),
         },
         latencies: {
@@ -115,7 +122,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
-                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[6],
+                points: result[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -131,6 +139,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
+                counters: result[6],
             }),
         },
         latencies: {
@@ -143,14 +152,15 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[3],
                     y_hash: result[4],
                 },
-                points: result[5].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[5],
+                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
 };
 
-if (process.argv.length != 5) {
-    console.error('3 arguments are expected (a pipeline name, an experiment name and an Event Stream filename)');
+if (process.argv.length != 5 && process.argv.length != 6) {
+    console.error('3 or 4 arguments are expected (a pipeline name, an experiment name, an Event Stream filename and an optional speed factor)');
     process.exit(1);
 }
 const experiment_to_parameters = pipeline_to_experiment_to_parameters[process.argv[2]];
@@ -163,6 +173,11 @@ if (parameters == null) {
     console.error(`unknown experiment ${process.argv[3]}`);
     process.exit(1);
 }
+const speed = process.argv.length > 5 ? process.argv[5] : null;
+if (speed != null && process.argv[3] !== 'latencies') {
+    console.error('the speed factor is only supported by the latencies experiment');
+    process.exit(1);
+}
 process.stdout.write(parameters.result_to_json(JSON.parse(child_process.execSync(
-    `${__dirname}/build/release/${parameters.name} ${process.argv[4]}`,
+    `${__dirname}/build/release/${parameters.name}${speed == null ? '' : ` --speed ${speed}`} ${process.argv[4]}`,
     {maxBuffer: 2 ** 30}))) + '\n');
@@ -4,65 +4,205 @@
 #include "../../../common/third_party/pontella/source/pontella.hpp"
 
 namespace benchmark {
+    /// handle_packet sends a packet to a handler with a batch operator (for instance tarsier::pipeline).
+    template <typename HandleEvent, typename Iterator>
+    auto handle_packet(HandleEvent& handle_event, Iterator begin, Iterator end, int)
+        -> decltype(handle_event(begin, end), void()) {
+        handle_event(begin, end);
+    }
+
+    /// handle_packet sends the events of a packet one by one to a handler.
+    template <typename HandleEvent, typename Iterator>
+    void handle_packet(HandleEvent& handle_event, Iterator begin, Iterator end, long) {
+        for (; begin != end; ++begin) {
+            handle_event(*begin);
+        }
+    }
+
+    /// handle_packet sends a packet to a handler, using its batch operator if it has one.
+    template <typename HandleEvent, typename Iterator>
+    void handle_packet(HandleEvent& handle_event, Iterator begin, Iterator end) {
+        handle_packet(handle_event, begin, end, 0);
+    }
+
+    /// increase_stage is a tarsier::pipeline stage equivalent to sepia::split, with an empty decrease handler.
+    class increase_stage final {
+        public:
+        increase_stage() {}
+        increase_stage(const increase_stage&) = delete;
+        increase_stage(increase_stage&&) = default;
+        increase_stage& operator=(const increase_stage&) = delete;
+        increase_stage& operator=(increase_stage&&) = default;
+        ~increase_stage() {}
+
+        /// operator() handles an event, and sends it to handle_event as a simple event if it is an increase.
+        template <typename HandleEvent>
+        void operator()(sepia::dvs_event event, HandleEvent& handle_event) {
+            if (event.is_increase) {
+                handle_event(sepia::simple_event{event.t, event.x, event.y});
+            }
+        }
+    };
+
     /// duration wraps a pipeline for a duration benchmark.
-    template <typename HandleCount, typename HandleEvent, typename HandleTs>
-    int duration(int argc, char* argv[], HandleCount handle_count, HandleEvent handle_event, HandleTs handle_ts) {
+    /// tarsier fuses the pipeline's stages in a single function call per event, hence each packet is traced as a
+    /// single "pipeline" stage (see tracer).
+    /// make_handle_event is called with the input's sensor (see filename_to_sensor) and returns the pipeline.
+    /// handle_ts is called with the wall clock times bracketing the run, and the performance counters measured
+    /// between them.
+    template <typename HandleCount, typename MakeHandleEvent, typename HandleTs>
+    int duration(
+        int argc,
+        char* argv[],
+        HandleCount handle_count,
+        MakeHandleEvent make_handle_event,
+        HandleTs handle_ts) {
         return pontella::main(
             {
                 "duration measures the duration of an algorithm for the given Event Stream file",
-                "Syntax: ./duration /path/to/input.es"
+                "hardware performance counters are measured as well, unless the environment variable",
+                "BENCHMARK_PERF_COUNTERS is 0 (unavailable counters are written as null)",
+                "each packet is traced if the environment variable BENCHMARK_TRACE is set to an output filename",
+                "the sensor dimensions are read from the file's header, and the region of interest is scaled",
+                "proportionally (102, 70, 100, 100 on a 304 x 240 sensor)",
+                "Syntax: ./duration [options] /path/to/input.es",
+                "Available options:",
+                "    -s, --stream    decodes the file on a producer thread during the benchmark",
+                "                        instead of loading it beforehand",
+                "                        stall statistics are written to the standard error",
+                "    -h, --help      shows this help message",
             },
             argc,
             argv,
             1,
             {},
-            {}, [&](pontella::command command) {
-                const auto input_event_stream = filename_to_event_stream(command.arguments.front());
+            {{"stream", {"s"}}}, [&](pontella::command command) {
+                auto handle_event = make_handle_event(filename_to_sensor(command.arguments.front()));
+                if (command.flags.find("stream") != command.flags.end()) {
+                    packet_stream input_packet_stream(command.arguments.front());
+                    handle_count(input_packet_stream.number_of_events());
+                    const auto stage = trace_stage("pipeline");
+                    perf_counters counters;
+                    input_packet_stream.fill();
+                    counters.start();
+                    const auto begin_t = now();
+                    for (std::size_t index = 0;; ++index) {
+                        const auto packet = input_packet_stream.next();
+                        if (packet == nullptr) {
+                            break;
+                        }
+                        trace_scope scope(stage, index);
+                        handle_packet(handle_event, packet->data(), packet->data() + packet->size());
+                    }
+                    const auto end_t = now();
+                    counters.stop();
+                    handle_ts(begin_t, end_t, counters);
+                    stalls_to_json(std::cerr, input_packet_stream);
+                    std::cerr << std::endl;
+                    return;
+                }
+                const auto input_event_stream = filename_to_columnar_event_stream(command.arguments.front());
                 handle_count(input_event_stream.number_of_events);
+                const auto stage = trace_stage("pipeline");
+                perf_counters counters;
+                counters.start();
                 const auto begin_t = now();
-                for (const auto& packet : input_event_stream.packets) {
-                    for (const auto event : packet) {
-                        handle_event(event);
-                    }
+                for (std::size_t index = 0; index < input_event_stream.number_of_packets(); ++index) {
+                    const auto packet = input_event_stream.packet(index);
+                    trace_scope scope(stage, index);
+                    handle_packet(handle_event, packet.begin(), packet.end());
                 }
                 const auto end_t = now();
-                handle_ts(begin_t, end_t);
+                counters.stop();
+                handle_ts(begin_t, end_t, counters);
             });
     }
 
     /// latencies wraps a pipeline for a latencies benchmark.
-    template <typename HandleCount, typename HandleEvent, typename HandleTs>
-    int latencies(
-        int argc,
-        char* argv[],
-        HandleCount handle_count,
-        HandleEvent handle_event,
-        HandleTs handle_ts) {
+    /// make_handle_event is called with the input's sensor (see filename_to_sensor) and returns the pipeline.
+    /// The pipeline must send its output events to sink.
+    template <typename Sink, typename MakeHandleEvent>
+    int latencies(int argc, char* argv[], Sink& sink, MakeHandleEvent make_handle_event) {
         return pontella::main(
             {
                 "latencies measures the delay between data availability and algorithm output for the given Event Stream file",
-                "Syntax: ./latencies /path/to/input.es"
+                "the latencies percentiles are calculated in-process, raw points are written only if the environment",
+                "variable BENCHMARK_POINTS_PERIOD is set (one point is kept every BENCHMARK_POINTS_PERIOD events)",
+                "each packet is traced if the environment variable BENCHMARK_TRACE is set to an output filename",
+                "the sensor dimensions are read from the file's header, and the region of interest is scaled",
+                "proportionally (102, 70, 100, 100 on a 304 x 240 sensor)",
+                "Syntax: ./latencies [options] /path/to/input.es",
+                "Available options:",
+                "    -s, --stream                     decodes the file on a producer thread during the benchmark",
+                "                                         instead of loading it beforehand",
+                "                                         stall statistics are written to the standard error",
+                "    -x [factor], --speed [factor]    replays the packets factor times faster than real time",
+                "                                         defaults to 1",
+                "    -h, --help                       shows this help message",
             },
             argc,
             argv,
             1,
-            {},
-            {}, [&](pontella::command command) {
-                const auto input_event_stream = filename_to_event_stream(command.arguments.front());
-                handle_count(input_event_stream.number_of_events);
+            {{"speed", {"x"}}},
+            {{"stream", {"s"}}}, [&](pontella::command command) {
+                auto speed = 1.0;
+                {
+                    const auto name_and_argument = command.options.find("speed");
+                    if (name_and_argument != command.options.end()) {
+                        speed = speed_from_string(name_and_argument->second);
+                    }
+                }
+                auto handle_event = make_handle_event(filename_to_sensor(command.arguments.front()));
+                if (command.flags.find("stream") != command.flags.end()) {
+                    packet_stream input_packet_stream(command.arguments.front());
+                    sink.reserve(input_packet_stream.number_of_events());
+                    const auto stage = trace_stage("pipeline");
+                    input_packet_stream.fill();
+                    uint64_t t_0 = 0;
+                    uint64_t time_0 = 0;
+                    for (std::size_t index = 0;; ++index) {
+                        const auto packet = input_packet_stream.next();
+                        if (packet == nullptr) {
+                            break;
+                        }
+                        if (index == 0) {
+                            t_0 = packet->back().t;
+                            time_0 = calibrated_clock().now();
+                            sink.start(input_packet_stream.packets_ts(), time_0, speed);
+                        } else {
+                            calibrated_clock().busy_sleep_until(
+                                time_0 + static_cast<uint64_t>(dispatch_offset(packet->back().t - t_0, speed).count()));
+                        }
+                        trace_scope scope(stage, index);
+                        handle_packet(handle_event, packet->data(), packet->data() + packet->size());
+                    }
+                    sink.to_json(std::cout);
+                    sink.write_points();
+                    stalls_to_json(std::cerr, input_packet_stream);
+                    std::cerr << std::endl;
+                    return;
+                }
+                const auto input_event_stream = filename_to_columnar_event_stream(command.arguments.front());
+                sink.reserve(input_event_stream.number_of_events);
+                const auto stage = trace_stage("pipeline");
                 const auto t_0 = input_event_stream.packets_ts.front();
-                std::chrono::high_resolution_clock::time_point time_point_0;
-                for (std::size_t index = 0; index < input_event_stream.packets.size(); ++index) {
+                uint64_t time_0 = 0;
+                for (std::size_t index = 0; index < input_event_stream.number_of_packets(); ++index) {
                     if (index == 0) {
-                        time_point_0 = std::chrono::high_resolution_clock::now();
+                        time_0 = calibrated_clock().now();
+                        sink.start(input_event_stream.packets_ts, time_0, speed);
                     } else {
-                        busy_sleep_until(time_point_0 + std::chrono::microseconds(input_event_stream.packets_ts[index] - t_0));
-                    }
-                    for (const auto event : input_event_stream.packets[index]) {
-                        handle_event(event);
+                        calibrated_clock().busy_sleep_until(
+                            time_0
+                            + static_cast<uint64_t>(
+                                dispatch_offset(input_event_stream.packets_ts[index] - t_0, speed).count()));
                     }
+                    const auto packet = input_event_stream.packet(index);
+                    trace_scope scope(stage, index);
+                    handle_packet(handle_event, packet.begin(), packet.end());
                 }
-                handle_ts(time_point_to_uint64(time_point_0));
+                sink.to_json(std::cout);
+                sink.write_points();
             });
     }
 }
@@ -0,0 +1,90 @@
+#include "benchmark.hpp"
+#include "../third_party/tarsier/source/compute_activity.hpp"
+#include "../third_party/tarsier/source/compute_flow.hpp"
+#include "../third_party/tarsier/source/mask_isolated.hpp"
+#include "../third_party/tarsier/source/pipeline.hpp"
+#include "../third_party/tarsier/source/select_rectangle.hpp"
+
+/// decay_to_json runs the masked denoised flow activity pipeline with the given decay, and writes its duration, its
+/// error bound, and the largest difference between its potentials and the exact ones.
+template <typename Decay>
+void decay_to_json(
+    std::ostream& output,
+    const std::string& name,
+    const benchmark::sensor& sensor,
+    const benchmark::columnar_event_stream& input_event_stream,
+    Decay decay,
+    std::vector<float>& potentials) {
+    const auto error_bound = decay.error_bound();
+    const auto exact = potentials.empty();
+    std::size_t index = 0;
+    auto maximum_error = 0.0f;
+    auto pipeline = tarsier::make_pipeline<sepia::dvs_event>(
+        benchmark::increase_stage(),
+        tarsier::make_select_rectangle_stage<sepia::simple_event>(
+            sensor.region.left, sensor.region.bottom, sensor.region.width, sensor.region.height),
+        tarsier::make_mask_isolated_stage<sepia::simple_event>(sensor.width, sensor.height, 1e3),
+        tarsier::make_compute_flow_fixed_stage<sepia::simple_event, benchmark::flow, 3>(
+            sensor.width,
+            sensor.height,
+            1e4,
+            8,
+            [](sepia::simple_event event, float vx, float vy) -> benchmark::flow {
+                return {event.t, vx, vy, event.x, event.y};
+            }),
+        tarsier::make_compute_activity_stage<benchmark::flow, benchmark::activity, Decay>(
+            sensor.width,
+            sensor.height,
+            std::move(decay),
+            [](benchmark::flow flow, float potential) -> benchmark::activity {
+                return {flow.t, potential, flow.x, flow.y};
+            }),
+        [&](benchmark::activity activity) {
+            if (exact) {
+                potentials.push_back(activity.potential);
+            } else {
+                maximum_error = std::max(maximum_error, std::abs(activity.potential - potentials[index]));
+                ++index;
+            }
+        });
+    const auto begin_t = benchmark::now();
+    for (std::size_t packet_index = 0; packet_index < input_event_stream.number_of_packets(); ++packet_index) {
+        const auto packet = input_event_stream.packet(packet_index);
+        pipeline(packet.begin(), packet.end());
+    }
+    const auto end_t = benchmark::now();
+    output << "\"" << name << "\": {\"duration\": " << (end_t - begin_t) << ", \"error_bound\": " << error_bound
+           << ", \"maximum_potential_error\": " << maximum_error << "}";
+}
+
+int main(int argc, char* argv[]) {
+    return pontella::main(
+        {
+            "decays compares the decay policies on the masked denoised flow activity pipeline",
+            "Syntax: ./decays [options] /path/to/input.es",
+            "Available options:",
+            "    -h, --help    shows this help message",
+        },
+        argc,
+        argv,
+        1,
+        {},
+        {},
+        [&](pontella::command command) {
+            const auto sensor = benchmark::filename_to_sensor(command.arguments.front());
+            const auto input_event_stream = benchmark::filename_to_columnar_event_stream(command.arguments.front());
+            std::vector<float> potentials;
+            std::cout << "{";
+            decay_to_json(std::cout, "exact", sensor, input_event_stream, tarsier::exact_decay(1e5), potentials);
+            std::cout << ", ";
+            decay_to_json(
+                std::cout, "reciprocal", sensor, input_event_stream, tarsier::reciprocal_decay(1e5), potentials);
+            std::cout << ", ";
+            decay_to_json(std::cout, "table", sensor, input_event_stream, tarsier::table_decay(1e5, 1e-5f), potentials);
+            std::cout << ", ";
+            decay_to_json(
+                std::cout, "polynomial", sensor, input_event_stream, tarsier::polynomial_decay<>(1e5), potentials);
+            std::cout << "}";
+            std::cout.flush();
+        });
+}
@@ -0,0 +1,84 @@
+#include "benchmark.hpp"
+#include "../third_party/tarsier/source/compute_flow.hpp"
+#include "../third_party/tarsier/source/mask_isolated.hpp"
+#include "../third_party/tarsier/source/pipeline.hpp"
+
+/// layout_to_json runs the denoised flow pipeline with the given timestamp map, and writes its duration, its number
+/// of flows and its cache misses (null if hardware counters are unavailable).
+template <typename TsMap>
+void layout_to_json(
+    std::ostream& output,
+    const std::string& name,
+    const benchmark::sensor& sensor,
+    const benchmark::columnar_event_stream& input_event_stream) {
+    std::size_t flows = 0;
+    auto pipeline = tarsier::make_pipeline<sepia::dvs_event>(
+        benchmark::increase_stage(),
+        tarsier::make_mask_isolated_stage<sepia::simple_event, TsMap>(sensor.width, sensor.height, 1e3),
+        tarsier::make_compute_flow_fixed_stage<sepia::simple_event, benchmark::flow, 3, TsMap>(
+            sensor.width,
+            sensor.height,
+            1e4,
+            8,
+            [](sepia::simple_event event, float vx, float vy) -> benchmark::flow {
+                return {event.t, vx, vy, event.x, event.y};
+            }),
+        [&](benchmark::flow) {
+            ++flows;
+        });
+    benchmark::perf_counter l1d_misses(
+        PERF_TYPE_HW_CACHE,
+        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16));
+    benchmark::perf_counter cache_misses(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+    l1d_misses.start();
+    cache_misses.start();
+    const auto begin_t = benchmark::now();
+    for (std::size_t index = 0; index < input_event_stream.number_of_packets(); ++index) {
+        const auto packet = input_event_stream.packet(index);
+        pipeline(packet.begin(), packet.end());
+    }
+    const auto end_t = benchmark::now();
+    const auto l1d_misses_count = l1d_misses.stop();
+    const auto cache_misses_count = cache_misses.stop();
+    output << "\"" << name << "\": {\"duration\": " << (end_t - begin_t) << ", \"flows\": " << flows
+           << ", \"l1d_misses\": ";
+    if (l1d_misses.available()) {
+        output << l1d_misses_count;
+    } else {
+        output << "null";
+    }
+    output << ", \"cache_misses\": ";
+    if (cache_misses.available()) {
+        output << cache_misses_count;
+    } else {
+        output << "null";
+    }
+    output << "}";
+}
+
+int main(int argc, char* argv[]) {
+    return pontella::main(
+        {
+            "layouts compares the timestamp maps layouts on the denoised flow pipeline",
+            "Syntax: ./layouts [options] /path/to/input.es",
+            "Available options:",
+            "    -h, --help    shows this help message",
+        },
+        argc,
+        argv,
+        1,
+        {},
+        {},
+        [&](pontella::command command) {
+            const auto sensor = benchmark::filename_to_sensor(command.arguments.front());
+            const auto input_event_stream = benchmark::filename_to_columnar_event_stream(command.arguments.front());
+            std::cout << "{";
+            layout_to_json<tarsier::ts_map<uint64_t>>(std::cout, "flat", sensor, input_event_stream);
+            std::cout << ", ";
+            layout_to_json<tarsier::ts_map<uint64_t, 8, 8>>(std::cout, "tiled", sensor, input_event_stream);
+            std::cout << ", ";
+            layout_to_json<tarsier::ts_map<uint32_t, 8, 8>>(std::cout, "relative", sensor, input_event_stream);
+            std::cout << "}";
+            std::cout.flush();
+        });
+}
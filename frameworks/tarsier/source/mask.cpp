@@ -3,22 +3,24 @@
 #include "../third_party/tarsier/source/select_rectangle.hpp"
 
 int main(int argc, char* argv[]) {
-    std::vector<sepia::dvs_event> events;
+    benchmark::output_sink<sepia::dvs_event> sink;
     return benchmark::duration(
         argc,
         argv,
         [&](std::size_t count) {
-            events.reserve(count);
+            sink.reserve(count);
         },
-        tarsier::make_select_rectangle<sepia::dvs_event>(
-            102,
-            70,
-            100,
-            100,
-            [&](sepia::dvs_event event) {
-                events.push_back(event);
-            }),
-        [&](uint64_t begin_t, uint64_t end_t) {
-            benchmark::events_to_json(std::cout, end_t - begin_t, events);
+        [&](const benchmark::sensor& sensor) {
+            return tarsier::make_select_rectangle<sepia::dvs_event>(
+                sensor.region.left,
+                sensor.region.bottom,
+                sensor.region.width,
+                sensor.region.height,
+                [&](sepia::dvs_event event) {
+                    sink(event);
+                });
+        },
+        [&](uint64_t begin_t, uint64_t end_t, const benchmark::perf_counters& counters) {
+            sink.to_json(std::cout, end_t - begin_t, counters);
         });
 }
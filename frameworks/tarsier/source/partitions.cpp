@@ -0,0 +1,112 @@
+#include "benchmark.hpp"
+#include "../third_party/tarsier/source/compute_flow.hpp"
+#include "../third_party/tarsier/source/mask_isolated.hpp"
+#include "../third_party/tarsier/source/partition.hpp"
+#include "../third_party/tarsier/source/pipeline.hpp"
+
+/// flow_from_event builds a flow event from compute_flow's output.
+struct flow_from_event {
+    benchmark::flow operator()(sepia::simple_event event, float vx, float vy) const {
+        return {event.t, vx, vy, event.x, event.y};
+    }
+};
+
+/// make_denoised_flow creates the static denoised flow pipeline for the given sensor, with the given flow handler.
+template <typename HandleFlow>
+auto make_denoised_flow(const benchmark::sensor& sensor, HandleFlow handle_flow)
+    -> decltype(tarsier::make_pipeline<sepia::dvs_event>(
+        benchmark::increase_stage(),
+        tarsier::make_mask_isolated_stage<sepia::simple_event>(sensor.width, sensor.height, 1e3),
+        tarsier::make_compute_flow_fixed_stage<sepia::simple_event, benchmark::flow, 3>(
+            sensor.width,
+            sensor.height,
+            1e4,
+            8,
+            flow_from_event()),
+        std::move(handle_flow))) {
+    return tarsier::make_pipeline<sepia::dvs_event>(
+        benchmark::increase_stage(),
+        tarsier::make_mask_isolated_stage<sepia::simple_event>(sensor.width, sensor.height, 1e3),
+        tarsier::make_compute_flow_fixed_stage<sepia::simple_event, benchmark::flow, 3>(
+            sensor.width,
+            sensor.height,
+            1e4,
+            8,
+            flow_from_event()),
+        std::move(handle_flow));
+}
+
+/// run_to_json sends the packets to the given handler, and writes its duration, its number of flows and their hashes.
+template <typename HandleEvent>
+void run_to_json(
+    std::ostream& output,
+    const benchmark::columnar_event_stream& input_event_stream,
+    HandleEvent& handle_event,
+    std::vector<benchmark::flow>& flows) {
+    const auto begin_t = benchmark::now();
+    for (std::size_t index = 0; index < input_event_stream.number_of_packets(); ++index) {
+        const auto packet = input_event_stream.packet(index);
+        benchmark::handle_packet(handle_event, packet.begin(), packet.end());
+    }
+    const auto end_t = benchmark::now();
+    benchmark::flows_to_json(output, end_t - begin_t, flows);
+}
+
+int main(int argc, char* argv[]) {
+    return pontella::main(
+        {
+            "partitions measures the denoised flow pipeline's scaling with tarsier::partition",
+            "Syntax: ./partitions [options] /path/to/input.es",
+            "Available options:",
+            "    -w [count], --workers [count]    sets the maximum number of worker threads",
+            "                                         defaults to the number of hardware threads",
+            "    -h, --help                       shows this help message",
+        },
+        argc,
+        argv,
+        1,
+        {{"workers", {"w"}}},
+        {},
+        [&](pontella::command command) {
+            std::size_t maximum_workers = std::thread::hardware_concurrency();
+            {
+                const auto name_and_argument = command.options.find("workers");
+                if (name_and_argument != command.options.end()) {
+                    maximum_workers = std::stoull(name_and_argument->second);
+                }
+            }
+            if (maximum_workers == 0) {
+                maximum_workers = 1;
+            }
+            const auto sensor = benchmark::filename_to_sensor(command.arguments.front());
+            const auto input_event_stream = benchmark::filename_to_columnar_event_stream(command.arguments.front());
+            std::vector<benchmark::flow> flows;
+            flows.reserve(input_event_stream.number_of_events);
+            std::cout << "{\"serial\": ";
+            {
+                auto pipeline = make_denoised_flow(sensor, [&](benchmark::flow flow) {
+                    flows.push_back(flow);
+                });
+                run_to_json(std::cout, input_event_stream, pipeline, flows);
+            }
+            for (std::size_t workers = 1; workers <= maximum_workers; ++workers) {
+                flows.clear();
+                std::cout << ", \"" << workers << "\": ";
+                // the halo covers mask_isolated's radius (1) and compute_flow's spatial window (3)
+                auto partition = tarsier::make_partition<sepia::dvs_event, benchmark::flow>(
+                    sensor.height,
+                    4,
+                    workers,
+                    1 << 14,
+                    [&](tarsier::partition_output<benchmark::flow> output) {
+                        return make_denoised_flow(sensor, output);
+                    },
+                    [&](benchmark::flow flow) {
+                        flows.push_back(flow);
+                    });
+                run_to_json(std::cout, input_event_stream, *partition, flows);
+            }
+            std::cout << "}";
+            std::cout.flush();
+        });
+}
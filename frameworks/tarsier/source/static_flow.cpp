@@ -0,0 +1,31 @@
+#include "benchmark.hpp"
+#include "../third_party/tarsier/source/compute_flow.hpp"
+#include "../third_party/tarsier/source/pipeline.hpp"
+
+int main(int argc, char* argv[]) {
+    benchmark::output_sink<benchmark::flow> sink;
+    return benchmark::duration(
+        argc,
+        argv,
+        [&](std::size_t count) {
+            sink.reserve(count);
+        },
+        [&](const benchmark::sensor& sensor) {
+            return tarsier::make_pipeline<sepia::dvs_event>(
+                benchmark::increase_stage(),
+                tarsier::make_compute_flow_fixed_stage<sepia::simple_event, benchmark::flow, 3>(
+                    sensor.width,
+                    sensor.height,
+                    1e4,
+                    8,
+                    [](sepia::simple_event event, float vx, float vy) -> benchmark::flow {
+                        return {event.t, vx, vy, event.x, event.y};
+                    }),
+                [&](benchmark::flow flow) {
+                    sink(flow);
+                });
+        },
+        [&](uint64_t begin_t, uint64_t end_t, const benchmark::perf_counters& counters) {
+            sink.to_json(std::cout, end_t - begin_t, counters);
+        });
+}
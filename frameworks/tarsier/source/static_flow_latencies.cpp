@@ -0,0 +1,26 @@
+#include "benchmark.hpp"
+#include "../third_party/tarsier/source/compute_flow.hpp"
+#include "../third_party/tarsier/source/pipeline.hpp"
+
+int main(int argc, char* argv[]) {
+    benchmark::latency_sink<benchmark::flow> sink;
+    return benchmark::latencies(
+        argc,
+        argv,
+        sink,
+        [&](const benchmark::sensor& sensor) {
+            return tarsier::make_pipeline<sepia::dvs_event>(
+                benchmark::increase_stage(),
+                tarsier::make_compute_flow_fixed_stage<sepia::simple_event, benchmark::flow, 3>(
+                    sensor.width,
+                    sensor.height,
+                    1e4,
+                    8,
+                    [](sepia::simple_event event, float vx, float vy) -> benchmark::flow {
+                        return {event.t, vx, vy, event.x, event.y};
+                    }),
+                [&](benchmark::flow flow) {
+                    sink(flow);
+                });
+        });
+}
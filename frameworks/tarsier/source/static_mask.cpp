@@ -0,0 +1,27 @@
+#include "benchmark.hpp"
+#include "../third_party/tarsier/source/pipeline.hpp"
+#include "../third_party/tarsier/source/select_rectangle.hpp"
+
+int main(int argc, char* argv[]) {
+    benchmark::output_sink<sepia::dvs_event> sink;
+    return benchmark::duration(
+        argc,
+        argv,
+        [&](std::size_t count) {
+            sink.reserve(count);
+        },
+        [&](const benchmark::sensor& sensor) {
+            return tarsier::make_pipeline<sepia::dvs_event>(
+                tarsier::make_select_rectangle_stage<sepia::dvs_event>(
+                    sensor.region.left,
+                    sensor.region.bottom,
+                    sensor.region.width,
+                    sensor.region.height),
+                [&](sepia::dvs_event event) {
+                    sink(event);
+                });
+        },
+        [&](uint64_t begin_t, uint64_t end_t, const benchmark::perf_counters& counters) {
+            sink.to_json(std::cout, end_t - begin_t, counters);
+        });
+}
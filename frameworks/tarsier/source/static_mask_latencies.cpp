@@ -0,0 +1,22 @@
+#include "benchmark.hpp"
+#include "../third_party/tarsier/source/pipeline.hpp"
+#include "../third_party/tarsier/source/select_rectangle.hpp"
+
+int main(int argc, char* argv[]) {
+    benchmark::latency_sink<sepia::dvs_event> sink;
+    return benchmark::latencies(
+        argc,
+        argv,
+        sink,
+        [&](const benchmark::sensor& sensor) {
+            return tarsier::make_pipeline<sepia::dvs_event>(
+                tarsier::make_select_rectangle_stage<sepia::dvs_event>(
+                    sensor.region.left,
+                    sensor.region.bottom,
+                    sensor.region.width,
+                    sensor.region.height),
+                [&](sepia::dvs_event event) {
+                    sink(event);
+                });
+        });
+}
@@ -0,0 +1,47 @@
+#include "benchmark.hpp"
+#include "../third_party/tarsier/source/compute_activity.hpp"
+#include "../third_party/tarsier/source/compute_flow.hpp"
+#include "../third_party/tarsier/source/mask_isolated.hpp"
+#include "../third_party/tarsier/source/pipeline.hpp"
+#include "../third_party/tarsier/source/select_rectangle.hpp"
+
+int main(int argc, char* argv[]) {
+    benchmark::output_sink<benchmark::activity> sink;
+    return benchmark::duration(
+        argc,
+        argv,
+        [&](std::size_t count) {
+            sink.reserve(count);
+        },
+        [&](const benchmark::sensor& sensor) {
+            return tarsier::make_pipeline<sepia::dvs_event>(
+                benchmark::increase_stage(),
+                tarsier::make_select_rectangle_stage<sepia::simple_event>(
+                    sensor.region.left,
+                    sensor.region.bottom,
+                    sensor.region.width,
+                    sensor.region.height),
+                tarsier::make_mask_isolated_stage<sepia::simple_event>(sensor.width, sensor.height, 1e3),
+                tarsier::make_compute_flow_fixed_stage<sepia::simple_event, benchmark::flow, 3>(
+                    sensor.width,
+                    sensor.height,
+                    1e4,
+                    8,
+                    [](sepia::simple_event event, float vx, float vy) -> benchmark::flow {
+                        return {event.t, vx, vy, event.x, event.y};
+                    }),
+                tarsier::make_compute_activity_stage<benchmark::flow, benchmark::activity>(
+                    sensor.width,
+                    sensor.height,
+                    1e5,
+                    [](benchmark::flow flow, float potential) -> benchmark::activity {
+                        return {flow.t, potential, flow.x, flow.y};
+                    }),
+                [&](benchmark::activity activity) {
+                    sink(activity);
+                });
+        },
+        [&](uint64_t begin_t, uint64_t end_t, const benchmark::perf_counters& counters) {
+            sink.to_json(std::cout, end_t - begin_t, counters);
+        });
+}
@@ -1,27 +1,61 @@
 #pragma once
 
-#include <cmath>
+#include "decay.hpp"
 #include <cstdint>
 #include <utility>
 #include <vector>
 
 /// tarsier is a collection of event handlers.
 namespace tarsier {
+    /// compute_activity_stage evaluates the activity at each pixel, using an exponential decay.
+    /// The decay policy defaults to exact_decay, which keeps the potentials reproducible.
+    template <typename Event, typename Activity, typename EventToActivity, typename Decay = exact_decay>
+    class compute_activity_stage final {
+        public:
+        compute_activity_stage(uint16_t width, uint16_t height, Decay decay, EventToActivity event_to_activity) :
+            _width(width),
+            _decay(decay),
+            _event_to_activity(std::forward<EventToActivity>(event_to_activity)),
+            _potentials_and_ts(width * height, {0.0f, 0}) {}
+        compute_activity_stage(const compute_activity_stage&) = delete;
+        compute_activity_stage(compute_activity_stage&&) = default;
+        compute_activity_stage& operator=(const compute_activity_stage&) = delete;
+        compute_activity_stage& operator=(compute_activity_stage&&) = default;
+        ~compute_activity_stage() {}
+
+        /// operator() handles an event, and sends the resulting activity to handle_activity.
+        template <typename HandleActivity>
+        void operator()(Event event, HandleActivity& handle_activity) {
+            auto& potential_and_t = _potentials_and_ts[event.x + event.y * _width];
+            potential_and_t.first = potential_and_t.first * _decay(event.t - potential_and_t.second) + 1;
+            potential_and_t.second = event.t;
+            handle_activity(_event_to_activity(event, potential_and_t.first));
+        }
+
+        protected:
+        const uint16_t _width;
+        const Decay _decay;
+        EventToActivity _event_to_activity;
+        std::vector<std::pair<float, uint64_t>> _potentials_and_ts;
+    };
+
     /// compute_activity evaluates the activity at each pixel, using an exponential decay.
-    template <typename Event, typename Activity, typename EventToActivity, typename HandleActivity>
+    template <
+        typename Event,
+        typename Activity,
+        typename EventToActivity,
+        typename HandleActivity,
+        typename Decay = exact_decay>
     class compute_activity {
         public:
         compute_activity(
             uint16_t width,
             uint16_t height,
-            float decay,
+            Decay decay,
             EventToActivity event_to_activity,
             HandleActivity handle_activity) :
-            _width(width),
-            _decay(decay),
-            _event_to_activity(std::forward<EventToActivity>(event_to_activity)),
-            _handle_activity(std::forward<HandleActivity>(handle_activity)),
-            _potentials_and_ts(width * height, {0.0f, 0}) {}
+            _stage(width, height, std::move(decay), std::forward<EventToActivity>(event_to_activity)),
+            _handle_activity(std::forward<HandleActivity>(handle_activity)) {}
         compute_activity(const compute_activity&) = delete;
         compute_activity(compute_activity&&) = default;
         compute_activity& operator=(const compute_activity&) = delete;
@@ -30,34 +64,43 @@ namespace tarsier {
 
         /// operator() handles an event.
         virtual void operator()(Event event) {
-            auto& potential_and_t = _potentials_and_ts[event.x + event.y * _width];
-            potential_and_t.first =
-                potential_and_t.first * std::exp(-static_cast<float>(event.t - potential_and_t.second) / _decay) + 1;
-            potential_and_t.second = event.t;
-            _handle_activity(_event_to_activity(event, potential_and_t.first));
+            _stage(event, _handle_activity);
         }
 
         protected:
-        const uint16_t _width;
-        const float _decay;
-        EventToActivity _event_to_activity;
+        compute_activity_stage<Event, Activity, EventToActivity, Decay> _stage;
         HandleActivity _handle_activity;
-        std::vector<std::pair<float, uint64_t>> _potentials_and_ts;
     };
 
     /// make_compute_activity creates a compute_activity from functors.
-    template <typename Event, typename Activity, typename EventToActivity, typename HandleActivity>
-    inline compute_activity<Event, Activity, EventToActivity, HandleActivity> make_compute_activity(
+    template <
+        typename Event,
+        typename Activity,
+        typename Decay = exact_decay,
+        typename EventToActivity,
+        typename HandleActivity>
+    inline compute_activity<Event, Activity, EventToActivity, HandleActivity, Decay> make_compute_activity(
         uint16_t width,
         uint16_t height,
-        float decay,
+        typename decay_parameter<Decay>::type decay,
         EventToActivity event_to_activity,
         HandleActivity handle_activity) {
-        return compute_activity<Event, Activity, EventToActivity, HandleActivity>(
+        return compute_activity<Event, Activity, EventToActivity, HandleActivity, Decay>(
             width,
             height,
-            decay,
+            std::move(decay),
             std::forward<EventToActivity>(event_to_activity),
             std::forward<HandleActivity>(handle_activity));
     }
+
+    /// make_compute_activity_stage creates a pipeline stage that evaluates the activity from a functor.
+    template <typename Event, typename Activity, typename Decay = exact_decay, typename EventToActivity>
+    inline compute_activity_stage<Event, Activity, EventToActivity, Decay> make_compute_activity_stage(
+        uint16_t width,
+        uint16_t height,
+        typename decay_parameter<Decay>::type decay,
+        EventToActivity event_to_activity) {
+        return compute_activity_stage<Event, Activity, EventToActivity, Decay>(
+            width, height, std::move(decay), std::forward<EventToActivity>(event_to_activity));
+    }
 }
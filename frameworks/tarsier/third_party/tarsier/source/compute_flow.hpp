@@ -1,14 +1,21 @@
 #pragma once
 
+#include "tiled_map.hpp"
+#include <array>
 #include <cmath>
 #include <cstdint>
 #include <utility>
 #include <vector>
 
+#if !defined(TARSIER_SCALAR) && defined(__AVX2__)
+#define TARSIER_AVX2
+#include <immintrin.h>
+#endif
+
 /// tarsier is a collection of event handlers.
 namespace tarsier {
     /// compute_flow evaluates the optical flow.
-    template <typename Event, typename Flow, typename EventToFlow, typename HandleFlow>
+    template <typename Event, typename Flow, typename EventToFlow, typename HandleFlow, typename TsMap = ts_map<>>
     class compute_flow {
         public:
         compute_flow(
@@ -19,14 +26,12 @@ namespace tarsier {
             std::size_t minimum_number_of_events,
             EventToFlow event_to_flow,
             HandleFlow handle_flow) :
-            _width(width),
-            _height(height),
             _spatial_window(spatial_window),
             _temporal_window(temporal_window),
             _minimum_number_of_events(minimum_number_of_events),
             _event_to_flow(std::forward<EventToFlow>(event_to_flow)),
             _handle_flow(std::forward<HandleFlow>(handle_flow)),
-            _ts(width * height, 0) {}
+            _ts(width, height) {}
         compute_flow(const compute_flow&) = delete;
         compute_flow(compute_flow&&) = default;
         compute_flow& operator=(const compute_flow&) = delete;
@@ -35,25 +40,25 @@ namespace tarsier {
 
         /// operator() handles an event.
         virtual void operator()(Event event) {
-            _ts[event.x + event.y * _width] = event.t;
+            _ts.set(_ts.index(event.x, event.y), event.t);
             const auto t_threshold = (event.t <= _temporal_window ? 0 : event.t - _temporal_window);
             std::vector<point> points;
-            for (uint16_t y = (event.y <= _spatial_window ? 0 : event.y - _spatial_window);
-                 y <= (event.y >= _height - 1 - _spatial_window ? _height - 1 : event.y + _spatial_window);
-                 ++y) {
-                for (uint16_t x = (event.x <= _spatial_window ? 0 : event.x - _spatial_window);
-                     x <= (event.x >= _width - 1 - _spatial_window ? _width - 1 : event.x + _spatial_window);
-                     ++x) {
-                    const auto t = _ts[x + y * _width];
-                    if (t > t_threshold) {
-                        points.push_back(point{
-                            static_cast<float>(t),
-                            static_cast<float>(x),
-                            static_cast<float>(y),
-                        });
+            _ts.for_each_segment_around(
+                event.x,
+                event.y,
+                _spatial_window,
+                [&](const typename TsMap::stored_type* values, uint16_t x, uint16_t y, uint16_t length) {
+                    for (uint16_t offset = 0; offset < length; ++offset) {
+                        const auto t = _ts.decode(values[offset]);
+                        if (t > t_threshold) {
+                            points.push_back(point{
+                                static_cast<float>(t),
+                                static_cast<float>(x + offset),
+                                static_cast<float>(y),
+                            });
+                        }
                     }
-                }
-            }
+                });
             if (points.size() >= _minimum_number_of_events) {
                 auto t_mean = 0.0f;
                 auto x_mean = 0.0f;
@@ -84,7 +89,7 @@ namespace tarsier {
                 const auto t_determinant = xx_sum * yy_sum - xy_sum * xy_sum;
                 const auto x_determinant = tx_sum * yy_sum - ty_sum * xy_sum;
                 const auto y_determinant = ty_sum * xx_sum - tx_sum * xy_sum;
-                const auto inverse_squares_sum = 1.0f / (x_determinant * x_determinant + y_determinant * y_determinant);                
+                const auto inverse_squares_sum = 1.0f / (x_determinant * x_determinant + y_determinant * y_determinant);
                 _handle_flow(_event_to_flow(
                     event,
                     t_determinant * x_determinant * inverse_squares_sum,
@@ -100,19 +105,227 @@ namespace tarsier {
             float y;
         };
 
-        const uint16_t _width;
-        const uint16_t _height;
         const uint16_t _spatial_window;
         const uint64_t _temporal_window;
         const std::size_t _minimum_number_of_events;
         EventToFlow _event_to_flow;
         HandleFlow _handle_flow;
-        std::vector<uint64_t> _ts;
+        TsMap _ts;
+    };
+
+    /// compute_flow_fixed_stage evaluates the optical flow with a spatial window known at compile time.
+    /// The neighbourhood is gathered without branches into fixed-size buffers (no heap allocation), using AVX2
+    /// to compare and compact four timestamps at a time when available. The means and covariances are then
+    /// accumulated in the same order and with the same float operations as compute_flow, hence both produce
+    /// identical flows.
+    template <typename Event, typename Flow, uint16_t spatial_window, typename EventToFlow, typename TsMap = ts_map<>>
+    class compute_flow_fixed_stage final {
+        public:
+        compute_flow_fixed_stage(
+            uint16_t width,
+            uint16_t height,
+            uint64_t temporal_window,
+            std::size_t minimum_number_of_events,
+            EventToFlow event_to_flow) :
+            _temporal_window(temporal_window),
+            _minimum_number_of_events(minimum_number_of_events),
+            _event_to_flow(std::forward<EventToFlow>(event_to_flow)),
+            _ts(width, height, padding),
+            _large_timestamps(false) {}
+        compute_flow_fixed_stage(const compute_flow_fixed_stage&) = delete;
+        compute_flow_fixed_stage(compute_flow_fixed_stage&&) = default;
+        compute_flow_fixed_stage& operator=(const compute_flow_fixed_stage&) = delete;
+        compute_flow_fixed_stage& operator=(compute_flow_fixed_stage&&) = default;
+        ~compute_flow_fixed_stage() {}
+
+        /// operator() handles an event, and sends the flow (if any) to handle_flow.
+        template <typename HandleFlow>
+        void operator()(Event event, HandleFlow& handle_flow) {
+            _ts.set(_ts.index(event.x, event.y), event.t);
+            if (event.t >= exact_timestamp_limit) {
+                _large_timestamps = true;
+            }
+            const auto t_threshold = (event.t <= _temporal_window ? 0 : event.t - _temporal_window);
+            std::size_t size = 0;
+#ifdef TARSIER_AVX2
+            if (!_large_timestamps) {
+                size = gather_avx2(event, t_threshold);
+            } else {
+                size = gather(event, t_threshold);
+            }
+#else
+            size = gather(event, t_threshold);
+#endif
+            if (size >= _minimum_number_of_events) {
+                auto t_mean = 0.0f;
+                auto x_mean = 0.0f;
+                auto y_mean = 0.0f;
+                for (std::size_t index = 0; index < size; ++index) {
+                    t_mean += _points_ts[index];
+                    x_mean += _points_xs[index];
+                    y_mean += _points_ys[index];
+                }
+                t_mean /= size;
+                x_mean /= size;
+                y_mean /= size;
+                auto tx_sum = 0.0f;
+                auto ty_sum = 0.0f;
+                auto xx_sum = 0.0f;
+                auto xy_sum = 0.0f;
+                auto yy_sum = 0.0f;
+                for (std::size_t index = 0; index < size; ++index) {
+                    const auto t_delta = _points_ts[index] - t_mean;
+                    const auto x_delta = _points_xs[index] - x_mean;
+                    const auto y_delta = _points_ys[index] - y_mean;
+                    tx_sum += t_delta * x_delta;
+                    ty_sum += t_delta * y_delta;
+                    xx_sum += x_delta * x_delta;
+                    xy_sum += x_delta * y_delta;
+                    yy_sum += y_delta * y_delta;
+                }
+                const auto t_determinant = xx_sum * yy_sum - xy_sum * xy_sum;
+                const auto x_determinant = tx_sum * yy_sum - ty_sum * xy_sum;
+                const auto y_determinant = ty_sum * xx_sum - tx_sum * xy_sum;
+                const auto inverse_squares_sum = 1.0f / (x_determinant * x_determinant + y_determinant * y_determinant);
+                handle_flow(_event_to_flow(
+                    event,
+                    t_determinant * x_determinant * inverse_squares_sum,
+                    t_determinant * y_determinant * inverse_squares_sum));
+            }
+        }
+
+        protected:
+        /// window_size is the maximum number of points in the neighbourhood.
+        static constexpr std::size_t window_size = (2 * spatial_window + 1) * (2 * spatial_window + 1);
+
+        /// padding is the number of extra elements read or written past the end of a segment by vector operations.
+        static constexpr std::size_t padding = 4;
+
+        /// exact_timestamp_limit is the bound under which the vector path converts timestamps exactly.
+        static constexpr uint64_t exact_timestamp_limit = 1ull << 52;
+
+        /// gather copies the recent neighbours to the points buffers, in row-major order, and returns their number.
+        std::size_t gather(Event event, uint64_t t_threshold) {
+            std::size_t size = 0;
+            _ts.for_each_segment_around(
+                event.x,
+                event.y,
+                spatial_window,
+                [&](const typename TsMap::stored_type* values, uint16_t x, uint16_t y, uint16_t length) {
+                    for (uint16_t offset = 0; offset < length; ++offset) {
+                        const auto t = _ts.decode(values[offset]);
+                        _points_ts[size] = static_cast<float>(t);
+                        _points_xs[size] = static_cast<float>(x + offset);
+                        _points_ys[size] = static_cast<float>(y);
+                        size += (t > t_threshold ? 1 : 0);
+                    }
+                });
+            return size;
+        }
+
+#ifdef TARSIER_AVX2
+        /// load reads four 64-bit timestamps.
+        static __m256i load(const uint64_t* values, __m256i) {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values));
+        }
+
+        /// load reads four 32-bit relative timestamps, and adds the epoch.
+        static __m256i load(const uint32_t* values, __m256i epoch) {
+            return _mm256_add_epi64(
+                _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values))), epoch);
+        }
+
+        /// gather_avx2 is equivalent to gather, and processes four timestamps at a time.
+        /// Timestamps are converted to double by injecting them in the mantissa of 2^52, which is exact as long as
+        /// they are smaller than exact_timestamp_limit, and then rounded once to float like static_cast<float>.
+        std::size_t gather_avx2(Event event, uint64_t t_threshold) {
+            static const int32_t permutations[16][4] = {
+                {0, 0, 0, 0}, {0, 0, 0, 0}, {1, 0, 0, 0}, {0, 1, 0, 0}, {2, 0, 0, 0}, {0, 2, 0, 0},
+                {1, 2, 0, 0}, {0, 1, 2, 0}, {3, 0, 0, 0}, {0, 3, 0, 0}, {1, 3, 0, 0}, {0, 1, 3, 0},
+                {2, 3, 0, 0}, {0, 2, 3, 0}, {1, 2, 3, 0}, {0, 1, 2, 3},
+            };
+            static const uint8_t counts[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+            const auto threshold = _mm256_set1_epi64x(static_cast<int64_t>(t_threshold));
+            const auto exponent = _mm256_set1_epi64x(0x4330000000000000ll);
+            const auto offset = _mm256_set1_pd(4503599627370496.0);
+            const auto lanes = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+            const auto epoch = _mm256_set1_epi64x(static_cast<int64_t>(_ts.epoch()));
+            std::size_t size = 0;
+            _ts.for_each_segment_around(
+                event.x,
+                event.y,
+                spatial_window,
+                [&](const typename TsMap::stored_type* values, uint16_t x, uint16_t y, uint16_t length) {
+                    const auto ys = _mm_set1_ps(static_cast<float>(y));
+                    for (uint16_t segment_offset = 0; segment_offset < length; segment_offset += 4) {
+                        const auto ts = load(values + segment_offset, epoch);
+                        auto mask = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(ts, threshold)));
+                        if (length - segment_offset < 4) {
+                            mask &= (1 << (length - segment_offset)) - 1;
+                        }
+                        const auto permutation =
+                            _mm_loadu_si128(reinterpret_cast<const __m128i*>(permutations[mask]));
+                        const auto ts_as_floats = _mm256_cvtpd_ps(
+                            _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(ts, exponent)), offset));
+                        const auto xs = _mm_add_ps(_mm_set1_ps(static_cast<float>(x + segment_offset)), lanes);
+                        _mm_storeu_ps(_points_ts.data() + size, _mm_permutevar_ps(ts_as_floats, permutation));
+                        _mm_storeu_ps(_points_xs.data() + size, _mm_permutevar_ps(xs, permutation));
+                        _mm_storeu_ps(_points_ys.data() + size, ys);
+                        size += counts[mask];
+                    }
+                });
+            return size;
+        }
+#endif
+
+        const uint64_t _temporal_window;
+        const std::size_t _minimum_number_of_events;
+        EventToFlow _event_to_flow;
+        TsMap _ts;
+        bool _large_timestamps;
+        std::array<float, window_size + padding> _points_ts;
+        std::array<float, window_size + padding> _points_xs;
+        std::array<float, window_size + padding> _points_ys;
+    };
+
+    /// compute_flow_fixed evaluates the optical flow with a spatial window known at compile time.
+    template <
+        typename Event,
+        typename Flow,
+        uint16_t spatial_window,
+        typename EventToFlow,
+        typename HandleFlow,
+        typename TsMap = ts_map<>>
+    class compute_flow_fixed {
+        public:
+        compute_flow_fixed(
+            uint16_t width,
+            uint16_t height,
+            uint64_t temporal_window,
+            std::size_t minimum_number_of_events,
+            EventToFlow event_to_flow,
+            HandleFlow handle_flow) :
+            _stage(width, height, temporal_window, minimum_number_of_events, std::forward<EventToFlow>(event_to_flow)),
+            _handle_flow(std::forward<HandleFlow>(handle_flow)) {}
+        compute_flow_fixed(const compute_flow_fixed&) = delete;
+        compute_flow_fixed(compute_flow_fixed&&) = default;
+        compute_flow_fixed& operator=(const compute_flow_fixed&) = delete;
+        compute_flow_fixed& operator=(compute_flow_fixed&&) = default;
+        virtual ~compute_flow_fixed() {}
+
+        /// operator() handles an event.
+        virtual void operator()(Event event) {
+            _stage(event, _handle_flow);
+        }
+
+        protected:
+        compute_flow_fixed_stage<Event, Flow, spatial_window, EventToFlow, TsMap> _stage;
+        HandleFlow _handle_flow;
     };
 
     /// make_compute_flow creates an optical flow estimator from functors.
-    template <typename Event, typename Flow, typename EventToFlow, typename HandleFlow>
-    inline compute_flow<Event, Flow, EventToFlow, HandleFlow> make_compute_flow(
+    template <typename Event, typename Flow, typename TsMap = ts_map<>, typename EventToFlow, typename HandleFlow>
+    inline compute_flow<Event, Flow, EventToFlow, HandleFlow, TsMap> make_compute_flow(
         uint16_t width,
         uint16_t height,
         uint16_t spatial_window,
@@ -120,7 +333,7 @@ namespace tarsier {
         std::size_t minimum_number_of_events,
         EventToFlow EventToflow,
         HandleFlow handle_flow) {
-        return compute_flow<Event, Flow, EventToFlow, HandleFlow>(
+        return compute_flow<Event, Flow, EventToFlow, HandleFlow, TsMap>(
             width,
             height,
             spatial_window,
@@ -129,4 +342,40 @@ namespace tarsier {
             std::forward<EventToFlow>(EventToflow),
             std::forward<HandleFlow>(handle_flow));
     }
+
+    /// make_compute_flow_fixed creates an optical flow estimator with a compile-time spatial window from functors.
+    template <
+        typename Event,
+        typename Flow,
+        uint16_t spatial_window,
+        typename TsMap = ts_map<>,
+        typename EventToFlow,
+        typename HandleFlow>
+    inline compute_flow_fixed<Event, Flow, spatial_window, EventToFlow, HandleFlow, TsMap> make_compute_flow_fixed(
+        uint16_t width,
+        uint16_t height,
+        uint64_t temporal_window,
+        std::size_t minimum_number_of_events,
+        EventToFlow event_to_flow,
+        HandleFlow handle_flow) {
+        return compute_flow_fixed<Event, Flow, spatial_window, EventToFlow, HandleFlow, TsMap>(
+            width,
+            height,
+            temporal_window,
+            minimum_number_of_events,
+            std::forward<EventToFlow>(event_to_flow),
+            std::forward<HandleFlow>(handle_flow));
+    }
+
+    /// make_compute_flow_fixed_stage creates a pipeline stage that evaluates the optical flow from a functor.
+    template <typename Event, typename Flow, uint16_t spatial_window, typename TsMap = ts_map<>, typename EventToFlow>
+    inline compute_flow_fixed_stage<Event, Flow, spatial_window, EventToFlow, TsMap> make_compute_flow_fixed_stage(
+        uint16_t width,
+        uint16_t height,
+        uint64_t temporal_window,
+        std::size_t minimum_number_of_events,
+        EventToFlow event_to_flow) {
+        return compute_flow_fixed_stage<Event, Flow, spatial_window, EventToFlow, TsMap>(
+            width, height, temporal_window, minimum_number_of_events, std::forward<EventToFlow>(event_to_flow));
+    }
 }
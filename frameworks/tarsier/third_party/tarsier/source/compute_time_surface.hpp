@@ -1,37 +1,41 @@
 #pragma once
 
+#include "decay.hpp"
+#include "tiled_map.hpp"
 #include <array>
-#include <cmath>
 #include <cstdint>
+#include <limits>
 #include <utility>
 #include <vector>
 
 /// tarsier is a collection of event handlers.
 namespace tarsier {
     /// compute_time_surface extracts time surfaces from events.
+    /// The time differences in the window are gathered first, and then converted by a single call to the decay
+    /// policy, which lets vectorized policies (for instance polynomial_decay) process the whole window at once.
     template <
         typename Event,
         typename Polarity,
         typename TimeSurface,
         uint16_t spatial_window,
         typename EventToTimeSurface,
-        typename HandleTimeSurface>
+        typename HandleTimeSurface,
+        typename TiledMap = flat_map<std::pair<uint64_t, Polarity>>,
+        typename Decay = exact_decay>
     class compute_time_surface {
         public:
         compute_time_surface(
             uint16_t width,
             uint16_t height,
             uint64_t temporal_window,
-            float decay,
+            Decay decay,
             EventToTimeSurface event_to_time_surface,
             HandleTimeSurface handle_time_surface) :
-            _width(width),
-            _height(height),
             _temporal_window(temporal_window),
-            _decay(decay),
+            _decay(std::move(decay)),
             _event_to_time_surface(std::forward<EventToTimeSurface>(event_to_time_surface)),
             _handle_time_surface(std::forward<HandleTimeSurface>(handle_time_surface)),
-            _ts_and_polarities(width * height, {0, false}) {}
+            _ts_and_polarities(width, height, {0, false}) {}
         compute_time_surface(const compute_time_surface&) = delete;
         compute_time_surface(compute_time_surface&&) = default;
         compute_time_surface& operator=(const compute_time_surface&) = delete;
@@ -41,39 +45,47 @@ namespace tarsier {
         /// operator() handles an event.
         virtual void operator()(Event event) {
             {
-                const auto index = event.x + event.y * _width;
-                _ts_and_polarities[index].first = event.t;
-                _ts_and_polarities[index].second = event.polarity;
+                auto& t_and_polarity = _ts_and_polarities.at(event.x, event.y);
+                t_and_polarity.first = event.t;
+                t_and_polarity.second = event.polarity;
             }
             const auto t_threshold = (event.t <= _temporal_window ? 0 : event.t - _temporal_window);
-            std::array<std::pair<float, Polarity>, (spatial_window * 2 + 1) * (spatial_window * 2 + 1)>
-                projections_and_polarities;
-            for (uint16_t y = (event.y <= spatial_window ? 0 : event.y - spatial_window);
-                 y <= (event.y >= _height - 1 - spatial_window ? _height - 1 : event.y + spatial_window);
-                 ++y) {
-                for (uint16_t x = (event.x <= spatial_window ? 0 : event.x - spatial_window);
-                     x <= (event.x >= _width - 1 - spatial_window ? _width - 1 : event.x + spatial_window);
-                     ++x) {
-                    const auto t_and_polarity = _ts_and_polarities[x + y * _width];
-                    if (t_and_polarity.first > t_threshold) {
-                        projections_and_polarities
-                            [x + spatial_window - event.x + (y + spatial_window - event.y) * (2 * spatial_window + 1)] =
-                                {std::exp(-static_cast<float>(event.t - t_and_polarity.first) / _decay),
-                                 t_and_polarity.second};
+            _deltas.fill(std::numeric_limits<float>::infinity());
+            _polarities.fill(Polarity());
+            _ts_and_polarities.for_each_segment_around(
+                event.x,
+                event.y,
+                spatial_window,
+                [&](const std::pair<uint64_t, Polarity>* ts_and_polarities, uint16_t x, uint16_t y, uint16_t length) {
+                    for (uint16_t offset = 0; offset < length; ++offset) {
+                        const auto t_and_polarity = ts_and_polarities[offset];
+                        if (t_and_polarity.first > t_threshold) {
+                            const auto index = x + offset + spatial_window - event.x
+                                               + (y + spatial_window - event.y) * (2 * spatial_window + 1);
+                            _deltas[index] = static_cast<float>(event.t - t_and_polarity.first);
+                            _polarities[index] = t_and_polarity.second;
+                        }
                     }
-                }
+                });
+            _decay(_deltas.data(), _deltas.size());
+            std::array<std::pair<float, Polarity>, window_size> projections_and_polarities;
+            for (std::size_t index = 0; index < window_size; ++index) {
+                projections_and_polarities[index] = {_deltas[index], _polarities[index]};
             }
             _handle_time_surface(_event_to_time_surface(event, projections_and_polarities));
         }
 
         protected:
-        const uint16_t _width;
-        const uint16_t _height;
+        /// window_size is the number of pixels in a time surface.
+        static constexpr std::size_t window_size = (spatial_window * 2 + 1) * (spatial_window * 2 + 1);
+
         const uint64_t _temporal_window;
-        const float _decay;
+        const Decay _decay;
         EventToTimeSurface _event_to_time_surface;
         HandleTimeSurface _handle_time_surface;
-        std::vector<std::pair<uint64_t, Polarity>> _ts_and_polarities;
+        TiledMap _ts_and_polarities;
+        std::array<float, window_size> _deltas;
+        std::array<Polarity, window_size> _polarities;
     };
 
     /// make_compute_time_surface creates a compute_time_surface from functors.
@@ -82,14 +94,24 @@ namespace tarsier {
         typename Polarity,
         typename TimeSurface,
         uint16_t spatial_window,
+        typename TiledMap = flat_map<std::pair<uint64_t, Polarity>>,
+        typename Decay = exact_decay,
         typename EventToTimeSurface,
         typename HandleTimeSurface>
-    inline compute_time_surface<Event, Polarity, TimeSurface, spatial_window, EventToTimeSurface, HandleTimeSurface>
+    inline compute_time_surface<
+        Event,
+        Polarity,
+        TimeSurface,
+        spatial_window,
+        EventToTimeSurface,
+        HandleTimeSurface,
+        TiledMap,
+        Decay>
     make_compute_time_surface(
         uint16_t width,
         uint16_t height,
         uint64_t temporal_window,
-        float decay,
+        typename decay_parameter<Decay>::type decay,
         EventToTimeSurface event_to_time_surface,
         HandleTimeSurface handle_time_surface) {
         return compute_time_surface<
@@ -98,11 +120,13 @@ namespace tarsier {
             TimeSurface,
             spatial_window,
             EventToTimeSurface,
-            HandleTimeSurface>(
+            HandleTimeSurface,
+            TiledMap,
+            Decay>(
             width,
             height,
             temporal_window,
-            decay,
+            std::move(decay),
             std::forward<EventToTimeSurface>(event_to_time_surface),
             std::forward<HandleTimeSurface>(handle_time_surface));
     }
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#if !defined(TARSIER_SCALAR) && defined(__AVX2__)
+#define TARSIER_AVX2
+#include <immintrin.h>
+#endif
+
+/// tarsier is a collection of event handlers.
+namespace tarsier {
+    /// A decay evaluates exp(-delta_t / decay), and provides:
+    ///     float operator()(uint64_t delta_t) const
+    ///     void operator()(float* values, std::size_t size) const, which replaces each time difference in values
+    ///         (converted to float) with its decay, and maps infinite differences to 0
+    ///     float error_bound() const, the maximum absolute difference with the exact exponential
+
+    /// decay_parameter prevents factories from deducing a decay type from their argument, so that a number is
+    /// converted to the default decay.
+    template <typename Decay>
+    struct decay_parameter {
+        typedef Decay type;
+    };
+
+    /// exact_decay calls std::exp and divides by the decay, as the handlers always did.
+    class exact_decay {
+        public:
+        exact_decay(float decay) : _decay(decay) {}
+        exact_decay(const exact_decay&) = default;
+        exact_decay(exact_decay&&) = default;
+        exact_decay& operator=(const exact_decay&) = default;
+        exact_decay& operator=(exact_decay&&) = default;
+        ~exact_decay() {}
+
+        /// operator() returns the decay after the given time difference.
+        float operator()(uint64_t delta_t) const {
+            return std::exp(-static_cast<float>(delta_t) / _decay);
+        }
+
+        /// operator() replaces time differences with their decays.
+        void operator()(float* values, std::size_t size) const {
+            for (std::size_t index = 0; index < size; ++index) {
+                values[index] = std::exp(-values[index] / _decay);
+            }
+        }
+
+        /// error_bound returns the float rounding error of the division and of std::exp.
+        float error_bound() const {
+            return std::numeric_limits<float>::epsilon();
+        }
+
+        protected:
+        float _decay;
+    };
+
+    /// reciprocal_decay calls std::exp, and multiplies by the precomputed inverse of the decay.
+    class reciprocal_decay {
+        public:
+        reciprocal_decay(float decay) : _inverse_decay(1.0f / decay) {}
+        reciprocal_decay(const reciprocal_decay&) = default;
+        reciprocal_decay(reciprocal_decay&&) = default;
+        reciprocal_decay& operator=(const reciprocal_decay&) = default;
+        reciprocal_decay& operator=(reciprocal_decay&&) = default;
+        ~reciprocal_decay() {}
+
+        /// operator() returns the decay after the given time difference.
+        float operator()(uint64_t delta_t) const {
+            return std::exp(-static_cast<float>(delta_t) * _inverse_decay);
+        }
+
+        /// operator() replaces time differences with their decays.
+        void operator()(float* values, std::size_t size) const {
+            for (std::size_t index = 0; index < size; ++index) {
+                values[index] = std::exp(-values[index] * _inverse_decay);
+            }
+        }
+
+        /// error_bound returns the maximum absolute difference with the exact exponential.
+        /// The inverse and the product each change the exponent x by a relative rounding error, which changes the
+        /// result by at most x * exp(-x) * epsilon / 2 < epsilon / 4, on top of std::exp's rounding.
+        float error_bound() const {
+            return 2 * std::numeric_limits<float>::epsilon();
+        }
+
+        protected:
+        float _inverse_decay;
+    };
+
+    /// table_decay interpolates linearly between precomputed decays, regularly spaced in time.
+    /// The spacing is chosen so that the interpolation error does not exceed the requested bound. Decays smaller
+    /// than the bound are rounded to 0.
+    class table_decay {
+        public:
+        table_decay(float decay, float error_bound) : _error_bound(error_bound) {
+            if (!(error_bound > 0.0f && error_bound < 1.0f)) {
+                throw std::logic_error("error_bound must be in the range ]0, 1[");
+            }
+            // the linear interpolation error is at most step^2 / 8 * max|f''| = step^2 / (8 * decay^2)
+            const auto step = std::sqrt(8.0 * error_bound);
+            const auto size =
+                static_cast<std::size_t>(std::ceil(-std::log(static_cast<double>(error_bound)) / step)) + 2;
+            _inverse_step = static_cast<float>(1.0 / (static_cast<double>(decay) * step));
+            _last = static_cast<float>(size - 1);
+            _decays.resize(size);
+            for (std::size_t index = 0; index < size; ++index) {
+                _decays[index] = static_cast<float>(std::exp(-static_cast<double>(index) * step));
+            }
+        }
+        table_decay(const table_decay&) = default;
+        table_decay(table_decay&&) = default;
+        table_decay& operator=(const table_decay&) = default;
+        table_decay& operator=(table_decay&&) = default;
+        ~table_decay() {}
+
+        /// operator() returns the decay after the given time difference.
+        float operator()(uint64_t delta_t) const {
+            return interpolate(static_cast<float>(delta_t));
+        }
+
+        /// operator() replaces time differences with their decays.
+        void operator()(float* values, std::size_t size) const {
+            for (std::size_t index = 0; index < size; ++index) {
+                values[index] = interpolate(values[index]);
+            }
+        }
+
+        /// error_bound returns the maximum absolute difference with the exact exponential.
+        float error_bound() const {
+            return _error_bound + 4 * std::numeric_limits<float>::epsilon();
+        }
+
+        /// size returns the number of precomputed decays.
+        std::size_t size() const {
+            return _decays.size();
+        }
+
+        protected:
+        /// interpolate evaluates the decay after the given time difference.
+        float interpolate(float delta_t) const {
+            const auto position = delta_t * _inverse_step;
+            if (!(position < _last)) {
+                return 0.0f;
+            }
+            const auto index = static_cast<std::size_t>(position);
+            return _decays[index] + (position - static_cast<float>(index)) * (_decays[index + 1] - _decays[index]);
+        }
+
+        float _error_bound;
+        float _inverse_step;
+        float _last;
+        std::vector<float> _decays;
+    };
+
+    /// polynomial_decay evaluates 2^(-delta_t * log2(e) / decay) with a power of two and a Taylor polynomial of the
+    /// given degree for the fractional part. The batch operator processes eight values at a time when AVX2 is
+    /// available. The degree sets the error bound: about 6e-5 for 4, 4e-6 for 5 and 7e-7 for 6.
+    template <uint8_t degree = 5>
+    class polynomial_decay {
+        public:
+        static_assert(degree >= 1 && degree <= 7, "degree must be in the range [1, 7]");
+
+        polynomial_decay(float decay) : _scale(static_cast<float>(1.4426950408889634 / decay)) {
+            auto coefficient = 1.0;
+            for (uint8_t index = 0; index <= degree; ++index) {
+                if (index > 0) {
+                    coefficient /= index;
+                }
+                _coefficients[index] = static_cast<float>(coefficient);
+            }
+        }
+        polynomial_decay(const polynomial_decay&) = default;
+        polynomial_decay(polynomial_decay&&) = default;
+        polynomial_decay& operator=(const polynomial_decay&) = default;
+        polynomial_decay& operator=(polynomial_decay&&) = default;
+        ~polynomial_decay() {}
+
+        /// operator() returns the decay after the given time difference.
+        float operator()(uint64_t delta_t) const {
+            return evaluate(static_cast<float>(delta_t));
+        }
+
+        /// operator() replaces time differences with their decays.
+        void operator()(float* values, std::size_t size) const {
+            std::size_t index = 0;
+#ifdef TARSIER_AVX2
+            const auto scale = _mm256_set1_ps(_scale);
+            const auto limit = _mm256_set1_ps(exponent_limit);
+            const auto ln2 = _mm256_set1_ps(0.69314718f);
+            const auto bias = _mm256_set1_epi32(127);
+            for (; index + 8 <= size; index += 8) {
+                const auto exponent =
+                    _mm256_min_ps(_mm256_mul_ps(_mm256_loadu_ps(values + index), scale), _mm256_set1_ps(127.0f));
+                const auto rounded = _mm256_round_ps(exponent, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+                const auto remainder = _mm256_mul_ps(_mm256_sub_ps(rounded, exponent), ln2);
+                auto polynomial = _mm256_set1_ps(_coefficients[degree]);
+                for (int8_t power = degree - 1; power >= 0; --power) {
+                    polynomial =
+                        _mm256_add_ps(_mm256_mul_ps(polynomial, remainder), _mm256_set1_ps(_coefficients[power]));
+                }
+                const auto power_of_two = _mm256_castsi256_ps(
+                    _mm256_slli_epi32(_mm256_sub_epi32(bias, _mm256_cvtps_epi32(rounded)), 23));
+                _mm256_storeu_ps(
+                    values + index,
+                    _mm256_andnot_ps(
+                        _mm256_cmp_ps(exponent, limit, _CMP_GT_OQ), _mm256_mul_ps(polynomial, power_of_two)));
+            }
+#endif
+            for (; index < size; ++index) {
+                values[index] = evaluate(values[index]);
+            }
+        }
+
+        /// error_bound returns the maximum absolute difference with the exact exponential.
+        /// The Taylor remainder for |r| <= ln(2) / 2 is bounded by |r|^(degree + 1) / (degree + 1)! * exp(|r|).
+        static float error_bound() {
+            const auto radius = 0.34657359027997264;
+            auto remainder = std::exp(radius);
+            for (uint8_t index = 1; index <= degree + 1; ++index) {
+                remainder *= radius / index;
+            }
+            return static_cast<float>(remainder) + 4 * std::numeric_limits<float>::epsilon();
+        }
+
+        protected:
+        /// exponent_limit is the largest exponent whose power of two is a normal float.
+        static constexpr float exponent_limit = 126.0f;
+
+        /// evaluate computes the decay after the given time difference.
+        float evaluate(float delta_t) const {
+            const auto exponent = std::fmin(delta_t * _scale, 127.0f);
+            if (exponent > exponent_limit) {
+                return 0.0f;
+            }
+            const auto rounded = std::nearbyint(exponent);
+            const auto remainder = (rounded - exponent) * 0.69314718f;
+            auto polynomial = _coefficients[degree];
+            for (int8_t power = degree - 1; power >= 0; --power) {
+                polynomial = polynomial * remainder + _coefficients[power];
+            }
+            const uint32_t bits = static_cast<uint32_t>(127 - static_cast<int32_t>(rounded)) << 23;
+            float power_of_two;
+            std::memcpy(&power_of_two, &bits, sizeof(power_of_two));
+            return polynomial * power_of_two;
+        }
+
+        float _scale;
+        std::array<float, degree + 1> _coefficients;
+    };
+}
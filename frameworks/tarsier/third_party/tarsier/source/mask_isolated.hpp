@@ -1,5 +1,6 @@
 #pragma once
 
+#include "tiled_map.hpp"
 #include <cstdint>
 #include <utility>
 #include <vector>
@@ -7,16 +8,47 @@
 /// tarsier is a collection of event handlers.
 namespace tarsier {
 
-    /// mask_isolated propagates only events that are not isolated spatially or temporally.
-    template <typename Event, typename HandleEvent>
-    class mask_isolated {
+    /// mask_isolated_stage propagates only events that are not isolated spatially or temporally.
+    template <typename Event, typename TsMap = ts_map<>>
+    class mask_isolated_stage final {
         public:
-        mask_isolated(uint16_t width, uint16_t height, uint64_t temporal_window, HandleEvent handle_event) :
+        mask_isolated_stage(uint16_t width, uint16_t height, uint64_t temporal_window) :
             _width(width),
             _height(height),
             _temporal_window(temporal_window),
-            _handle_event(std::forward<HandleEvent>(handle_event)),
-            _ts(width * height, 0) {}
+            _ts(width, height) {}
+        mask_isolated_stage(const mask_isolated_stage&) = delete;
+        mask_isolated_stage(mask_isolated_stage&&) = default;
+        mask_isolated_stage& operator=(const mask_isolated_stage&) = delete;
+        mask_isolated_stage& operator=(mask_isolated_stage&&) = default;
+        ~mask_isolated_stage() {}
+
+        /// operator() handles an event, and sends it to handle_event if it is not isolated.
+        template <typename HandleEvent>
+        void operator()(Event event, HandleEvent& handle_event) {
+            _ts.set(_ts.index(event.x, event.y), event.t + _temporal_window);
+            if ((event.x > 0 && _ts.get(_ts.index(event.x - 1, event.y)) > event.t)
+                || (event.x < _width - 1 && _ts.get(_ts.index(event.x + 1, event.y)) > event.t)
+                || (event.y > 0 && _ts.get(_ts.index(event.x, event.y - 1)) > event.t)
+                || (event.y < _height - 1 && _ts.get(_ts.index(event.x, event.y + 1)) > event.t)) {
+                handle_event(event);
+            }
+        }
+
+        protected:
+        const uint16_t _width;
+        const uint16_t _height;
+        const uint64_t _temporal_window;
+        TsMap _ts;
+    };
+
+    /// mask_isolated propagates only events that are not isolated spatially or temporally.
+    template <typename Event, typename HandleEvent, typename TsMap = ts_map<>>
+    class mask_isolated {
+        public:
+        mask_isolated(uint16_t width, uint16_t height, uint64_t temporal_window, HandleEvent handle_event) :
+            _stage(width, height, temporal_window),
+            _handle_event(std::forward<HandleEvent>(handle_event)) {}
         mask_isolated(const mask_isolated&) = delete;
         mask_isolated(mask_isolated&&) = default;
         mask_isolated& operator=(const mask_isolated&) = delete;
@@ -25,28 +57,26 @@ namespace tarsier {
 
         /// operator() handles an event.
         virtual void operator()(Event event) {
-            const auto index = event.x + event.y * _width;
-            _ts[index] = event.t + _temporal_window;
-            if ((event.x > 0 && _ts[index - 1] > event.t) || (event.x < _width - 1 && _ts[index + 1] > event.t)
-                || (event.y > 0 && _ts[index - _width] > event.t)
-                || (event.y < _height - 1 && _ts[index + _width] > event.t)) {
-                _handle_event(event);
-            }
+            _stage(event, _handle_event);
         }
 
         protected:
-        const uint16_t _width;
-        const uint16_t _height;
-        const uint64_t _temporal_window;
+        mask_isolated_stage<Event, TsMap> _stage;
         HandleEvent _handle_event;
-        std::vector<uint64_t> _ts;
     };
 
     /// make_mask_isolated creates a mask_isolated from a functor.
-    template <typename Event, typename HandleEvent>
-    inline mask_isolated<Event, HandleEvent>
+    template <typename Event, typename TsMap = ts_map<>, typename HandleEvent>
+    inline mask_isolated<Event, HandleEvent, TsMap>
     make_mask_isolated(uint16_t width, uint16_t height, uint64_t temporal_window, HandleEvent handle_event) {
-        return mask_isolated<Event, HandleEvent>(
+        return mask_isolated<Event, HandleEvent, TsMap>(
             width, height, temporal_window, std::forward<HandleEvent>(handle_event));
     }
+
+    /// make_mask_isolated_stage creates a pipeline stage that masks isolated events.
+    template <typename Event, typename TsMap = ts_map<>>
+    inline mask_isolated_stage<Event, TsMap>
+    make_mask_isolated_stage(uint16_t width, uint16_t height, uint64_t temporal_window) {
+        return mask_isolated_stage<Event, TsMap>(width, height, temporal_window);
+    }
 }
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/// tarsier is a collection of event handlers.
+namespace tarsier {
+    /// partition_output collects the outputs of a partition worker's handler.
+    template <typename Output>
+    class partition_output final {
+        public:
+        partition_output(std::vector<std::pair<uint64_t, Output>>& outputs, const uint64_t& sequence, const bool& owned) :
+            _outputs(outputs),
+            _sequence(sequence),
+            _owned(owned) {}
+
+        /// operator() handles an output, which is kept only if the event that triggered it belongs to the worker.
+        void operator()(Output output) {
+            if (_owned) {
+                _outputs.emplace_back(_sequence, output);
+            }
+        }
+
+        protected:
+        std::vector<std::pair<uint64_t, Output>>& _outputs;
+        const uint64_t& _sequence;
+        const bool& _owned;
+    };
+
+    /// partition splits the sensor into horizontal stripes, and runs a replica of a handler per stripe on a worker
+    /// thread. Each event is sent over lock-free single-producer single-consumer rings to the worker that owns its
+    /// row, and to the workers whose stripes are within halo rows, so that every replica sees the neighbourhood of
+    /// the events it owns. halo must be at least the sum of the spatial radii of the chained handlers (for instance
+    /// 1 + 3 for mask_isolated followed by compute_flow with a spatial window of 3), and the handlers must be
+    /// pixel-local: the outputs triggered by an event may depend only on the past events within halo rows.
+    /// A replica keeps only the outputs triggered by the events it owns, and the outputs of a packet are re-ordered
+    /// by input event once every worker has handled it. The outputs are therefore identical to a serial run.
+    /// make_handler is called once per worker with a partition_output<Output>, and must return a new handler (for
+    /// instance a tarsier::pipeline whose last component is the partition_output).
+    template <typename Event, typename Output, typename MakeHandler, typename HandleOutput>
+    class partition {
+        public:
+        /// handler is the type of the replicas.
+        typedef typename std::decay<typename std::result_of<MakeHandler&(partition_output<Output>)>::type>::type
+            handler;
+
+        partition(
+            uint16_t height,
+            uint16_t halo,
+            std::size_t workers,
+            std::size_t ring_size,
+            MakeHandler make_handler,
+            HandleOutput handle_output) :
+            _handle_output(std::forward<HandleOutput>(handle_output)),
+            _sequence(0),
+            _batches(0),
+            _running(true) {
+            if (workers == 0 || workers > height) {
+                throw std::logic_error("workers must be in the range [1, height]");
+            }
+            if (ring_size < 2) {
+                throw std::logic_error("ring_size must be larger than 1");
+            }
+            _rows.resize(height);
+            for (std::size_t index = 0; index < workers; ++index) {
+                const auto begin = static_cast<uint16_t>(index * height / workers);
+                const auto end = static_cast<uint16_t>((index + 1) * height / workers);
+                for (uint16_t y = (begin <= halo ? 0 : begin - halo);
+                     y < (end + halo >= height ? height : end + halo);
+                     ++y) {
+                    if (_rows[y].last < _rows[y].first) {
+                        _rows[y].first = index;
+                    }
+                    _rows[y].last = index;
+                    if (y >= begin && y < end) {
+                        _rows[y].owner = index;
+                    }
+                }
+                _workers.emplace_back(new worker(ring_size, make_handler));
+            }
+            for (auto& worker : _workers) {
+                auto target = worker.get();
+                worker->loop = std::thread([this, target]() {
+                    run(*target);
+                });
+            }
+        }
+        partition(const partition&) = delete;
+        partition(partition&&) = delete;
+        partition& operator=(const partition&) = delete;
+        partition& operator=(partition&&) = delete;
+        virtual ~partition() {
+            _running.store(false, std::memory_order_release);
+            for (auto& worker : _workers) {
+                worker->loop.join();
+            }
+        }
+
+        /// operator() handles an event.
+        virtual void operator()(Event event) {
+            route(event);
+            flush();
+        }
+
+        /// operator() handles a range of events, for instance a packet given as two pointers.
+        /// The outputs are sent to handle_output before the function returns.
+        template <typename Iterator>
+        void operator()(Iterator begin, Iterator end) {
+            for (; begin != end; ++begin) {
+                route(*begin);
+            }
+            flush();
+        }
+
+        protected:
+        /// row lists the workers that receive the events of a row.
+        struct row {
+            std::size_t owner = 0;
+            std::size_t first = 1;
+            std::size_t last = 0;
+        };
+
+        /// entry is an element of a worker's ring.
+        struct entry {
+            Event event;
+            uint64_t sequence;
+            bool owned;
+            bool end_of_batch;
+        };
+
+        /// worker stores the ring, the replica and the outputs of a worker thread.
+        struct worker {
+            worker(std::size_t ring_size, MakeHandler& make_handler) :
+                entries(ring_size),
+                sequence(0),
+                owned(false),
+                replica(make_handler(partition_output<Output>(outputs, sequence, owned))),
+                completed_batches(0) {
+                head.store(0, std::memory_order_release);
+                tail.store(0, std::memory_order_release);
+            }
+
+            std::vector<entry> entries;
+            std::atomic<std::size_t> head;
+            std::atomic<std::size_t> tail;
+            std::vector<std::pair<uint64_t, Output>> outputs;
+            uint64_t sequence;
+            bool owned;
+            handler replica;
+            std::atomic<uint64_t> completed_batches;
+            std::thread loop;
+        };
+
+        /// push adds an entry to a worker's ring, and waits if the ring is full.
+        void push(worker& target, const entry& new_entry) {
+            const auto current_tail = target.tail.load(std::memory_order_relaxed);
+            const auto next_tail = (current_tail + 1) % target.entries.size();
+            while (next_tail == target.head.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            target.entries[current_tail] = new_entry;
+            target.tail.store(next_tail, std::memory_order_release);
+        }
+
+        /// route sends an event to the workers whose stripe (halo included) contains it.
+        void route(Event event) {
+            const auto& event_row = _rows[event.y];
+            for (auto index = event_row.first; index <= event_row.last; ++index) {
+                push(*_workers[index], entry{event, _sequence, index == event_row.owner, false});
+            }
+            ++_sequence;
+        }
+
+        /// flush waits for the workers to handle the routed events, and sends their outputs in input order.
+        void flush() {
+            ++_batches;
+            for (auto& worker : _workers) {
+                push(*worker, entry{Event(), 0, false, true});
+            }
+            for (auto& worker : _workers) {
+                while (worker->completed_batches.load(std::memory_order_acquire) < _batches) {
+                    std::this_thread::yield();
+                }
+            }
+            _positions.assign(_workers.size(), 0);
+            for (;;) {
+                auto minimum_sequence = std::numeric_limits<uint64_t>::max();
+                std::size_t minimum_index = 0;
+                for (std::size_t index = 0; index < _workers.size(); ++index) {
+                    const auto& outputs = _workers[index]->outputs;
+                    if (_positions[index] < outputs.size() && outputs[_positions[index]].first < minimum_sequence) {
+                        minimum_sequence = outputs[_positions[index]].first;
+                        minimum_index = index;
+                    }
+                }
+                if (minimum_sequence == std::numeric_limits<uint64_t>::max()) {
+                    break;
+                }
+                _handle_output(_workers[minimum_index]->outputs[_positions[minimum_index]].second);
+                ++_positions[minimum_index];
+            }
+            for (auto& worker : _workers) {
+                worker->outputs.clear();
+            }
+        }
+
+        /// run handles the entries of a worker's ring until the partition is destroyed.
+        void run(worker& target) {
+            for (;;) {
+                const auto current_head = target.head.load(std::memory_order_relaxed);
+                if (current_head == target.tail.load(std::memory_order_acquire)) {
+                    if (!_running.load(std::memory_order_acquire)) {
+                        break;
+                    }
+                    std::this_thread::yield();
+                    continue;
+                }
+                const auto current_entry = target.entries[current_head];
+                target.head.store((current_head + 1) % target.entries.size(), std::memory_order_release);
+                if (current_entry.end_of_batch) {
+                    target.completed_batches.fetch_add(1, std::memory_order_release);
+                } else {
+                    target.sequence = current_entry.sequence;
+                    target.owned = current_entry.owned;
+                    target.replica(current_entry.event);
+                }
+            }
+        }
+
+        HandleOutput _handle_output;
+        std::vector<row> _rows;
+        std::vector<std::unique_ptr<worker>> _workers;
+        std::vector<std::size_t> _positions;
+        uint64_t _sequence;
+        uint64_t _batches;
+        std::atomic_bool _running;
+    };
+
+    /// make_partition creates a partition from functors.
+    template <typename Event, typename Output, typename MakeHandler, typename HandleOutput>
+    inline std::unique_ptr<partition<Event, Output, MakeHandler, HandleOutput>> make_partition(
+        uint16_t height,
+        uint16_t halo,
+        std::size_t workers,
+        std::size_t ring_size,
+        MakeHandler make_handler,
+        HandleOutput handle_output) {
+        return std::unique_ptr<partition<Event, Output, MakeHandler, HandleOutput>>(
+            new partition<Event, Output, MakeHandler, HandleOutput>(
+                height,
+                halo,
+                workers,
+                ring_size,
+                std::forward<MakeHandler>(make_handler),
+                std::forward<HandleOutput>(handle_output)));
+    }
+}
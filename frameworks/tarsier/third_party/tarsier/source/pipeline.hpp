@@ -0,0 +1,81 @@
+#pragma once
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+/// tarsier is a collection of event handlers.
+namespace tarsier {
+    /// pipeline chains stages known at compile time, and sends the output events to its last component.
+    /// A stage is an object with the method template:
+    ///     template <typename HandleEvent>
+    ///     void operator()(InputEvent event, HandleEvent& handle_event);
+    /// which calls handle_event zero, one or several times. Stages (for instance select_rectangle_stage) are final
+    /// and non-virtual, and the calls between them are resolved at compile time, so that the whole chain can be
+    /// inlined in the loop over a packet.
+    template <typename Event, typename... Components>
+    class pipeline final {
+        public:
+        static_assert(sizeof...(Components) > 0, "a pipeline needs at least one component");
+
+        pipeline(Components... components) : _components(std::forward<Components>(components)...) {}
+        pipeline(const pipeline&) = delete;
+        pipeline(pipeline&&) = default;
+        pipeline& operator=(const pipeline&) = delete;
+        pipeline& operator=(pipeline&&) = default;
+        ~pipeline() {}
+
+        /// operator() handles an event.
+        void operator()(Event event) {
+            handle<0>(event);
+        }
+
+        /// operator() handles a range of events, for instance a packet given as two pointers.
+        template <typename Iterator>
+        void operator()(Iterator begin, Iterator end) {
+            for (; begin != end; ++begin) {
+                const Event event = *begin;
+                handle<0>(event);
+            }
+        }
+
+        protected:
+        /// next sends events to the component with the given index.
+        template <std::size_t index>
+        class next final {
+            public:
+            next(pipeline& parent) : _parent(parent) {}
+
+            /// operator() handles an event.
+            template <typename InputEvent>
+            void operator()(InputEvent event) {
+                _parent.template handle<index>(event);
+            }
+
+            protected:
+            pipeline& _parent;
+        };
+
+        /// handle sends an event to a stage, with the next component as handler.
+        template <std::size_t index, typename InputEvent>
+        typename std::enable_if<(index + 1 < sizeof...(Components))>::type handle(InputEvent event) {
+            next<index + 1> handle_event(*this);
+            std::get<index>(_components)(event, handle_event);
+        }
+
+        /// handle sends an event to the last component.
+        template <std::size_t index, typename InputEvent>
+        typename std::enable_if<(index + 1 == sizeof...(Components))>::type handle(InputEvent event) {
+            std::get<index>(_components)(event);
+        }
+
+        std::tuple<Components...> _components;
+    };
+
+    /// make_pipeline creates a pipeline from stages, followed by a functor.
+    template <typename Event, typename... Components>
+    inline pipeline<Event, Components...> make_pipeline(Components... components) {
+        return pipeline<Event, Components...>(std::forward<Components>(components)...);
+    }
+}
@@ -6,15 +6,42 @@
 /// tarsier is a collection of event handlers.
 namespace tarsier {
 
+    /// select_rectangle_stage propagates only the events within the given rectangular window.
+    template <typename Event>
+    class select_rectangle_stage final {
+        public:
+        select_rectangle_stage(uint16_t left, uint16_t bottom, uint16_t width, uint16_t height) :
+            _left(left),
+            _bottom(bottom),
+            _right(left + width),
+            _top(bottom + height) {}
+        select_rectangle_stage(const select_rectangle_stage&) = delete;
+        select_rectangle_stage(select_rectangle_stage&&) = default;
+        select_rectangle_stage& operator=(const select_rectangle_stage&) = delete;
+        select_rectangle_stage& operator=(select_rectangle_stage&&) = default;
+        ~select_rectangle_stage() {}
+
+        /// operator() handles an event, and sends it to handle_event if it is within the window.
+        template <typename HandleEvent>
+        void operator()(Event event, HandleEvent& handle_event) {
+            if (event.x >= _left && event.x < _right && event.y >= _bottom && event.y < _top) {
+                handle_event(event);
+            }
+        }
+
+        protected:
+        const uint16_t _left;
+        const uint16_t _bottom;
+        const uint16_t _right;
+        const uint16_t _top;
+    };
+
     /// select_rectangle propagates only the events within the given rectangular window.
     template <typename Event, typename HandleEvent>
     class select_rectangle {
         public:
         select_rectangle(uint16_t left, uint16_t bottom, uint16_t width, uint16_t height, HandleEvent handle_event) :
-            _left(left),
-            _bottom(bottom),
-            _right(left + width),
-            _top(bottom + height),
+            _stage(left, bottom, width, height),
             _handle_event(std::forward<HandleEvent>(handle_event)) {}
         select_rectangle(const select_rectangle&) = delete;
         select_rectangle(select_rectangle&&) = default;
@@ -24,16 +51,11 @@ namespace tarsier {
 
         /// operator() handles an event.
         virtual void operator()(Event event) {
-            if (event.x >= _left && event.x < _right && event.y >= _bottom && event.y < _top) {
-                _handle_event(event);
-            }
+            _stage(event, _handle_event);
         }
 
         protected:
-        const uint16_t _left;
-        const uint16_t _bottom;
-        const uint16_t _right;
-        const uint16_t _top;
+        select_rectangle_stage<Event> _stage;
         HandleEvent _handle_event;
     };
 
@@ -48,4 +70,11 @@ namespace tarsier {
         return select_rectangle<Event, HandleEvent>(
             left, bottom, width, height, std::forward<HandleEvent>(handle_event));
     }
+
+    /// make_select_rectangle_stage creates a pipeline stage that selects the events within a rectangular window.
+    template <typename Event>
+    inline select_rectangle_stage<Event>
+    make_select_rectangle_stage(uint16_t left, uint16_t bottom, uint16_t width, uint16_t height) {
+        return select_rectangle_stage<Event>(left, bottom, width, height);
+    }
 }
@@ -34,3 +34,24 @@ TEST_CASE("compute the activity from the given events", "[compute_activity]") {
     compute_activity(event{100003, 101, 100});
     compute_activity(event{200000, 101, 100});
 }
+
+TEST_CASE("compute the activity with an approximate decay", "[compute_activity]") {
+    std::vector<float> expected_potentials{1.0f, 1.9999000049998332f, 1.0f, 1.9999000049998332f, 1.0000908225624412f};
+    std::size_t index = 0;
+    auto compute_activity = tarsier::make_compute_activity<event, activity, tarsier::table_decay>(
+        320,
+        240,
+        tarsier::table_decay(10000, 1e-5f),
+        [](event event, float potential) -> activity {
+            return {event.t, event.x, event.y, potential};
+        },
+        [&](activity activity) -> void {
+            REQUIRE(std::abs(activity.potential - expected_potentials[index]) / expected_potentials[index] < 1e-3);
+            ++index;
+        });
+    compute_activity(event{100000, 100, 100});
+    compute_activity(event{100001, 100, 100});
+    compute_activity(event{100002, 101, 100});
+    compute_activity(event{100003, 101, 100});
+    compute_activity(event{200000, 101, 100});
+}
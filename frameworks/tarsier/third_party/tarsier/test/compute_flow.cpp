@@ -1,5 +1,8 @@
 #include "../source/compute_flow.hpp"
 #include "../third_party/Catch2/single_include/catch.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
 
 struct event {
     uint64_t t;
@@ -53,3 +56,75 @@ TEST_CASE("Compute the optical flow from the given events", "[compute_flow]") {
     compute_flow(event{2010000, 100, 100});
     REQUIRE(flow_generated);
 }
+
+TEST_CASE("Compute the optical flow with a compile-time spatial window and several layouts", "[compute_flow_fixed]") {
+    std::vector<flow> expected_flows;
+    std::vector<flow> flows;
+    auto compute_flow = tarsier::make_compute_flow<event, flow>(
+        32,
+        24,
+        3,
+        10000,
+        8,
+        [](event event, float vx, float vy) -> flow {
+            return {event.t, event.x, event.y, vx, vy};
+        },
+        [&](flow flow) -> void { expected_flows.push_back(flow); });
+    auto compute_flow_fixed = tarsier::make_compute_flow_fixed<event, flow, 3>(
+        32,
+        24,
+        10000,
+        8,
+        [](event event, float vx, float vy) -> flow {
+            return {event.t, event.x, event.y, vx, vy};
+        },
+        [&](flow flow) -> void { flows.push_back(flow); });
+    std::vector<flow> tiled_flows;
+    auto compute_flow_tiled = tarsier::make_compute_flow_fixed<event, flow, 3, tarsier::ts_map<uint64_t, 8, 8>>(
+        32,
+        24,
+        10000,
+        8,
+        [](event event, float vx, float vy) -> flow {
+            return {event.t, event.x, event.y, vx, vy};
+        },
+        [&](flow flow) -> void { tiled_flows.push_back(flow); });
+    std::vector<flow> relative_flows;
+    auto compute_flow_relative = tarsier::make_compute_flow_fixed<event, flow, 3, tarsier::ts_map<uint32_t, 8, 8>>(
+        32,
+        24,
+        10000,
+        8,
+        [](event event, float vx, float vy) -> flow {
+            return {event.t, event.x, event.y, vx, vy};
+        },
+        [&](flow flow) -> void { relative_flows.push_back(flow); });
+    std::mt19937 engine(0);
+    std::uniform_int_distribution<uint16_t> x_distribution(0, 31);
+    std::uniform_int_distribution<uint16_t> y_distribution(0, 23);
+    std::uniform_int_distribution<uint64_t> t_distribution(1, 100);
+    uint64_t t = 4290000000;
+    for (std::size_t index = 0; index < 100000; ++index) {
+        t += t_distribution(engine);
+        const event event{t, x_distribution(engine), y_distribution(engine)};
+        compute_flow(event);
+        compute_flow_fixed(event);
+        compute_flow_tiled(event);
+        compute_flow_relative(event);
+    }
+    REQUIRE(!flows.empty());
+    REQUIRE(flows.size() == expected_flows.size());
+    REQUIRE(tiled_flows.size() == expected_flows.size());
+    REQUIRE(relative_flows.size() == expected_flows.size());
+    for (std::size_t index = 0; index < flows.size(); ++index) {
+        REQUIRE(flows[index].t == expected_flows[index].t);
+        REQUIRE(flows[index].x == expected_flows[index].x);
+        REQUIRE(flows[index].y == expected_flows[index].y);
+        REQUIRE(std::memcmp(&flows[index].vx, &expected_flows[index].vx, sizeof(float)) == 0);
+        REQUIRE(std::memcmp(&flows[index].vy, &expected_flows[index].vy, sizeof(float)) == 0);
+        REQUIRE(std::memcmp(&tiled_flows[index].vx, &expected_flows[index].vx, sizeof(float)) == 0);
+        REQUIRE(std::memcmp(&tiled_flows[index].vy, &expected_flows[index].vy, sizeof(float)) == 0);
+        REQUIRE(std::memcmp(&relative_flows[index].vx, &expected_flows[index].vx, sizeof(float)) == 0);
+        REQUIRE(std::memcmp(&relative_flows[index].vy, &expected_flows[index].vy, sizeof(float)) == 0);
+    }
+}
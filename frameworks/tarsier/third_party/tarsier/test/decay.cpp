@@ -0,0 +1,40 @@
+#include "../source/decay.hpp"
+#include "../third_party/Catch2/single_include/catch.hpp"
+
+template <typename Decay>
+void require_within_error_bound(const Decay& decay, float decay_value) {
+    std::vector<float> values;
+    for (uint64_t delta_t = 0; delta_t < 30 * static_cast<uint64_t>(decay_value); delta_t += 37) {
+        const auto expected = std::exp(-static_cast<double>(delta_t) / decay_value);
+        REQUIRE(std::abs(decay(delta_t) - expected) <= decay.error_bound());
+        values.push_back(static_cast<float>(delta_t));
+    }
+    values.push_back(std::numeric_limits<float>::infinity());
+    auto decays = values;
+    decay(decays.data(), decays.size());
+    for (std::size_t index = 0; index + 1 < values.size(); ++index) {
+        const auto expected = std::exp(-static_cast<double>(values[index]) / decay_value);
+        REQUIRE(std::abs(decays[index] - expected) <= decay.error_bound());
+    }
+    REQUIRE(decays.back() == 0.0f);
+}
+
+TEST_CASE("Keep the exact decay identical to std::exp", "[decay]") {
+    tarsier::exact_decay decay(1e4);
+    for (uint64_t delta_t = 0; delta_t < 100000; delta_t += 13) {
+        REQUIRE(decay(delta_t) == std::exp(-static_cast<float>(delta_t) / 1e4f));
+    }
+    require_within_error_bound(decay, 1e4f);
+}
+
+TEST_CASE("Approximate the decay within the reported error bound", "[decay]") {
+    require_within_error_bound(tarsier::reciprocal_decay(1e4), 1e4f);
+    require_within_error_bound(tarsier::table_decay(1e4, 1e-3f), 1e4f);
+    require_within_error_bound(tarsier::table_decay(1e4, 1e-6f), 1e4f);
+    require_within_error_bound(tarsier::polynomial_decay<3>(1e4), 1e4f);
+    require_within_error_bound(tarsier::polynomial_decay<>(1e4), 1e4f);
+    require_within_error_bound(tarsier::polynomial_decay<6>(1e4), 1e4f);
+    REQUIRE(tarsier::polynomial_decay<6>::error_bound() < tarsier::polynomial_decay<5>::error_bound());
+    REQUIRE(tarsier::polynomial_decay<6>::error_bound() < 1e-6f);
+    REQUIRE_THROWS_AS(tarsier::table_decay(1e4, 0.0f), std::logic_error);
+}
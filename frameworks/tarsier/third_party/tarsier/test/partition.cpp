@@ -0,0 +1,92 @@
+#include "../source/compute_flow.hpp"
+#include "../source/mask_isolated.hpp"
+#include "../source/partition.hpp"
+#include "../source/pipeline.hpp"
+#include "../third_party/Catch2/single_include/catch.hpp"
+#include <cstring>
+#include <random>
+#include <vector>
+
+struct event {
+    uint64_t t;
+    uint16_t x;
+    uint16_t y;
+};
+
+struct flow {
+    uint64_t t;
+    uint16_t x;
+    uint16_t y;
+    float vx;
+    float vy;
+};
+
+TEST_CASE("Partition a pipeline in stripes", "[partition]") {
+    std::vector<event> events;
+    {
+        std::mt19937 engine(0);
+        std::uniform_int_distribution<uint16_t> x_distribution(0, 31);
+        std::uniform_int_distribution<uint16_t> y_distribution(0, 23);
+        std::uniform_int_distribution<uint64_t> t_distribution(0, 20);
+        uint64_t t = 0;
+        for (std::size_t index = 0; index < 100000; ++index) {
+            t += t_distribution(engine);
+            events.push_back({t, x_distribution(engine), y_distribution(engine)});
+        }
+    }
+    std::vector<flow> expected_flows;
+    {
+        auto pipeline = tarsier::make_pipeline<event>(
+            tarsier::make_mask_isolated_stage<event>(32, 24, 1000),
+            tarsier::make_compute_flow_fixed_stage<event, flow, 3>(
+                32,
+                24,
+                10000,
+                8,
+                [](event event, float vx, float vy) -> flow {
+                    return {event.t, event.x, event.y, vx, vy};
+                }),
+            [&](flow flow) {
+                expected_flows.push_back(flow);
+            });
+        pipeline(events.data(), events.data() + events.size());
+    }
+    REQUIRE(!expected_flows.empty());
+    for (std::size_t workers = 1; workers <= 4; ++workers) {
+        std::vector<flow> flows;
+        {
+            auto partition = tarsier::make_partition<event, flow>(
+                24,
+                4,
+                workers,
+                64,
+                [](tarsier::partition_output<flow> output) {
+                    return tarsier::make_pipeline<event>(
+                        tarsier::make_mask_isolated_stage<event>(32, 24, 1000),
+                        tarsier::make_compute_flow_fixed_stage<event, flow, 3>(
+                            32,
+                            24,
+                            10000,
+                            8,
+                            [](event event, float vx, float vy) -> flow {
+                                return {event.t, event.x, event.y, vx, vy};
+                            }),
+                        output);
+                },
+                [&](flow flow) {
+                    flows.push_back(flow);
+                });
+            for (std::size_t index = 0; index < events.size(); index += 1000) {
+                (*partition)(events.data() + index, events.data() + index + 1000);
+            }
+        }
+        REQUIRE(flows.size() == expected_flows.size());
+        for (std::size_t index = 0; index < flows.size(); ++index) {
+            REQUIRE(flows[index].t == expected_flows[index].t);
+            REQUIRE(flows[index].x == expected_flows[index].x);
+            REQUIRE(flows[index].y == expected_flows[index].y);
+            REQUIRE(std::memcmp(&flows[index].vx, &expected_flows[index].vx, sizeof(float)) == 0);
+            REQUIRE(std::memcmp(&flows[index].vy, &expected_flows[index].vy, sizeof(float)) == 0);
+        }
+    }
+}
@@ -0,0 +1,35 @@
+#include "../source/mask_isolated.hpp"
+#include "../source/pipeline.hpp"
+#include "../source/select_rectangle.hpp"
+#include "../third_party/Catch2/single_include/catch.hpp"
+#include <vector>
+
+struct event {
+    uint64_t t;
+    uint16_t x;
+    uint16_t y;
+};
+
+TEST_CASE("Chain stages in a pipeline", "[pipeline]") {
+    std::vector<event> events{
+        {0, 200, 200},
+        {1, 200, 202},
+        {20, 200, 201},
+        {40, 100, 100},
+        {41, 100, 101},
+        {42, 10, 10},
+        {43, 10, 11},
+    };
+    std::size_t count = 0;
+    auto pipeline = tarsier::make_pipeline<event>(
+        tarsier::make_select_rectangle_stage<event>(50, 50, 204, 140),
+        tarsier::make_mask_isolated_stage<event>(320, 240, 10),
+        [&](event event) -> void {
+            ++count;
+            REQUIRE(event.x == 100);
+        });
+    pipeline(events.data(), events.data() + events.size());
+    REQUIRE(count == 1);
+    pipeline(event{44, 100, 102});
+    REQUIRE(count == 2);
+}
@@ -0,0 +1,61 @@
+#include "../source/tiled_map.hpp"
+#include "../third_party/Catch2/single_include/catch.hpp"
+#include <algorithm>
+
+TEST_CASE("Map pixels to distinct tiled indices", "[tiled_map]") {
+    tarsier::tiled_map<uint32_t> map(21, 13);
+    std::vector<std::size_t> indices;
+    for (uint16_t y = 0; y < 13; ++y) {
+        for (uint16_t x = 0; x < 21; ++x) {
+            indices.push_back(map.index(x, y));
+            map.at(x, y) = x + y * 21;
+        }
+    }
+    REQUIRE(map.index(7, 7) == 63);
+    REQUIRE(map.index(8, 0) == 64);
+    REQUIRE(map.index(0, 8) == 192);
+    std::sort(indices.begin(), indices.end());
+    REQUIRE(std::unique(indices.begin(), indices.end()) == indices.end());
+    REQUIRE(indices.back() < map.values().size());
+    std::vector<uint32_t> values;
+    map.for_each_segment_around(6, 7, 3, [&](const uint32_t* begin, uint16_t x, uint16_t y, uint16_t length) {
+        REQUIRE((x + length - 1) / 8 == x / 8);
+        for (uint16_t offset = 0; offset < length; ++offset) {
+            REQUIRE(begin[offset] == static_cast<uint32_t>(x + offset + y * 21));
+            values.push_back(begin[offset]);
+        }
+    });
+    REQUIRE(values.size() == 49);
+    REQUIRE(std::is_sorted(values.begin(), values.end()));
+    values.clear();
+    map.for_each_segment_around(20, 0, 3, [&](const uint32_t* begin, uint16_t, uint16_t, uint16_t length) {
+        values.insert(values.end(), begin, begin + length);
+    });
+    const std::vector<uint32_t> expected_values{17, 18, 19, 20, 38, 39, 40, 41, 59, 60, 61, 62, 80, 81, 82, 83};
+    REQUIRE(values == expected_values);
+}
+
+TEST_CASE("Use the row-major layout with flat maps", "[tiled_map]") {
+    tarsier::flat_map<uint64_t> map(21, 13);
+    REQUIRE(map.index(5, 3) == 5 + 3 * 21);
+    std::size_t segments = 0;
+    map.for_each_segment_around(10, 10, 3, [&](const uint64_t*, uint16_t, uint16_t, uint16_t length) {
+        ++segments;
+        REQUIRE(length == 7);
+    });
+    REQUIRE(segments == 6);
+}
+
+TEST_CASE("Rebase relative timestamps", "[ts_map]") {
+    tarsier::ts_map<uint32_t> map(16, 16);
+    map.set(map.index(0, 0), 1000);
+    map.set(map.index(1, 0), 4000000000ull);
+    REQUIRE(map.epoch() == 0);
+    REQUIRE(map.get(map.index(0, 0)) == 1000);
+    map.set(map.index(2, 0), 5000000000ull);
+    REQUIRE(map.epoch() == 5000000000ull - (1ull << 31));
+    REQUIRE(map.get(map.index(0, 0)) == map.epoch());
+    REQUIRE(map.get(map.index(1, 0)) == 4000000000ull);
+    REQUIRE(map.get(map.index(2, 0)) == 5000000000ull);
+    REQUIRE(map.get(map.index(3, 0)) == map.epoch());
+}
@@ -111,10 +111,17 @@ public:
         uint32_t _coded_data;
         struct {
             unsigned int polarity:1;
+#ifdef CODEC_1280x720_25
+            // x and y span the fill bits of the 24 bits layout, so that 1280 x 720 sensors fit
+            // the layout is unchanged for coordinates smaller than 512 (x) and 256 (y)
+            unsigned int x:11;
+            unsigned int y:10;
+#else
             unsigned int x:9;
             unsigned int _xfill:2;
             unsigned int y:8;
             unsigned int _yfill:2;
+#endif
             unsigned int channel:1;
             unsigned int type:1;
             unsigned int skin:1;
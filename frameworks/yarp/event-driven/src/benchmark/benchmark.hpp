@@ -4,15 +4,48 @@
 #include <yarp/os/all.h>
 #include <yarp/sig/all.h>
 #include <iCub/eventdriven/all.h>
+#include <iostream>
 
 namespace benchmark {
     /// check validates the number of program arguments.
     void check(int argc) {
         if (argc != 3) {
-            throw std::runtime_error("Syntax: ./run_task /path/to/input.es /path/to/output.json");
+            throw std::runtime_error("Syntax: ./run_task [--stream] /path/to/input.es /path/to/output.json");
         }
     }
 
+    /// check_latencies validates the number of latencies program arguments, the speed factor is optional.
+    void check_latencies(int argc) {
+        if (argc != 3 && argc != 4) {
+            throw std::runtime_error(
+                "Syntax: ./run_task [--stream] /path/to/input.es /path/to/output.json [speed factor]");
+        }
+    }
+
+    /// speed returns the speed factor passed as the given argument, or 1 if there is no such argument.
+    double speed(int argc, char* argv[], int index) {
+        return index < argc ? speed_from_string(argv[index]) : 1.0;
+    }
+
+    /// stream removes the --stream flag from the program arguments, and returns whether it was given.
+    /// The readers decode the file on a producer thread (see packet_stream) instead of loading it when the flag is set.
+    bool stream(int& argc, char* argv[]) {
+        for (int index = 1; index < argc; ++index) {
+            if (std::string(argv[index]) == "--stream") {
+                std::copy(argv + index + 1, argv + argc + 1, argv + index);
+                --argc;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// stamp_to_packet returns the index of the packet sent with the given envelope.
+    /// The readers update the envelope, which increments its count, before sending each packet.
+    inline uint64_t stamp_to_packet(const yarp::os::Stamp& stamp) {
+        return static_cast<uint64_t>(stamp.getCount() - 1);
+    }
+
     /// network wraps yarp::os::Network calls in throwing functions.
     class network : public yarp::os::Network {
         public:
@@ -53,12 +86,22 @@ namespace benchmark {
     /// reader wraps file reading in a YARP module.
     class reader : public yarp::os::RFModule {
         public:
-        reader(const std::string& filename) :
+        reader(const std::string& filename, bool stream = false) :
             yarp::os::RFModule(),
-            _event_stream(filename_to_event_stream(filename)),
+            _event_stream(stream ? columnar_event_stream{} : filename_to_columnar_event_stream(filename)),
+            _packet_stream(stream ? new packet_stream(filename) : nullptr),
             _begin_t(0),
-            _ready(false) {
-            _next_packet = _event_stream.packets.begin();
+            _ready(false),
+            _trace_stage(trace_stage("reader")) {
+            if (_packet_stream) {
+                _packet_stream->fill();
+            }
+        }
+        virtual ~reader() {
+            if (_packet_stream) {
+                stalls_to_json(std::cerr, *_packet_stream);
+                std::cerr << std::endl;
+            }
         }
         virtual double getPeriod() {
             return 1e-6;
@@ -72,16 +115,10 @@ namespace benchmark {
             if (_ready.load(std::memory_order_acquire)) {
                 Stamp envelope(0, 0.0);
                 _begin_t = now();
-                for (const auto& packet : _event_stream.packets) {
-                    std::deque<ev::AddressEvent> queue;
-                    for (const auto event : packet) {
-                        ev::AddressEvent address_event;
-                        address_event.stamp = event.t;
-                        address_event.x = event.x;
-                        address_event.y = event.y;
-                        address_event.polarity = event.is_increase;
-                        queue.push_back(address_event);
-                    }
+                for (std::size_t index = 0; index < number_of_packets(); ++index) {
+                    trace_scope scope(_trace_stage, index);
+                    auto queue = _packet_stream ? events_to_queue(*_packet_stream->next()) :
+                                                  events_to_queue(_event_stream.packet(index));
                     envelope.update();
                     _output.write(queue, envelope);
                 }
@@ -102,31 +139,60 @@ namespace benchmark {
 
         /// number_of_packets returns the number of packets loaded.
         std::size_t number_of_packets() const {
-            return _event_stream.packets.size();
+            return _packet_stream ? _packet_stream->number_of_packets() : _event_stream.number_of_packets();
         }
 
         /// number_of_events returns the number of events loaded.
         std::size_t number_of_events() const {
-            return _event_stream.number_of_events;
+            return _packet_stream ? _packet_stream->number_of_events() : _event_stream.number_of_events;
         }
 
         protected:
-        event_stream _event_stream;
+        /// events_to_queue converts a packet to a YARP queue.
+        template <typename Packet>
+        static std::deque<ev::AddressEvent> events_to_queue(const Packet& events) {
+            std::deque<ev::AddressEvent> queue;
+            for (const auto event : events) {
+                ev::AddressEvent address_event;
+                address_event.stamp = event.t;
+                address_event.x = event.x;
+                address_event.y = event.y;
+                address_event.polarity = event.is_increase;
+                queue.push_back(address_event);
+            }
+            return queue;
+        }
+
+        columnar_event_stream _event_stream;
+        std::unique_ptr<packet_stream> _packet_stream;
         uint64_t _begin_t;
-        std::vector<std::vector<sepia::dvs_event>>::iterator _next_packet;
         write_port _output;
         std::atomic_bool _ready;
+        const uint32_t _trace_stage;
     };
 
     /// reader_latencies wraps file reading in a YARP module for the latencies benchmark.
     class reader_latencies : public yarp::os::RFModule {
         public:
-        reader_latencies(const std::string& filename) :
+        reader_latencies(const std::string& filename, double speed = 1.0, bool stream = false) :
             yarp::os::RFModule(),
-            _event_stream(filename_to_event_stream(filename)),
-            _ready(false) {
-            _next_packet = _event_stream.packets.begin();
-            _t_0 = _event_stream.packets_ts.front();
+            _event_stream(stream ? columnar_event_stream{} : filename_to_columnar_event_stream(filename)),
+            _packet_stream(stream ? new packet_stream(filename) : nullptr),
+            _speed(speed),
+            _dispatch_time_0(0),
+            _time_0(0),
+            _ready(false),
+            _trace_stage(trace_stage("reader")) {
+            _t_0 = packets_ts().front();
+            if (_packet_stream) {
+                _packet_stream->fill();
+            }
+        }
+        virtual ~reader_latencies() {
+            if (_packet_stream) {
+                stalls_to_json(std::cerr, *_packet_stream);
+                std::cerr << std::endl;
+            }
         }
         virtual double getPeriod() {
             return 1e-6;
@@ -139,21 +205,19 @@ namespace benchmark {
         virtual bool updateModule() override {
             if (_ready.load(std::memory_order_acquire)) {
                 Stamp envelope(0, 0.0);
-                for (std::size_t index = 0; index < _event_stream.packets.size(); ++index) {
+                for (std::size_t index = 0; index < number_of_packets(); ++index) {
                     if (index == 0) {
-                        _time_point_0 = std::chrono::high_resolution_clock::now();
+                        _dispatch_time_0 = calibrated_clock().now();
+                        _time_0.store(_dispatch_time_0, std::memory_order_release);
                     } else {
-                        busy_sleep_until(_time_point_0 + std::chrono::microseconds(_event_stream.packets_ts[index] - _t_0));
-                    }
-                    std::deque<ev::AddressEvent> queue;
-                    for (const auto event : _event_stream.packets[index]) {
-                        ev::AddressEvent address_event;
-                        address_event.stamp = event.t;
-                        address_event.x = event.x;
-                        address_event.y = event.y;
-                        address_event.polarity = event.is_increase;
-                        queue.push_back(address_event);
+                        calibrated_clock().busy_sleep_until(
+                            _dispatch_time_0
+                            + static_cast<uint64_t>(
+                                dispatch_offset(packets_ts()[index] - _t_0, _speed).count()));
                     }
+                    trace_scope scope(_trace_stage, index);
+                    auto queue = _packet_stream ? events_to_queue(*_packet_stream->next()) :
+                                                  events_to_queue(_event_stream.packet(index));
                     envelope.update();
                     _output.write(queue, envelope);
                 }
@@ -171,26 +235,54 @@ namespace benchmark {
 
         /// number_of_packets returns the number of packets loaded.
         std::size_t number_of_packets() const {
-            return _event_stream.packets.size();
+            return _packet_stream ? _packet_stream->number_of_packets() : _event_stream.number_of_packets();
         }
 
         /// number_of_events returns the number of events loaded.
         std::size_t number_of_events() const {
-            return _event_stream.number_of_events;
+            return _packet_stream ? _packet_stream->number_of_events() : _event_stream.number_of_events;
         }
 
         /// time_0 returns the wall clock time read when the first packet was dispatched.
         uint64_t time_0() const {
-            return time_point_to_uint64(_time_point_0);
+            return _time_0.load(std::memory_order_acquire);
+        }
+
+        /// packets_ts returns each packet's last event timestamp.
+        const std::vector<uint64_t>& packets_ts() const {
+            return _packet_stream ? _packet_stream->packets_ts() : _event_stream.packets_ts;
+        }
+
+        /// speed returns the replay speed factor.
+        double speed() const {
+            return _speed;
         }
 
         protected:
-        event_stream _event_stream;
-        std::vector<std::vector<sepia::dvs_event>>::iterator _next_packet;
+        /// events_to_queue converts a packet to a YARP queue.
+        template <typename Packet>
+        static std::deque<ev::AddressEvent> events_to_queue(const Packet& events) {
+            std::deque<ev::AddressEvent> queue;
+            for (const auto event : events) {
+                ev::AddressEvent address_event;
+                address_event.stamp = event.t;
+                address_event.x = event.x;
+                address_event.y = event.y;
+                address_event.polarity = event.is_increase;
+                queue.push_back(address_event);
+            }
+            return queue;
+        }
+
+        columnar_event_stream _event_stream;
+        std::unique_ptr<packet_stream> _packet_stream;
+        double _speed;
         uint64_t _t_0;
-        std::chrono::high_resolution_clock::time_point _time_point_0;
+        uint64_t _dispatch_time_0;
+        std::atomic<uint64_t> _time_0;
         write_port _output;
         std::atomic_bool _ready;
+        const uint32_t _trace_stage;
     };
 
     /// sink wraps output checks in a YARP module.
@@ -202,8 +294,9 @@ namespace benchmark {
             _number_of_packets(number_of_packets),
             _received_packets(0),
             _end_t(0),
-            _yarp_event_to_event(std::forward<YarpEventToEvent>(yarp_event_to_event)) {
-            _events.reserve(number_of_events);
+            _yarp_event_to_event(std::forward<YarpEventToEvent>(yarp_event_to_event)),
+            _trace_stage(trace_stage("sink")) {
+            _output_sink.reserve(number_of_events);
         }
         virtual double getPeriod() {
             return 1e-6;
@@ -216,8 +309,9 @@ namespace benchmark {
         virtual bool updateModule() override {
             yarp::os::Stamp stamp;
             auto input_queue = _input.read(stamp);
+            trace_scope scope(_trace_stage, stamp_to_packet(stamp));
             for (const auto& event : *input_queue) {
-                _events.push_back(_yarp_event_to_event(event));
+                _output_sink(_yarp_event_to_event(event));
             }
             ++_received_packets;
             if (_received_packets == _number_of_packets) {
@@ -236,19 +330,20 @@ namespace benchmark {
             return _end_t;
         }
 
-        /// events returns the output events.
-        virtual const std::vector<Event>& events() const {
-            return _events;
+        /// to_json writes the duration, the number of output events, their hashes and the performance counters.
+        virtual void to_json(std::ostream& output, uint64_t t, const perf_counters& counters) const {
+            _output_sink.to_json(output, t, counters);
         }
 
         protected:
         std::string _output_filename;
         std::size_t _number_of_packets;
         std::size_t _received_packets;
-        std::vector<Event> _events;
+        output_sink<Event> _output_sink;
         uint64_t _end_t;
         read_port<std::vector<YarpEvent>> _input;
         YarpEventToEvent _yarp_event_to_event;
+        const uint32_t _trace_stage;
     };
     template <typename YarpEvent, typename Event, typename YarpEventToEvent>
     std::unique_ptr<sink<YarpEvent, Event, YarpEventToEvent>> make_sink(
@@ -262,13 +357,14 @@ namespace benchmark {
     template <typename YarpEvent, typename Event, typename YarpEventToEvent>
     class sink_latencies : public yarp::os::RFModule {
         public:
-        sink_latencies(std::size_t number_of_packets, std::size_t number_of_events, YarpEventToEvent yarp_event_to_event) :
+        sink_latencies(const reader_latencies& reader, YarpEventToEvent yarp_event_to_event) :
             yarp::os::RFModule(),
-            _number_of_packets(number_of_packets),
+            _reader(reader),
+            _number_of_packets(reader.number_of_packets()),
             _received_packets(0),
-            _yarp_event_to_event(std::forward<YarpEventToEvent>(yarp_event_to_event)) {
-            _events.reserve(number_of_events);
-            _points.reserve(number_of_events);
+            _yarp_event_to_event(std::forward<YarpEventToEvent>(yarp_event_to_event)),
+            _trace_stage(trace_stage("sink")) {
+            _latency_sink.reserve(reader.number_of_events());
         }
         virtual double getPeriod() {
             return 1e-6;
@@ -281,9 +377,12 @@ namespace benchmark {
         virtual bool updateModule() override {
             yarp::os::Stamp stamp;
             auto input_queue = _input.read(stamp);
+            trace_scope scope(_trace_stage, stamp_to_packet(stamp));
+            if (!_latency_sink.started()) {
+                _latency_sink.start(_reader.packets_ts(), _reader.time_0(), _reader.speed());
+            }
             for (const auto& event : *input_queue) {
-                _events.push_back(_yarp_event_to_event(event));
-                _points.emplace_back(static_cast<uint64_t>(event.stamp), now());
+                _latency_sink(_yarp_event_to_event(event));
             }
             ++_received_packets;
             return _received_packets < _number_of_packets;
@@ -293,36 +392,30 @@ namespace benchmark {
             return true;
         }
 
-        /// events returns the output events.
-        virtual const std::vector<Event>& events() const {
-            return _events;
+        /// to_json writes the number of output events, their hashes, the latencies percentiles and the sampled points.
+        virtual void to_json(std::ostream& output) const {
+            _latency_sink.to_json(output);
         }
 
-        /// points returns the measured wall clock times.
-        /// time_0 (wall clock time in nanoseconds) is used to normalize wall clock times.
-        std::vector<std::pair<uint64_t, uint64_t>> points(uint64_t time_0) const {
-            std::vector<std::pair<uint64_t, uint64_t>> result(_points.size());
-            std::transform(_points.begin(), _points.end(), result.begin(), [&](std::pair<uint64_t, uint64_t> point) {
-                point.second -= time_0;
-                return point;
-            });
-            return result;
+        /// write_points writes the sampled points to the points file, if BENCHMARK_POINTS_FILENAME is set.
+        void write_points() const {
+            _latency_sink.write_points();
         }
 
         protected:
-        std::string _output_filename;
+        const reader_latencies& _reader;
         std::size_t _number_of_packets;
         std::size_t _received_packets;
-        std::vector<Event> _events;
+        latency_sink<Event> _latency_sink;
         read_port<std::vector<YarpEvent>> _input;
         YarpEventToEvent _yarp_event_to_event;
-        std::vector<std::pair<uint64_t, uint64_t>> _points;
+        const uint32_t _trace_stage;
     };
     template <typename YarpEvent, typename Event, typename YarpEventToEvent>
     std::unique_ptr<sink_latencies<YarpEvent, Event, YarpEventToEvent>> make_sink_latencies(
-        std::size_t number_of_packets, std::size_t number_of_events, YarpEventToEvent yarp_event_to_event) {
+        const reader_latencies& reader, YarpEventToEvent yarp_event_to_event) {
         return std::unique_ptr<sink_latencies<YarpEvent, Event, YarpEventToEvent>>(
             new sink_latencies<YarpEvent, Event, YarpEventToEvent>(
-                number_of_packets, number_of_events, std::forward<YarpEventToEvent>(yarp_event_to_event)));
+                reader, std::forward<YarpEventToEvent>(yarp_event_to_event)));
     }
 }
@@ -7,10 +7,12 @@
 
 class compute_activity : public yarp::os::RFModule {
     public:
-    compute_activity(std::size_t number_of_packets) :
+    compute_activity(std::size_t number_of_packets, const benchmark::sensor& sensor) :
         yarp::os::RFModule(),
         _number_of_packets(number_of_packets),
-        _received_packets(0) {}
+        _received_packets(0),
+        _sensor(sensor),
+        _trace_stage(benchmark::trace_stage("compute_activity")) {}
     virtual ~compute_activity() {
         _output.close();
         _input.close();
@@ -21,9 +23,9 @@ class compute_activity : public yarp::os::RFModule {
     virtual bool configure(yarp::os::ResourceFinder& resource_finder) override {
         std::string name = resource_finder.check("name", yarp::os::Value("/compute_activity")).asString();
         yarp::os::RFModule::setName(name.c_str());
-        _width = resource_finder.check("width", yarp::os::Value(304)).asInt();
+        _width = resource_finder.check("width", yarp::os::Value(_sensor.width)).asInt();
         _decay = resource_finder.check("decay", yarp::os::Value(1e5)).asFloat32();
-        _potentials_and_ts.resize(_width * resource_finder.check("height", yarp::os::Value(240)).asInt(), {0.0f, 0});
+        _potentials_and_ts.resize(_width * resource_finder.check("height", yarp::os::Value(_sensor.height)).asInt(), {0.0f, 0});
         return _input.open(yarp::os::Contact("tcp", "localhost", 20010)) && _output.open(yarp::os::Contact("tcp", "localhost", 20011));
     }
     virtual bool updateModule() override {
@@ -32,6 +34,7 @@ class compute_activity : public yarp::os::RFModule {
         if (input_queue == nullptr) {
             return false;
         }
+        benchmark::trace_scope scope(_trace_stage, benchmark::stamp_to_packet(stamp));
         std::deque<ev::FlowEvent> output_queue;
         for (const auto& event : *input_queue) {
             auto& potential_and_t = _potentials_and_ts[event.x + event.y * _width];
@@ -56,9 +59,11 @@ class compute_activity : public yarp::os::RFModule {
     protected:
     std::size_t _number_of_packets;
     std::size_t _received_packets;
+    const benchmark::sensor _sensor;
     uint16_t _width;
     float _decay;
     std::vector<std::pair<float, uint64_t>> _potentials_and_ts;
     benchmark::read_port<std::vector<ev::FlowEvent>> _input;
     benchmark::write_port _output;
+    const uint32_t _trace_stage;
 };
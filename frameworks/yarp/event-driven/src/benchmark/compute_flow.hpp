@@ -7,10 +7,12 @@
 
 class compute_flow : public yarp::os::RFModule {
     public:
-    compute_flow(std::size_t number_of_packets) :
+    compute_flow(std::size_t number_of_packets, const benchmark::sensor& sensor) :
         yarp::os::RFModule(),
         _number_of_packets(number_of_packets),
-        _received_packets(0) {}
+        _received_packets(0),
+        _sensor(sensor),
+        _trace_stage(benchmark::trace_stage("compute_flow")) {}
     virtual ~compute_flow() {
         _output.close();
         _input.close();
@@ -21,8 +23,8 @@ class compute_flow : public yarp::os::RFModule {
     virtual bool configure(yarp::os::ResourceFinder& resource_finder) override {
         std::string name = resource_finder.check("name", yarp::os::Value("/compute_flow")).asString();
         yarp::os::RFModule::setName(name.c_str());
-        _width = resource_finder.check("width", yarp::os::Value(304)).asInt();
-        _height = resource_finder.check("height", yarp::os::Value(240)).asInt(),
+        _width = resource_finder.check("width", yarp::os::Value(_sensor.width)).asInt();
+        _height = resource_finder.check("height", yarp::os::Value(_sensor.height)).asInt(),
         _spatial_window = resource_finder.check("spatial_window", yarp::os::Value(3)).asInt();
         _temporal_window = resource_finder.check("temporal_window", yarp::os::Value(1e4)).asInt();
         _minimum_number_of_events = resource_finder.check("minimum_number_of_events", yarp::os::Value(8)).asInt();
@@ -35,6 +37,7 @@ class compute_flow : public yarp::os::RFModule {
         if (input_queue == nullptr) {
             return false;
         }
+        benchmark::trace_scope scope(_trace_stage, benchmark::stamp_to_packet(stamp));
         std::deque<ev::FlowEvent> output_queue;
         for (const auto& event : *input_queue) {
             _ts[event.x + event.y * _width] = event.stamp;
@@ -114,6 +117,7 @@ class compute_flow : public yarp::os::RFModule {
 
     std::size_t _number_of_packets;
     std::size_t _received_packets;
+    const benchmark::sensor _sensor;
     uint16_t _width;
     uint16_t _height;
     uint16_t _spatial_window;
@@ -122,4 +126,5 @@ class compute_flow : public yarp::os::RFModule {
     std::vector<uint64_t> _ts;
     benchmark::read_port<std::vector<ev::AddressEvent>> _input;
     benchmark::write_port _output;
+    const uint32_t _trace_stage;
 };
@@ -2,11 +2,14 @@
 #include "select_rectangle.hpp"
 
 int main(int argc, char* argv[]) {
+    const auto stream = benchmark::stream(argc, argv);
     benchmark::check(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
+    benchmark::perf_counters counters;
     benchmark::network network;
     yarp::os::ResourceFinder resource_finder;
-    benchmark::reader reader_module(argv[1]);
-    select_rectangle select_rectangle_module(reader_module.number_of_packets());
+    benchmark::reader reader_module(argv[1], stream);
+    select_rectangle select_rectangle_module(reader_module.number_of_packets(), sensor);
     auto sink_module = benchmark::make_sink<ev::AE, sepia::dvs_event>(
         reader_module.number_of_packets(),
         reader_module.number_of_events(),
@@ -21,13 +24,15 @@ int main(int argc, char* argv[]) {
     reader_module.runModuleThreaded();
     select_rectangle_module.runModuleThreaded();
     sink_module->runModuleThreaded();
+    counters.start();
     reader_module.ready();
     try {
         sink_module->joinModule(120);
         select_rectangle_module.joinModule(120);
         reader_module.joinModule(120);
     } catch (...) {}
+    counters.stop();
     std::ofstream output(argv[2]);
-    benchmark::events_to_json(output, sink_module->end_t() - reader_module.begin_t(), sink_module->events());
+    sink_module->to_json(output, sink_module->end_t() - reader_module.begin_t(), counters);
     return 0;
 }
@@ -7,10 +7,12 @@
 
 class mask_isolated : public yarp::os::RFModule {
     public:
-    mask_isolated(std::size_t number_of_packets) :
+    mask_isolated(std::size_t number_of_packets, const benchmark::sensor& sensor) :
         yarp::os::RFModule(),
         _number_of_packets(number_of_packets),
-        _received_packets(0) {}
+        _received_packets(0),
+        _sensor(sensor),
+        _trace_stage(benchmark::trace_stage("mask_isolated")) {}
     virtual ~mask_isolated() {
         _output.close();
         _input.close();
@@ -21,8 +23,8 @@ class mask_isolated : public yarp::os::RFModule {
     virtual bool configure(yarp::os::ResourceFinder& resource_finder) override {
         std::string name = resource_finder.check("name", yarp::os::Value("/mask_isolated")).asString();
         yarp::os::RFModule::setName(name.c_str());
-        _width = resource_finder.check("width", yarp::os::Value(304)).asInt();
-        _height = resource_finder.check("height", yarp::os::Value(240)).asInt(),
+        _width = resource_finder.check("width", yarp::os::Value(_sensor.width)).asInt();
+        _height = resource_finder.check("height", yarp::os::Value(_sensor.height)).asInt(),
         _temporal_window = resource_finder.check("temporal_window", yarp::os::Value(1e3)).asInt();
         _ts.resize(_width * _height, 0);
         return _input.open(yarp::os::Contact("tcp", "localhost", 20006)) && _output.open(yarp::os::Contact("tcp", "localhost", 20007));
@@ -33,6 +35,7 @@ class mask_isolated : public yarp::os::RFModule {
         if (input_queue == nullptr) {
             return false;
         }
+        benchmark::trace_scope scope(_trace_stage, benchmark::stamp_to_packet(stamp));
         std::deque<ev::AddressEvent> output_queue;
         for (const auto& event : *input_queue) {
             const auto index = event.x + event.y * _width;
@@ -56,10 +59,12 @@ class mask_isolated : public yarp::os::RFModule {
     protected:
     std::size_t _number_of_packets;
     std::size_t _received_packets;
+    const benchmark::sensor _sensor;
     uint16_t _width;
     uint16_t _height;
     uint64_t _temporal_window;
     std::vector<uint64_t> _ts;
     benchmark::read_port<std::vector<ev::AddressEvent>> _input;
     benchmark::write_port _output;
+    const uint32_t _trace_stage;
 };
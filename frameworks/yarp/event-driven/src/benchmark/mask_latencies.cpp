@@ -2,14 +2,15 @@
 #include "select_rectangle.hpp"
 
 int main(int argc, char* argv[]) {
-    benchmark::check(argc);
+    const auto stream = benchmark::stream(argc, argv);
+    benchmark::check_latencies(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
     benchmark::network network;
     yarp::os::ResourceFinder resource_finder;
-    benchmark::reader_latencies reader_module(argv[1]);
-    select_rectangle select_rectangle_module(reader_module.number_of_packets());
+    benchmark::reader_latencies reader_module(argv[1], benchmark::speed(argc, argv, 3), stream);
+    select_rectangle select_rectangle_module(reader_module.number_of_packets(), sensor);
     auto sink_module = benchmark::make_sink_latencies<ev::AE, sepia::dvs_event>(
-        reader_module.number_of_packets(),
-        reader_module.number_of_events(),
+        reader_module,
         [](const ev::AE& event) -> sepia::dvs_event {
             return {static_cast<uint64_t>(event.stamp), static_cast<uint16_t>(event.x), static_cast<uint16_t>(event.y), event.polarity};
         });
@@ -28,9 +29,7 @@ int main(int argc, char* argv[]) {
         reader_module.joinModule(120);
     } catch (...) {}
     std::ofstream output(argv[2]);
-    benchmark::events_latencies_to_json(
-        output,
-        sink_module->events(),
-        sink_module->points(reader_module.time_0()));
+    sink_module->to_json(output);
+    sink_module->write_points();
     return 0;
 }
@@ -5,14 +5,17 @@
 #include "split.hpp"
 
 int main(int argc, char* argv[]) {
+    const auto stream = benchmark::stream(argc, argv);
     benchmark::check(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
+    benchmark::perf_counters counters;
     benchmark::network network;
     yarp::os::ResourceFinder resource_finder;
-    benchmark::reader reader_module(argv[1]);
+    benchmark::reader reader_module(argv[1], stream);
     split split_module(reader_module.number_of_packets());
-    select_rectangle select_rectangle_module(reader_module.number_of_packets());
-    mask_isolated mask_isolated_module(reader_module.number_of_packets());
-    compute_flow compute_flow_module(reader_module.number_of_packets());
+    select_rectangle select_rectangle_module(reader_module.number_of_packets(), sensor);
+    mask_isolated mask_isolated_module(reader_module.number_of_packets(), sensor);
+    compute_flow compute_flow_module(reader_module.number_of_packets(), sensor);
     auto sink_module = benchmark::make_sink<ev::FlowEvent, benchmark::flow>(
         reader_module.number_of_packets(),
         reader_module.number_of_events(),
@@ -41,6 +44,7 @@ int main(int argc, char* argv[]) {
     mask_isolated_module.runModuleThreaded();
     compute_flow_module.runModuleThreaded();
     sink_module->runModuleThreaded();
+    counters.start();
     reader_module.ready();
     try {
         sink_module->joinModule(120);
@@ -50,7 +54,8 @@ int main(int argc, char* argv[]) {
         split_module.joinModule(120);
         reader_module.joinModule(120);
     } catch (...) {}
+    counters.stop();
     std::ofstream output(argv[2]);
-    benchmark::flows_to_json(output, sink_module->end_t() - reader_module.begin_t(), sink_module->events());
+    sink_module->to_json(output, sink_module->end_t() - reader_module.begin_t(), counters);
     return 0;
 }
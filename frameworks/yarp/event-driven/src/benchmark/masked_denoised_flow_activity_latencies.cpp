@@ -6,18 +6,19 @@
 #include "split.hpp"
 
 int main(int argc, char* argv[]) {
-    benchmark::check(argc);
+    const auto stream = benchmark::stream(argc, argv);
+    benchmark::check_latencies(argc);
+    const auto sensor = benchmark::filename_to_sensor(argv[1]);
     benchmark::network network;
     yarp::os::ResourceFinder resource_finder;
-    benchmark::reader_latencies reader_module(argv[1]);
+    benchmark::reader_latencies reader_module(argv[1], benchmark::speed(argc, argv, 3), stream);
     split split_module(reader_module.number_of_packets());
-    select_rectangle select_rectangle_module(reader_module.number_of_packets());
-    mask_isolated mask_isolated_module(reader_module.number_of_packets());
-    compute_flow compute_flow_module(reader_module.number_of_packets());
-    compute_activity compute_activity_module(reader_module.number_of_packets());
+    select_rectangle select_rectangle_module(reader_module.number_of_packets(), sensor);
+    mask_isolated mask_isolated_module(reader_module.number_of_packets(), sensor);
+    compute_flow compute_flow_module(reader_module.number_of_packets(), sensor);
+    compute_activity compute_activity_module(reader_module.number_of_packets(), sensor);
     auto sink_module = benchmark::make_sink_latencies<ev::FlowEvent, benchmark::activity>(
-        reader_module.number_of_packets(),
-        reader_module.number_of_events(),
+        reader_module,
         [](const ev::FlowEvent& event) -> benchmark::activity {
             return {
                 static_cast<uint64_t>(event.stamp),
@@ -56,9 +57,7 @@ int main(int argc, char* argv[]) {
         reader_module.joinModule(120);
     } catch (...) {}
     std::ofstream output(argv[2]);
-    benchmark::activities_latencies_to_json(
-        output,
-        sink_module->events(),
-        sink_module->points(reader_module.time_0()));
+    sink_module->to_json(output);
+    sink_module->write_points();
     return 0;
 }
@@ -10,7 +10,8 @@ class split : public yarp::os::RFModule {
     split(std::size_t number_of_packets) :
         yarp::os::RFModule(),
         _number_of_packets(number_of_packets),
-        _received_packets(0) {}
+        _received_packets(0),
+        _trace_stage(benchmark::trace_stage("split")) {}
     virtual ~split() {
         _output.close();
         _input.close();
@@ -29,6 +30,7 @@ class split : public yarp::os::RFModule {
         if (input_queue == nullptr) {
             return false;
         }
+        benchmark::trace_scope scope(_trace_stage, benchmark::stamp_to_packet(stamp));
         std::deque<ev::AddressEvent> output_queue;
         for (const auto& event : *input_queue) {
             if (event.polarity == 1) {
@@ -50,4 +52,5 @@ class split : public yarp::os::RFModule {
     std::size_t _received_packets;
     benchmark::read_port<std::vector<ev::AddressEvent>> _input;
     benchmark::write_port _output;
+    const uint32_t _trace_stage;
 };
@@ -7,10 +7,12 @@
 
 class select_rectangle : public yarp::os::RFModule {
     public:
-    select_rectangle(std::size_t number_of_packets) :
+    select_rectangle(std::size_t number_of_packets, const benchmark::sensor& sensor) :
         yarp::os::RFModule(),
         _number_of_packets(number_of_packets),
-        _received_packets(0) {}
+        _received_packets(0),
+        _sensor(sensor),
+        _trace_stage(benchmark::trace_stage("select_rectangle")) {}
     virtual ~select_rectangle() {
         _output.close();
         _input.close();
@@ -21,10 +23,10 @@ class select_rectangle : public yarp::os::RFModule {
     virtual bool configure(yarp::os::ResourceFinder& resource_finder) override {
         std::string name = resource_finder.check("name", yarp::os::Value("/select_rectangle")).asString();
         yarp::os::RFModule::setName(name.c_str());
-        _left = resource_finder.check("left", yarp::os::Value(102)).asInt();
-        _bottom = resource_finder.check("bottom", yarp::os::Value(70)).asInt(),
-        _right = _left + resource_finder.check("width", yarp::os::Value(100)).asInt();
-        _top = _bottom + resource_finder.check("height", yarp::os::Value(100)).asInt();
+        _left = resource_finder.check("left", yarp::os::Value(_sensor.region.left)).asInt();
+        _bottom = resource_finder.check("bottom", yarp::os::Value(_sensor.region.bottom)).asInt(),
+        _right = _left + resource_finder.check("width", yarp::os::Value(_sensor.region.width)).asInt();
+        _top = _bottom + resource_finder.check("height", yarp::os::Value(_sensor.region.height)).asInt();
         return _input.open(yarp::os::Contact("tcp", "localhost", 20002)) && _output.open(yarp::os::Contact("tcp", "localhost", 20003));
     }
     virtual bool updateModule() override {
@@ -33,6 +35,7 @@ class select_rectangle : public yarp::os::RFModule {
         if (input_queue == nullptr) {
             return false;
         }
+        benchmark::trace_scope scope(_trace_stage, benchmark::stamp_to_packet(stamp));
         ev::vQueue output_queue;
         for (const auto& generic_event : *input_queue) {
             auto event = ev::is_event<ev::AE>(generic_event);
@@ -53,10 +56,12 @@ class select_rectangle : public yarp::os::RFModule {
     protected:
     std::size_t _number_of_packets;
     std::size_t _received_packets;
+    const benchmark::sensor _sensor;
     uint16_t _left;
     uint16_t _bottom;
     uint16_t _right;
     uint16_t _top;
     benchmark::read_port<ev::vQueue> _input;
     benchmark::write_port _output;
+    const uint32_t _trace_stage;
 };
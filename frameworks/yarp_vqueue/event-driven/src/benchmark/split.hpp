@@ -10,7 +10,8 @@ class split : public yarp::os::RFModule {
     split(std::size_t number_of_packets) :
         yarp::os::RFModule(),
         _number_of_packets(number_of_packets),
-        _received_packets(0) {}
+        _received_packets(0),
+        _trace_stage(benchmark::trace_stage("split")) {}
     virtual ~split() {
         _output.close();
         _input.close();
@@ -29,6 +30,7 @@ class split : public yarp::os::RFModule {
         if (input_queue == nullptr) {
             return false;
         }
+        benchmark::trace_scope scope(_trace_stage, benchmark::stamp_to_packet(stamp));
         ev::vQueue output_queue;
         for (const auto& generic_event : *input_queue) {
             auto event = ev::is_event<ev::AE>(generic_event);
@@ -51,4 +53,5 @@ class split : public yarp::os::RFModule {
     std::size_t _received_packets;
     benchmark::read_port<ev::vQueue> _input;
     benchmark::write_port _output;
+    const uint32_t _trace_stage;
 };
@@ -14,6 +14,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
+                counters: result[6],
             }),
         },
         latencies: {
@@ -26,7 +27,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[3],
                     y_hash: result[4],
                 },
-                points: result[5].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[5],
+                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -43,6 +45,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[5],
                     y_hash: result[6],
                 },
+                counters: result[7],
             }),
         },
         latencies: {
@@ -56,7 +59,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
-                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[6],
+                points: result[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -73,6 +77,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[5],
                     y_hash: result[6],
                 },
+                counters: result[7],
             }),
         },
         latencies: {
@@ -86,7 +91,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
-                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[6],
+                points: result[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -103,6 +109,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[5],
                     y_hash: result[6],
                 },
+                counters: result[7],
             }),
         },
         latencies: {
@@ -116,7 +123,8 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
-                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[6],
+                points: result[7].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
@@ -132,6 +140,7 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[4],
                     y_hash: result[5],
                 },
+                counters: result[6],
             }),
         },
         latencies: {
@@ -144,14 +153,15 @@ const pipeline_to_experiment_to_parameters = {
                     x_hash: result[3],
                     y_hash: result[4],
                 },
-                points: result[5].map(([t, time]) => [t, Number(BigInt(time))]),
+                latencies: result[5],
+                points: result[6].map(([t, time]) => [t, Number(BigInt(time))]),
             }),
         },
     },
 };
 
-if (process.argv.length != 5) {
-    console.error('3 arguments are expected (a pipeline name, an experiment name and an Event Stream filename)');
+if (process.argv.length != 5 && process.argv.length != 6) {
+    console.error('3 or 4 arguments are expected (a pipeline name, an experiment name, an Event Stream filename and an optional speed factor)');
     process.exit(1);
 }
 const experiment_to_parameters = pipeline_to_experiment_to_parameters[process.argv[2]];
@@ -164,9 +174,14 @@ if (parameters == null) {
     console.error(`unknown experiment ${process.argv[3]}`);
     process.exit(1);
 }
+const speed = process.argv.length > 5 ? process.argv[5] : null;
+if (speed != null && process.argv[3] !== 'latencies') {
+    console.error('the speed factor is only supported by the latencies experiment');
+    process.exit(1);
+}
 try {
     child_process.execSync(
-        `${__dirname}/usr/bin/${parameters.name} ${process.argv[4]} ${__dirname}/temporary/output.json`,
+        `${__dirname}/usr/bin/${parameters.name} ${process.argv[4]} ${__dirname}/temporary/output.json${speed == null ? '' : ` ${speed}`}`,
         {stdio: 'pipe', maxBuffer: 2 ** 30});
 } catch(error) {}
 try {
@@ -0,0 +1,72 @@
+const frameworks = ['caer', 'kaer', 'tarsier', 'yarp', 'yarp_vqueue'];
+const pipelines = ['mask', 'flow', 'denoised_flow', 'masked_denoised_flow', 'masked_denoised_flow_activity'];
+const streams = ['squares', 'street', 'car'];
+const maximum_speed = 1024; // the sweep doubles the speed factor until saturation, or until it reaches this value
+const bisection_steps = 4; // number of replays between the last sustained and the first saturated speed factors
+const divergence_factor = 10; // a replay is saturated if its latencies exceed this factor times the real-time p99
+const minimum_bound = 1e6; // lower bound of the saturation threshold (in ns)
+
+const child_process = require('child_process');
+const fs = require('fs');
+console.log(new Date());
+
+/// replay runs the latencies experiment at the given speed factor, and returns the latencies percentiles.
+const replay = (framework, pipeline, stream, speed) => JSON.parse(child_process.execSync(
+    `node --max-old-space-size=16384 ${__dirname}/frameworks/${framework}/run_task.js ${pipeline} latencies media/${stream}.es ${speed}`,
+    {maxBuffer: 2 ** 30})).latencies;
+
+/// is_saturated returns true if the tail latency or the backlog left when the input ended exceeds the bound.
+const is_saturated = (latencies, bound) => latencies.p99 > bound || latencies.last > bound;
+
+// sweep the speed factors for each job (pipeline + stream + framework)
+for (const pipeline of pipelines) {
+    for (const stream of streams) {
+        for (const framework of frameworks) {
+            const name = `${pipeline}::saturation::${stream}::${framework}`;
+            console.log(`${name} ${new Date()}`);
+            const runs = [];
+            let bound = Infinity;
+            const run = speed => {
+                const latencies = replay(framework, pipeline, stream, speed);
+                global.gc();
+                const saturated = is_saturated(latencies, bound);
+                runs.push({speed, saturated, latencies});
+                console.log(`    ${speed}x: p99 ${latencies.p99} ns, last ${latencies.last} ns${saturated ? ', saturated' : ''}`);
+                return saturated;
+            };
+            run(1);
+            bound = Math.max(divergence_factor * runs[0].latencies.p99, minimum_bound);
+            let sustained_speed = 1;
+            let saturated_speed = null;
+            for (let speed = 2; speed <= maximum_speed; speed *= 2) {
+                if (run(speed)) {
+                    saturated_speed = speed;
+                    break;
+                }
+                sustained_speed = speed;
+            }
+            if (saturated_speed != null) {
+                for (let index = 0; index < bisection_steps; ++index) {
+                    const speed = Number(Math.sqrt(sustained_speed * saturated_speed).toPrecision(3));
+                    if (speed <= sustained_speed || speed >= saturated_speed) {
+                        break;
+                    }
+                    if (run(speed)) {
+                        saturated_speed = speed;
+                    } else {
+                        sustained_speed = speed;
+                    }
+                }
+            }
+            console.log(`    knee: ${sustained_speed}x`);
+            fs.writeFileSync(`${__dirname}/results/${name}.json`, JSON.stringify({
+                knee: sustained_speed,
+                saturated: saturated_speed != null,
+                bound,
+                runs,
+            }));
+        }
+    }
+}
+
+console.log(new Date());